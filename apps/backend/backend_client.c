@@ -1420,6 +1420,7 @@ from_client_stats(clixon_handle h,
     yang_stmt *ymodext;
     cxobj     *xt = NULL;
     int        ret;
+    int        hits = 0;
 
     if ((str = xml_find_body(xe, "modules")) != NULL)
         modules = strcmp(str, "true") == 0;
@@ -1432,6 +1433,14 @@ from_client_stats(clixon_handle h,
     nr=0;
     yang_stats_global(&nr);
     cprintf(cbret, "<yangnr>%" PRIu64 "</yangnr>", nr);
+    nr=0;
+    xml_yang_validate_unique_stats(&nr, NULL);
+    cprintf(cbret, "<uniquenr>%" PRIu64 "</uniquenr>", nr);
+    nr=0;
+    xml_yang_validate_unique_stats(NULL, &nr);
+    cprintf(cbret, "<uniquecmp>%" PRIu64 "</uniquecmp>", nr);
+    xpath_list_optimize_index_stats(&hits);
+    cprintf(cbret, "<xpath-index-hits>%d</xpath-index-hits>", hits);
     cprintf(cbret, "</global>");
     cprintf(cbret, "<datastores xmlns=\"%s\">", CLIXON_LIB_NS);
     if (clixon_stats_datastore_get(h, "running", cbret) < 0)
@@ -1442,6 +1451,10 @@ from_client_stats(clixon_handle h,
 	if (clixon_stats_datastore_get(h, "startup", cbret) < 0)
 	    goto done;
     cprintf(cbret, "</datastores>");
+    cprintf(cbret, "<state-cache xmlns=\"%s\">", CLIXON_LIB_NS);
+    if (clixon_statedata_cache_stats(h, cbret) < 0)
+        goto done;
+    cprintf(cbret, "</state-cache>");
     /* per module-set, first configuration, then main dbspec, then mountpoints */
     cprintf(cbret, "<module-sets xmlns=\"%s\">", CLIXON_LIB_NS);
     cprintf(cbret, "<module-set><name>clixon-config</name>");
@@ -1622,6 +1635,93 @@ from_client_hello(clixon_handle       h,
     return retval;
 }
 
+/*! Send reply to client
+ *
+ * @param[in]  h      Clixon handle
+ * @param[in]  ce     Client entry
+ * @param[in]  cbret  Reply message, eg <rpc-reply>..., <rpc-error..
+ * @retval     0      OK, or client closed the socket
+ * @retval    -1      Error
+ */
+static int
+backend_client_reply(clixon_handle        h,
+                     struct client_entry *ce,
+                     cbuf                *cbret)
+{
+    int   retval = -1;
+    cbuf *cbce = NULL;
+
+    if (ce_client_descr(ce, &cbce) < 0)
+        goto done;
+    if (send_msg_reply(ce->ce_s, cbuf_get(cbce), cbuf_get(cbret), cbuf_len(cbret)+1) < 0){
+        switch (errno){
+        case EPIPE:
+            /* man (2) write: 
+             * EPIPE  fd is connected to a pipe or socket whose reading end is 
+             * closed.  When this happens the writing process will also receive 
+             * a SIGPIPE signal. 
+             * In Clixon this means a client, eg restconf, netconf or cli closes
+             * the (UNIX domain) socket.
+             */
+        case ECONNRESET:
+            clixon_log(h, LOG_WARNING, "client rpc reset");
+            break;
+        default:
+            goto done;
+        }
+    }
+    retval = 0;
+ done:
+    if (cbce)
+        cbuf_free(cbce);
+    return retval;
+}
+
+/*! Defer reply of the current request of a client
+ *
+ * No more requests are read from the client until the reply is sent, so that replies
+ * are sent in order.
+ * @param[in]  h      Clixon handle
+ * @param[in]  ce     Client entry
+ * @retval     0      OK
+ * @see backend_client_pending_reply
+ */
+int
+backend_client_pending_set(clixon_handle        h,
+                           struct client_entry *ce)
+{
+    clixon_event_unreg_fd(ce->ce_s, from_client);
+    ce->ce_pending = 1;
+    return 0;
+}
+
+/*! Send deferred reply to client and continue reading requests from it
+ *
+ * @param[in]  h      Clixon handle
+ * @param[in]  ce     Client entry
+ * @param[in]  cbret  Reply message, eg <rpc-reply>..., <rpc-error..
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see backend_client_pending_set
+ */
+int
+backend_client_pending_reply(clixon_handle        h,
+                             struct client_entry *ce,
+                             cbuf                *cbret)
+{
+    int retval = -1;
+
+    ce->ce_pending = 0;
+    if (backend_client_reply(h, ce, cbret) < 0)
+        goto done;
+    if (clixon_event_reg_fd_prio(ce->ce_s, from_client, (void*)ce, "local netconf client socket",
+                                 clicon_option_bool(h, "CLICON_SOCK_PRIO")) < 0)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! An internal clixon NETCONF message has arrived from a local client. Receive and dispatch.
  *
  * @param[in]   h    Clixon handle
@@ -1655,7 +1755,6 @@ from_client_msg(clixon_handle        h,
     char                *rpcprefix;
     char                *namespace = NULL;
     int                  nr = 0;
-    cbuf                *cbce = NULL;
 
     clixon_debug(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, "");
     yspec = clicon_dbspec_yang(h);
@@ -1861,6 +1960,8 @@ from_client_msg(clixon_handle        h,
         }
     } /* while */
  reply:
+    if (ce->ce_pending) /* Reply is sent later, see backend_client_pending_reply */
+        goto ok;
     if (cbuf_len(cbret) == 0)
         if (netconf_operation_failed(cbret, "application",
                                      clixon_err_category()?clixon_err_reason():"unknown")< 0)
@@ -1868,26 +1969,9 @@ from_client_msg(clixon_handle        h,
     // XXX    clixon_debug(CLIXON_DBG_MSG, "Reply:%s", cbuf_get(cbret));
     /* XXX problem here is that cbret has not been parsed so may contain 
        parse errors */
-    if (ce_client_descr(ce, &cbce) < 0)
+    if (backend_client_reply(h, ce, cbret) < 0)
         goto done;
-    if (send_msg_reply(ce->ce_s, cbuf_get(cbce), cbuf_get(cbret), cbuf_len(cbret)+1) < 0){
-        switch (errno){
-        case EPIPE:
-            /* man (2) write: 
-             * EPIPE  fd is connected to a pipe or socket whose reading end is 
-             * closed.  When this happens the writing process will also receive 
-             * a SIGPIPE signal. 
-             * In Clixon this means a client, eg restconf, netconf or cli closes
-             * the (UNIX domain) socket.
-             */
-        case ECONNRESET:
-            clixon_log(h, LOG_WARNING, "client rpc reset");
-            break;
-        default:
-            goto done;
-        }
-    }
-    // ok:
+ ok:
     retval = 0;
   done:
     clixon_debug(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, "retval:%d", retval);
@@ -1900,8 +1984,6 @@ from_client_msg(clixon_handle        h,
         xml_free(xret);
     if (xt)
         xml_free(xt);
-    if (cbce)
-        cbuf_free(cbce);
     if (cbret)
         cbuf_free(cbret);
     /* Sanity: log if clixon_err() is not called ! */
@@ -84,6 +84,8 @@
  * @param[in]   h       Clixon handle
  * @param[in]   yspec   Yang spec
  * @param[in]   td      Transaction data
+ * @param[in]   incremental  Validate only constraints affected by the changes in td, see
+ *                           CLICON_VALIDATE_INCREMENTAL. Source of td is assumed to be valid
  * @param[out]  xret    Error XML tree. Free with xml_free after use
  * @retval      1       Validation OK       
  * @retval      0       Validation failed (with cbret set)
@@ -93,6 +95,7 @@ static int
 generic_validate(clixon_handle       h,
                  yang_stmt          *yspec,
                  transaction_data_t *td,
+                 int                 incremental,
                  cxobj             **xret)
 {
     int        retval = -1;
@@ -101,8 +104,15 @@ generic_validate(clixon_handle       h,
     int        ret;
     cbuf      *cb = NULL;
 
-    /* All entries */
-    if ((ret = xml_yang_validate_all_top(h, td->td_target, xret)) < 0)
+    /* All entries, or only those affected by changes */
+    if (incremental)
+        ret = xml_yang_validate_changes(h, td->td_target,
+                                        td->td_dvec, td->td_dlen,
+                                        td->td_avec, td->td_alen,
+                                        td->td_tcvec, td->td_clen, xret);
+    else
+        ret = xml_yang_validate_all_top(h, td->td_target, xret);
+    if (ret < 0)
         goto done;
     if (ret == 0)
         goto fail;
@@ -310,7 +320,7 @@ startup_common(clixon_handle       h,
     /* 5. Make generic validation on all new or changed data.
        Note this is only call that uses 3-values */
     clixon_debug(CLIXON_DBG_BACKEND, "Validating startup %s", db);
-    if ((ret = generic_validate(h, yspec, td, &xret)) < 0)
+    if ((ret = generic_validate(h, yspec, td, 0, &xret)) < 0)
         goto done;
     if (ret == 0){
         if (clixon_xml2cbuf(cbret, xret, 0, 0, NULL, -1, 0) < 0)
@@ -558,7 +568,9 @@ validate_common(clixon_handle       h,
 
     /* 5. Make generic validation on all new or changed data.
        Note this is only call that uses 3-values */
-    if ((ret = generic_validate(h, yspec, td, xret)) < 0)
+    if ((ret = generic_validate(h, yspec, td,
+                                clicon_option_bool(h, "CLICON_VALIDATE_INCREMENTAL"),
+                                xret)) < 0)
         goto done;
     if (ret == 0)
         goto fail;
@@ -1027,7 +1039,7 @@ from_client_restart_one(clixon_handle    h,
         goto fail;
     /* Make generic validation on all new or changed data.
        Note this is only call that uses 3-values */
-    if ((ret = generic_validate(h, yspec, td, &xerr)) < 0)
+    if ((ret = generic_validate(h, yspec, td, 0, &xerr)) < 0)
         goto done;
     if (ret == 0){
         if (clixon_xml2cbuf(cbret, xerr, 0, 0, NULL, -1, 0) < 0)
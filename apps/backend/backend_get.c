@@ -178,6 +178,7 @@ client_get_streams(clixon_handle   h,
  * @param[in]     h       Clixon handle
  * @param[in]     xpath   XPath selection, may be used to filter early
  * @param[in]     nsc     XML Namespace context for xpath
+ * @param[in]     asyncid Asynchronous state data request id, or 0
  * @param[in,out] xret    Existing XML tree, merge x into this, or rpc-error
  * @retval        1       OK
  * @retval        0       Statedata callback failed (error in xret)
@@ -197,6 +198,7 @@ static int
 get_statedata(clixon_handle     h,
               char             *xpath,
               cvec             *nsc,
+              uint32_t          asyncid,
               cxobj           **xret)
 {
     int        retval = -1;
@@ -310,6 +312,13 @@ get_statedata(clixon_handle     h,
         goto done;
     if (ret == 0)
         goto fail;
+    /* State collected by asynchronous providers */
+    if (asyncid){
+        if ((ret = clixon_statedata_async_result(h, asyncid, yspec, nsc, xpath, xret)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+    }
     retval = 1; /* OK */
  done:
     clixon_debug(CLIXON_DBG_BACKEND, "retval:%d", retval);
@@ -771,6 +780,307 @@ get_list_pagination(clixon_handle        h,
     return retval;
 }
 
+/* Get request waiting for asynchronous state data providers, see get_async_start */
+typedef struct {
+    struct client_entry *gp_ce;       /* Client entry */
+    uint32_t             gp_ceid;     /* Session id of client */
+    cxobj               *gp_xrpc;     /* Copy of <rpc> request */
+    cxobj               *gp_xe;       /* Get request in gp_xrpc */
+    netconf_content      gp_content;  /* Get config/state/both */
+    char                *gp_username; /* Username of request */
+    cxobj               *gp_xnacm;    /* Copy of NACM tree, see clicon_nacm_cache */
+} get_pending_t;
+
+static int get_async_resume(clixon_handle h, uint32_t id, void *arg);
+
+static int
+get_pending_free(get_pending_t *gp)
+{
+    if (gp->gp_xrpc)
+        xml_free(gp->gp_xrpc);
+    if (gp->gp_username)
+        free(gp->gp_username);
+    if (gp->gp_xnacm)
+        xml_free(gp->gp_xnacm);
+    free(gp);
+    return 0;
+}
+
+/*! Start asynchronous state data providers and defer reply of get request
+ *
+ * The request is saved and run again by get_async_resume when the providers are done.
+ * @param[in]  h       Clixon handle
+ * @param[in]  ce      Client entry
+ * @param[in]  xe      Request: <rpc><xn></rpc>
+ * @param[in]  content Get state/both
+ * @param[in]  xpath   Canonical xpath of request, or NULL
+ * @param[in]  nsc     Namespace context of xpath
+ * @retval     1       Providers started, reply deferred
+ * @retval     0       No asynchronous providers, reply now
+ * @retval    -1       Error
+ */
+static int
+get_async_start(clixon_handle        h,
+                struct client_entry *ce,
+                cxobj               *xe,
+                netconf_content      content,
+                char                *xpath,
+                cvec                *nsc)
+{
+    int            retval = -1;
+    get_pending_t *gp = NULL;
+    cxobj         *xnacm;
+    char          *username;
+    uint32_t       id = 0;
+    int            ret;
+
+    if ((gp = malloc(sizeof(*gp))) == NULL){
+        clixon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(gp, 0, sizeof(*gp));
+    gp->gp_ce = ce;
+    gp->gp_ceid = ce->ce_id;
+    gp->gp_content = content;
+    /* Copy whole rpc, namespace declarations of filter may be there */
+    if ((gp->gp_xrpc = xml_dup(xml_parent(xe))) == NULL)
+        goto done;
+    if ((gp->gp_xe = xml_find_type(gp->gp_xrpc, NULL, xml_name(xe), CX_ELMNT)) == NULL){
+        clixon_err(OE_XML, EFAULT, "get request not found");
+        goto done;
+    }
+    if ((username = clicon_username_get(h)) != NULL &&
+        (gp->gp_username = strdup(username)) == NULL){
+        clixon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    if ((xnacm = clicon_nacm_cache(h)) != NULL &&
+        (gp->gp_xnacm = xml_dup(xnacm)) == NULL)
+        goto done;
+    if ((ret = clixon_statedata_async_start(h, nsc, xpath?xpath:"/", get_async_resume, gp, &id)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    if (backend_client_pending_set(h, ce) < 0){
+        clixon_statedata_async_cancel(h, id);
+        goto done;
+    }
+    gp = NULL;
+    retval = 1;
+ done:
+    if (gp)
+        get_pending_free(gp);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Return value of a subtree filter content match node, or NULL if not a leaf
+ *
+ * Same definition as the netconf client filter
+ * @param[in]  x   Subtree filter node
+ * @retval     str Leaf value
+ * @retval     NULL Not a content match node
+ */
+static char*
+subtree_leafstring(cxobj *x)
+{
+    cxobj *c;
+
+    if (xml_type(x) != CX_ELMNT)
+        return NULL;
+    if (xml_child_nr(x) != 1)
+        return NULL;
+    c = xml_child_i(x, 0);
+    if (xml_child_nr(c) != 0)
+        return NULL;
+    if (xml_type(c) != CX_BODY)
+        return NULL;
+    return xml_value(c);
+}
+
+/*! Get xpath prefix of a subtree filter node, add a namespace to nsc if not found
+ *
+ * @param[in]  x      Subtree filter node
+ * @param[in]  yspec  Top-level yang spec
+ * @param[in]  nsc    Namespace context of generated xpath
+ * @param[out] prefix Prefix of x in nsc (direct pointer)
+ * @retval     1      OK
+ * @retval     0      No namespace, or namespace not in any yang module
+ * @retval    -1      Error
+ */
+static int
+subtree2xpath_prefix(cxobj     *x,
+                     yang_stmt *yspec,
+                     cvec      *nsc,
+                     char     **prefix)
+{
+    char  *ns = NULL;
+    char   pfx[16];
+
+    if (xml2ns(x, xml_prefix(x), &ns) < 0)
+        return -1;
+    if (ns == NULL ||
+        strcmp(ns, NETCONF_BASE_NAMESPACE) == 0 ||
+        yang_find_module_by_namespace(yspec, ns) == NULL)
+        return 0;
+    if (xml_nsctx_get_prefix(nsc, ns, prefix) == 0){
+        snprintf(pfx, sizeof(pfx), "n%d", cvec_len(nsc));
+        if (xml_nsctx_add(nsc, pfx, ns) < 0)
+            return -1;
+        if (xml_nsctx_get_prefix(nsc, ns, prefix) == 0)
+            return 0;
+    }
+    return 1;
+}
+
+/*! Translate one subtree filter node recursively to xpath expressions
+ *
+ * Content match nodes are translated to predicates. Selection nodes and nodes without
+ * containment children select the node itself.
+ * @param[in]  xf     Subtree filter node
+ * @param[in]  yspec  Top-level yang spec
+ * @param[in]  nsc    Namespace context of generated xpath
+ * @param[in]  cbpath Path to parent of xf, restored on return
+ * @param[out] cb     Union of xpath expressions
+ * @retval     1      OK
+ * @retval     0      Cannot be translated
+ * @retval    -1      Error
+ */
+static int
+subtree2xpath_recurse(cxobj     *xf,
+                      yang_stmt *yspec,
+                      cvec      *nsc,
+                      cbuf      *cbpath,
+                      cbuf      *cb)
+{
+    int    retval = -1;
+    cxobj *xc;
+    char  *prefix;
+    char  *val;
+    char   q;
+    int    containments = 0;
+    size_t len;
+    int    ret;
+
+    if ((ret = subtree2xpath_prefix(xf, yspec, nsc, &prefix)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    cprintf(cbpath, "/%s:%s", prefix, xml_name(xf));
+    xc = NULL;
+    while ((xc = xml_child_each(xf, xc, CX_ELMNT)) != NULL) {
+        if ((val = subtree_leafstring(xc)) == NULL){
+            containments++;
+            continue;
+        }
+        if ((ret = subtree2xpath_prefix(xc, yspec, nsc, &prefix)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+        if (strchr(val, '\'') == NULL)
+            q = '\'';
+        else if (strchr(val, '"') == NULL)
+            q = '"';
+        else
+            goto fail;
+        cprintf(cbpath, "[%s:%s=%c%s%c]", prefix, xml_name(xc), q, val, q);
+    }
+    if (containments == 0){
+        cprintf(cb, "%s%s", cbuf_len(cb)?" | ":"", cbuf_get(cbpath));
+        goto ok;
+    }
+    xc = NULL;
+    while ((xc = xml_child_each(xf, xc, CX_ELMNT)) != NULL) {
+        len = cbuf_len(cbpath);
+        if (subtree_leafstring(xc) != NULL){
+            if ((ret = subtree2xpath_prefix(xc, yspec, nsc, &prefix)) < 0)
+                goto done;
+            if (ret == 0)
+                goto fail;
+            cprintf(cb, "%s%s/%s:%s", cbuf_len(cb)?" | ":"", cbuf_get(cbpath),
+                    prefix, xml_name(xc));
+        }
+        else {
+            if ((ret = subtree2xpath_recurse(xc, yspec, nsc, cbpath, cb)) < 0)
+                goto done;
+            if (ret == 0)
+                goto fail;
+        }
+        cbuf_trunc(cbpath, len);
+    }
+ ok:
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Translate a NETCONF subtree filter to an xpath selecting a superset of the filter
+ *
+ * Used to make the selection in the backend instead of returning the whole datastore.
+ * The exact subtree filtering, eg of attribute matches, is made by the netconf client
+ * on the (smaller) reply.
+ * @param[in]  xfilter Subtree filter, ie <filter>
+ * @param[in]  yspec   Top-level yang spec
+ * @param[out] cbxpath Xpath union
+ * @param[out] nscp    Namespace context of xpath, free with xml_nsctx_free
+ * @retval     1       OK
+ * @retval     0       Cannot be translated, use "/"
+ * @retval    -1       Error
+ * @code
+ *   <filter><x xmlns="urn:example:filter"><y><a>1</a></y></x></filter>
+ *   ->
+ *   /n0:x/n0:y[n0:a='1']
+ * @endcode
+ */
+static int
+subtree2xpath(cxobj     *xfilter,
+              yang_stmt *yspec,
+              cbuf      *cbxpath,
+              cvec     **nscp)
+{
+    int    retval = -1;
+    cvec  *nsc = NULL;
+    cbuf  *cbpath = NULL;
+    cxobj *xf;
+    int    ret;
+
+    if ((nsc = xml_nsctx_init(NULL, NULL)) == NULL)
+        goto done;
+    if ((cbpath = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (xml_child_nr_type(xfilter, CX_ELMNT) == 0)
+        goto fail;
+    xf = NULL;
+    while ((xf = xml_child_each(xfilter, xf, CX_ELMNT)) != NULL) {
+        if (subtree_leafstring(xf) != NULL)
+            goto fail;
+        cbuf_reset(cbpath);
+        if ((ret = subtree2xpath_recurse(xf, yspec, nsc, cbpath, cbxpath)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+    }
+    *nscp = nsc;
+    nsc = NULL;
+    retval = 1;
+ done:
+    if (cbpath)
+        cbuf_free(cbpath);
+    if (nsc)
+        xml_nsctx_free(nsc);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
 /*! Common get/get-config code for retrieving  configuration and state information.
  *
  * @param[in]  h       Clixon handle 
@@ -778,9 +1088,12 @@ get_list_pagination(clixon_handle        h,
  * @param[in]  xe      Request: <rpc><xn></rpc> 
  * @param[in]  content Get config/state/both
  * @param[in]  db      Database name
+ * @param[in]  asyncid Asynchronous state data request id when resumed, 0 on first call
  * @param[out] cbret   Return xml tree, eg <rpc-reply>..., <rpc-error.. 
  * @retval     0       OK
  * @retval    -1       Error
+ * @note If asynchronous state data providers are started, cbret is empty and the reply is
+ *       sent later, see get_async_resume
  * @see from_client_get
  * @see from_client_get_config 
  */
@@ -790,6 +1103,7 @@ get_common(clixon_handle        h,
            cxobj               *xe,
            netconf_content      content,
            char                *db,
+           uint32_t             asyncid,
            cbuf                *cbret
            )
 {
@@ -808,6 +1122,8 @@ get_common(clixon_handle        h,
     char           *reason = NULL;
     cbuf           *cbmsg = NULL; /* For error msg */
     char           *xpath0;
+    char           *ftype;
+    cbuf           *cbsubtree = NULL;
     cbuf           *cbreason = NULL;
     int             list_pagination = 0;
     cxobj         **xvec = NULL;
@@ -826,15 +1142,29 @@ get_common(clixon_handle        h,
         goto done;
     }
     if ((xfilter = xml_find(xe, "filter")) != NULL){
-        if ((xpath0 = xml_find_value(xfilter, "select"))==NULL)
-            xpath0 = "/";
-        /* Create namespace context for xpath from <filter>
-         *  The set of namespace declarations are those in scope on the
-         * <filter> element.
-         */
-        else
+        if ((xpath0 = xml_find_value(xfilter, "select")) != NULL){
+            /* Create namespace context for xpath from <filter>
+             *  The set of namespace declarations are those in scope on the
+             * <filter> element.
+             */
             if (xml_nsctx_node(xfilter, &nsc0) < 0)
                 goto done;
+        }
+        else if ((ftype = xml_find_value(xfilter, "type")) == NULL ||
+                 strcmp(ftype, "subtree") == 0){
+            /* Subtree filter: select a superset in the backend, the client makes the
+             * exact filtering */
+            if ((cbsubtree = cbuf_new()) == NULL){
+                clixon_err(OE_UNIX, errno, "cbuf_new");
+                goto done;
+            }
+            if ((ret = subtree2xpath(xfilter, yspec, cbsubtree, &nsc0)) < 0)
+                goto done;
+            if (ret == 1)
+                xpath0 = cbuf_get(cbsubtree);
+        }
+        if (xpath0 == NULL)
+            xpath0 = "/";
         if ((ret = xpath2canonical(xpath0, nsc0, yspec, &xpath, &nsc, &cbreason)) < 0)
             goto done;
         if (ret == 0){
@@ -887,6 +1217,13 @@ get_common(clixon_handle        h,
             goto done;
         goto ok;
     }
+    /* Start asynchronous state data providers, reply when they are done */
+    if (content != CONTENT_CONFIG && asyncid == 0 && ce != NULL){
+        if ((ret = get_async_start(h, ce, xe, content, xpath, nsc)) < 0)
+            goto done;
+        if (ret == 1)
+            goto ok;
+    }
     /* Read configuration */
     switch (content){
     case CONTENT_CONFIG:    /* config data only */
@@ -959,7 +1296,7 @@ get_common(clixon_handle        h,
         break;
     case CONTENT_ALL:       /* both config and state */
     case CONTENT_NONCONFIG: /* state data only */
-        if ((ret = get_statedata(h, xpath?xpath:"/", nsc, &xret)) < 0)
+        if ((ret = get_statedata(h, xpath?xpath:"/", nsc, asyncid, &xret)) < 0)
             goto done;
         if (ret == 0){ /* Error from callback (error in xret) */
             if (clixon_xml2cbuf(cbret, xret, 0, 0, NULL, -1, 0) < 0)
@@ -1025,6 +1362,8 @@ get_common(clixon_handle        h,
         xml_free(xret);
     if (cbreason)
         cbuf_free(cbreason);
+    if (cbsubtree)
+        cbuf_free(cbsubtree);
     if (nsc0)
         xml_nsctx_free(nsc0);
     if (nsc)
@@ -1040,6 +1379,60 @@ get_common(clixon_handle        h,
     return retval;
 }
 
+/*! Asynchronous state data providers are done, run get request again and send reply
+ *
+ * @param[in]  h       Clixon handle
+ * @param[in]  id      Asynchronous state data request id
+ * @param[in]  arg     Pending get request
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see get_async_start
+ */
+static int
+get_async_resume(clixon_handle h,
+                 uint32_t      id,
+                 void         *arg)
+{
+    int                  retval = -1;
+    get_pending_t       *gp = (get_pending_t *)arg;
+    struct client_entry *ce;
+    cbuf                *cbret = NULL;
+
+    clixon_debug(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, "");
+    for (ce = backend_client_list(h); ce; ce = ce->ce_next)
+        if (ce == gp->gp_ce && ce->ce_id == gp->gp_ceid)
+            break;
+    if (ce == NULL || ce->ce_s == 0){ /* Session closed */
+        clixon_statedata_async_cancel(h, id);
+        goto ok;
+    }
+    if ((cbret = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    clicon_username_set(h, gp->gp_username);
+    if (clicon_nacm_cache_set(h, gp->gp_xnacm) < 0)
+        goto done;
+    clixon_err_reset();
+    if (get_common(h, ce, gp->gp_xe, gp->gp_content, "running", id, cbret) < 0){
+        cbuf_reset(cbret);
+        if (netconf_operation_failed(cbret, "application", clixon_err_reason()) < 0)
+            goto done;
+    }
+    if (clicon_nacm_cache_set(h, NULL) < 0)
+        goto done;
+    clixon_statedata_async_cancel(h, id); /* If not already ended by get_common */
+    if (backend_client_pending_reply(h, ce, cbret) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    get_pending_free(gp);
+    if (cbret)
+        cbuf_free(cbret);
+    return retval;
+}
+
 /*! Retrieve all or part of a specified configuration.
  *
  * @param[in]  h       Clixon handle
@@ -1066,7 +1459,7 @@ from_client_get_config(clixon_handle h,
         clixon_err(OE_XML, 0, "db not found");
         goto done;
     }
-    retval = get_common(h, ce, xe, CONTENT_CONFIG, db, cbret);
+    retval = get_common(h, ce, xe, CONTENT_CONFIG, db, 0, cbret);
  done:
     return retval;
 }
@@ -1097,5 +1490,5 @@ from_client_get(clixon_handle h,
     /* Clixon extensions: content */
     if ((attr = xml_find_value(xe, "content")) != NULL)
         content = netconf_content_str2int(attr);
-    return get_common(h, ce, xe, content, "running", cbret);
+    return get_common(h, ce, xe, content, "running", 0, cbret);
 }
@@ -136,6 +136,7 @@ backend_terminate(clixon_handle h)
 
     xpath_optimize_exit();
     clixon_pagination_free(h);
+    clixon_statedata_free(h);
     
     if (pidfile)
         unlink(pidfile);   
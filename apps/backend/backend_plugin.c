@@ -44,6 +44,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <inttypes.h>
 #include <dlfcn.h>
 #include <unistd.h>
 #include <errno.h>
@@ -52,6 +53,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/param.h>
+#include <sys/time.h>
 #include <netinet/in.h>
 
 /* cligen */
@@ -253,6 +255,209 @@ clixon_plugin_daemon_all(clixon_handle h)
     return retval;
 }
 
+/* State data provider registered on a schema path, see clixon_statedata_cb_register */
+typedef struct {
+    qelem_t         sp_qelem;   /* List header */
+    char           *sp_xpath;   /* Registered path using canonical prefixes, eg /if:interfaces-state */
+    char          **sp_steps;   /* Location steps of sp_xpath, eg "if:interfaces-state" */
+    int             sp_nsteps;  /* Number of steps */
+    plgstatedata_t *sp_fn;      /* State data callback */
+    uint32_t        sp_maxage;  /* Max age of cached state in ms, 0 means no caching */
+    cxobj          *sp_cache;   /* Cached bound and sorted state tree, or NULL */
+    struct timeval  sp_cachetime; /* When sp_cache was filled */
+    uint64_t        sp_hits;    /* Requests served from cache */
+    uint64_t        sp_misses;  /* Requests that called the provider */
+    plgstatedata_async_t *sp_afn; /* Asynchronous state data callback, instead of sp_fn */
+    void           *sp_arg;     /* Argument of sp_afn */
+} statedata_provider_t;
+
+/* Call of an asynchronous state data provider */
+typedef struct {
+    uint32_t              sc_id;  /* Call id, 0 when done */
+    statedata_provider_t *sc_sp;  /* Provider */
+} statedata_call_t;
+
+/* Ongoing get request waiting for asynchronous state data providers */
+typedef struct {
+    qelem_t           sa_qelem;     /* List header */
+    clixon_handle     sa_h;         /* Clixon handle */
+    uint32_t          sa_id;        /* Request id */
+    statedata_call_t *sa_calls;     /* Vector of provider calls */
+    int               sa_ncalls;    /* Length of sa_calls */
+    int               sa_outstanding; /* Number of calls not done */
+    int               sa_starting;  /* Providers are being started */
+    int               sa_failed;    /* A provider failed, sa_xstate is netconf error */
+    cxobj            *sa_xstate;    /* Collected state */
+    statedata_async_resume_t *sa_fn; /* Called when done or on timeout */
+    void             *sa_fnarg;     /* Argument of sa_fn */
+} statedata_async_t;
+
+/* Request and call id of asynchronous state data providers */
+static uint32_t _statedata_async_id = 0;
+
+static int statedata_async_free(clixon_handle h, statedata_async_t *sa);
+
+/*! Free a state data provider
+ */
+static int
+statedata_provider_free(statedata_provider_t *sp)
+{
+    int i;
+
+    if (sp->sp_xpath)
+        free(sp->sp_xpath);
+    if (sp->sp_steps){
+        for (i=0; i<sp->sp_nsteps; i++)
+            free(sp->sp_steps[i]);
+        free(sp->sp_steps);
+    }
+    if (sp->sp_cache)
+        xml_free(sp->sp_cache);
+    free(sp);
+    return 0;
+}
+
+/*! Split a plain absolute xpath into location steps, without predicates
+ *
+ * @param[in]  xpath   XPath, eg /a:b/a:c[a:k='x']/a:d
+ * @param[out] stepsp  Vector of steps, eg "a:b","a:c","a:d". Free with free() after use
+ * @param[out] nstepsp Number of steps
+ * @retval     1       OK, plain absolute path
+ * @retval     0       Not a plain absolute path, eg union, descendant axis, wildcard or function
+ * @retval    -1       Error
+ */
+static int
+statedata_xpath_steps(char   *xpath,
+                      char ***stepsp,
+                      int    *nstepsp)
+{
+    int    retval = -1;
+    cbuf  *cb = NULL;
+    char **vec = NULL;
+    int    nvec = 0;
+    int    i;
+    char   c;
+    char   q = 0;
+    int    pred = 0;
+
+    *stepsp = NULL;
+    *nstepsp = 0;
+    if (xpath == NULL || xpath[0] != '/')
+        goto fail;
+    if ((cb = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    /* Remove predicates */
+    for (i=1; (c = xpath[i]) != '\0'; i++){
+        if (q){
+            if (c == q)
+                q = 0;
+        }
+        else if (pred){
+            if (c == '\'' || c == '"')
+                q = c;
+            else if (c == '[')
+                pred++;
+            else if (c == ']')
+                pred--;
+        }
+        else if (c == '[')
+            pred++;
+        else if (strchr("|*()@ ", c) != NULL ||
+                 (c == '/' && xpath[i-1] == '/') ||
+                 (c == '.' && (xpath[i-1] == '/' || xpath[i-1] == '.')))
+            goto fail;
+        else
+            cprintf(cb, "%c", c);
+    }
+    if (q || pred || cbuf_len(cb) == 0)
+        goto fail;
+    if ((vec = clicon_strsep(cbuf_get(cb), "/", &nvec)) == NULL)
+        goto done;
+    for (i=0; i<nvec; i++){
+        if ((vec[i] = strdup(vec[i])) == NULL){
+            clixon_err(OE_UNIX, errno, "strdup");
+            nvec = i;
+            goto done;
+        }
+    }
+    *stepsp = vec;
+    *nstepsp = nvec;
+    vec = NULL;
+    retval = 1;
+ done:
+    if (vec){
+        for (i=0; i<nvec; i++)
+            free(vec[i]);
+        free(vec);
+    }
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Call a single statedata callback
+ *
+ * Create an xml state tree for the callback on the form:
+ *   <config>...</config>,
+ * call the user supplied function which can do two things:
+ *  - Fill in state XML in the tree and return 0
+ *  - Call cli_error() and return -1
+ * @param[in]  h       Clixon handle
+ * @param[in]  fn      Statedata callback
+ * @param[in]  name    Name of plugin or provider, for errors
+ * @param[in]  nsc     Namespace context for xpath
+ * @param[in]  xpath   String with XPATH syntax. or NULL for all
+ * @param[out] xp      If retval=1, state tree created and returned: <config>...
+ * @retval     1       OK, callback called and xp is set
+ * @retval     0       Statedata callback failed. no XML tree returned
+ * @retval    -1       Fatal error
+ */
+static int
+clixon_statedata_call(clixon_handle   h,
+                      plgstatedata_t *fn,
+                      char           *name,
+                      cvec           *nsc,
+                      char           *xpath,
+                      cxobj         **xp)
+{
+    int     retval = -1;
+    cxobj  *x = NULL;
+    void   *wh = NULL;
+
+    if ((x = xml_new(DATASTORE_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+        goto done;
+    wh = NULL;
+    if (clixon_resource_check(h, &wh, name, __FUNCTION__) < 0)
+        goto done;
+    if (fn(h, nsc, xpath, x) < 0){
+        if (clixon_resource_check(h, &wh, name, __FUNCTION__) < 0)
+            goto done;
+        if (clixon_err_category() < 0)
+            clixon_log(h, LOG_WARNING, "%s: Internal error: State callback in plugin: %s returned -1 but did not make a clixon_err call",
+                       __FUNCTION__, name);
+        goto fail;  /* Dont quit here on user callbacks */
+    }
+    if (clixon_resource_check(h, &wh, name, __FUNCTION__) < 0)
+        goto done;
+    if (xp){
+        *xp = x;
+        x = NULL;
+    }
+    retval = 1;
+ done:
+    if (x)
+        xml_free(x);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
 /*! Call single backend statedata callback
  *
  * Create an xml state tree (xret) for one callback only on the form:
@@ -269,10 +474,6 @@ clixon_plugin_daemon_all(clixon_handle h)
  * @param[in]  h       clicon handle
  * @param[in]  nsc     namespace context for xpath
  * @param[in]  xpath   String with XPATH syntax. or NULL for all
- * @param[in]  pagmode List pagination mode
- * @param[in]  offset  Offset, for list pagination
- * @param[in]  limit   Limit, for list pagination
- * @param[out] remaining  Remaining elements (if limit is non-zero)
  * @param[out] xp      If retval=1, state tree created and returned: <config>...
  * @retval     1       OK if callback found (and called) xret is set
  * @retval     0       Statedata callback failed. no XML tree returned
@@ -285,32 +486,183 @@ clixon_plugin_statedata_one(clixon_plugin_t *cp,
                             char            *xpath,
                             cxobj          **xp)
 {
-    int             retval = -1;
     plgstatedata_t *fn;          /* Plugin statedata fn */
-    cxobj          *x = NULL;
-    void           *wh = NULL;
 
-    if ((fn = clixon_plugin_api_get(cp)->ca_statedata) != NULL){
-        if ((x = xml_new(DATASTORE_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
-            goto done;
-        wh = NULL;
-        if (clixon_resource_check(h, &wh, clixon_plugin_name_get(cp), __FUNCTION__) < 0)
+    if ((fn = clixon_plugin_api_get(cp)->ca_statedata) == NULL)
+        return 1;
+    return clixon_statedata_call(h, fn, clixon_plugin_name_get(cp), nsc, xpath, xp);
+}
+
+/*! Bind and sort state tree returned from a statedata callback
+ *
+ * @param[in]     h       Clixon handle
+ * @param[in]     yspec   Yang spec
+ * @param[in]     name    Name of plugin or provider, for errors
+ * @param[in]     ret     Return value of statedata call
+ * @param[in]     x       State tree returned by callback, or NULL
+ * @param[in,out] xret    Replaced with netconf-error on failure
+ * @retval        1       OK
+ * @retval        0       Statedata callback failed (xret set with netconf-error)
+ * @retval       -1       Error
+ */
+static int
+clixon_statedata_bind(clixon_handle h,
+                      yang_stmt    *yspec,
+                      char         *name,
+                      int           ret,
+                      cxobj        *x,
+                      cxobj       **xret)
+{
+    int     retval = -1;
+    cbuf   *cberr = NULL;
+    cxobj  *xerr = NULL;
+
+    if (ret == 0){
+        if ((cberr = cbuf_new()) == NULL){
+            clixon_err(OE_UNIX, errno, "cbuf_new");
             goto done;
-        if (fn(h, nsc, xpath, x) < 0){
-            if (clixon_resource_check(h, &wh, clixon_plugin_name_get(cp), __FUNCTION__) < 0)
-                goto done;
-            if (clixon_err_category() < 0)
-                clixon_log(h, LOG_WARNING, "%s: Internal error: State callback in plugin: %s returned -1 but did not make a clixon_err call",
-                           __FUNCTION__, clixon_plugin_name_get(cp));
-            goto fail;  /* Dont quit here on user callbacks */
         }
-        if (clixon_resource_check(h, &wh, clixon_plugin_name_get(cp), __FUNCTION__) < 0)
+        /* error reason should be in clixon_err_reason */
+        cprintf(cberr, "Internal error, state callback in plugin %s returned invalid XML: %s",
+                name, clixon_err_reason());
+        if (netconf_operation_failed_xml(&xerr, "application", cbuf_get(cberr)) < 0)
             goto done;
+        xml_free(*xret);
+        *xret = xerr;
+        xerr = NULL;
+        goto fail;
     }
-    if (xp && x){
-        *xp = x;
-        x = NULL;
+    if (x == NULL || xml_child_nr(x) == 0)
+        goto ok;
+    clixon_debug_xml(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, x, "%s STATE:", name);
+    /* XXX: ret == 0 invalid yang binding should be handled as internal error */
+    if ((ret = xml_bind_yang(h, x, YB_MODULE, yspec, &xerr)) < 0)
+        goto done;
+    if (ret == 0){
+        if (clixon_netconf_internal_error(xerr,
+                                          ". Internal error, state callback returned invalid XML from plugin: ",
+                                          name) < 0)
+            goto done;
+        xml_free(*xret);
+        *xret = xerr;
+        xerr = NULL;
+        goto fail;
+    }
+    if (xml_sort_recurse(x) < 0)
+        goto done;
+    /* Remove global defaults and empty non-presence containers */
+    /* XXX: only for state data and according to with-defaults setting */
+    if (xml_default_nopresence(x, 2, 0) < 0)
+        goto done;
+ ok:
+    retval = 1;
+ done:
+    if (xerr)
+        xml_free(xerr);
+    if (cberr)
+        cbuf_free(cberr);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Merge bound state tree into result tree if it matches request xpath
+ *
+ * @param[in]     yspec   Yang spec
+ * @param[in]     nsc     Namespace context of request xpath
+ * @param[in]     xpath   Request xpath
+ * @param[in]     x       Bound and sorted state tree, children may be moved to xret
+ * @param[in,out] xret    State XML tree is merged with existing tree.
+ * @retval        1       OK
+ * @retval        0       Merge failed (xret set with netconf-error)
+ * @retval       -1       Error
+ */
+static int
+clixon_statedata_merge(yang_stmt *yspec,
+                       cvec      *nsc,
+                       char      *xpath,
+                       cxobj     *x,
+                       cxobj    **xret)
+{
+    if (x == NULL || xml_child_nr(x) == 0)
+        return 1;
+    if (xpath_first(x, nsc, "%s", xpath) == NULL)
+        return 1;
+    return netconf_trymerge(x, yspec, xret);
+}
+
+/*! Check if provider path intersects request path
+ *
+ * @param[in]  sp      State data provider
+ * @param[in]  steps   Location steps of request, see statedata_xpath_steps
+ * @param[in]  nsteps  Number of steps
+ * @retval     1       Intersect: one path is a prefix of the other
+ * @retval     0       Disjoint
+ */
+static int
+statedata_provider_intersect(statedata_provider_t *sp,
+                             char                **steps,
+                             int                   nsteps)
+{
+    int i;
+
+    for (i=0; i<nsteps && i<sp->sp_nsteps; i++)
+        if (strcmp(steps[i], sp->sp_steps[i]) != 0)
+            return 0;
+    return 1;
+}
+
+/*! Get state tree of a caching provider, from cache if fresh otherwise by calling it
+ *
+ * The provider is always called with its own path so that the cached tree covers the
+ * whole subtree and can serve any request intersecting it.
+ * @param[in]     h       Clixon handle
+ * @param[in]     yspec   Yang spec
+ * @param[in]     sp      State data provider with max-age set
+ * @param[out]    xp      Copy of cached state tree, or NULL
+ * @param[in,out] xret    Replaced with netconf-error on failure
+ * @retval        1       OK
+ * @retval        0       Statedata callback failed (xret set with netconf-error)
+ * @retval       -1       Error
+ */
+static int
+clixon_statedata_cached(clixon_handle         h,
+                        yang_stmt            *yspec,
+                        statedata_provider_t *sp,
+                        cxobj               **xp,
+                        cxobj               **xret)
+{
+    int            retval = -1;
+    cxobj         *x = NULL;
+    struct timeval now;
+    struct timeval age;
+    int            ret;
+
+    gettimeofday(&now, NULL);
+    if (sp->sp_cache){
+        timersub(&now, &sp->sp_cachetime, &age);
+        if (age.tv_sec*1000 + age.tv_usec/1000 < sp->sp_maxage){
+            sp->sp_hits++;
+            goto ok;
+        }
+        xml_free(sp->sp_cache);
+        sp->sp_cache = NULL;
     }
+    sp->sp_misses++;
+    if ((ret = clixon_statedata_call(h, sp->sp_fn, sp->sp_xpath,
+                                     clicon_nsctx_global_get(h), sp->sp_xpath, &x)) < 0)
+        goto done;
+    if ((ret = clixon_statedata_bind(h, yspec, sp->sp_xpath, ret, x, xret)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    sp->sp_cache = x;
+    sp->sp_cachetime = now;
+    x = NULL;
+ ok:
+    if ((*xp = xml_dup(sp->sp_cache)) == NULL)
+        goto done;
     retval = 1;
  done:
     if (x)
@@ -324,7 +676,10 @@ clixon_plugin_statedata_one(clixon_plugin_t *cp,
 /*! Go through all backend statedata callbacks and collect state data
  *
  * This is internal system call, plugin is invoked (does not call) this function
- * Backend plugins can register 
+ * First, the ca_statedata callback of every plugin is called with the request xpath.
+ * Then, state data providers registered with clixon_statedata_cb_register are called if their
+ * path intersects the request xpath. A provider is called with the narrower of the two paths,
+ * unless it has a max-age in which case it is called with its own path and its state is cached.
  * @param[in]     h       clicon handle
  * @param[in]     yspec   Yang spec
  * @param[in]     nsc     Namespace context
@@ -334,6 +689,7 @@ clixon_plugin_statedata_one(clixon_plugin_t *cp,
  * @retval        0       Statedata callback failed (xret set with netconf-error)
  * @retval       -1       Error
  * @note xret can be replaced in this function
+ * @note xpath is assumed to use canonical prefixes, see xpath2canonical
  */
 int
 clixon_plugin_statedata_all(clixon_handle   h,
@@ -342,71 +698,626 @@ clixon_plugin_statedata_all(clixon_handle   h,
                             char           *xpath,
                             cxobj         **xret)
 {
-    int              retval = -1;
-    int              ret;
-    cxobj           *x = NULL;
-    clixon_plugin_t *cp = NULL;
-    cbuf            *cberr = NULL;
-    cxobj           *xerr = NULL;
+    int                   retval = -1;
+    int                   ret;
+    cxobj                *x = NULL;
+    clixon_plugin_t      *cp = NULL;
+    statedata_provider_t *sp_list = NULL;
+    statedata_provider_t *sp;
+    char                **steps = NULL;
+    int                   nsteps = 0;
+    int                   plain;
+    int                   i;
 
     clixon_debug(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, "");
     while ((cp = clixon_plugin_each(h, cp)) != NULL) {
+        x = NULL;
         if ((ret = clixon_plugin_statedata_one(cp, h, nsc, xpath, &x)) < 0)
             goto done;
-        if (ret == 0){
-            if ((cberr = cbuf_new()) == NULL){
-                clixon_err(OE_UNIX, errno, "cbuf_new");
-                goto done;
-            }
-            /* error reason should be in clixon_err_reason */
-            cprintf(cberr, "Internal error, state callback in plugin %s returned invalid XML: %s",
-                    clixon_plugin_name_get(cp), clixon_err_reason());
-            if (netconf_operation_failed_xml(&xerr, "application", cbuf_get(cberr)) < 0)
-                goto done;
-            xml_free(*xret);
-            *xret = xerr;
-            xerr = NULL;
+        if ((ret = clixon_statedata_bind(h, yspec, clixon_plugin_name_get(cp), ret, x, xret)) < 0)
+            goto done;
+        if (ret == 0)
             goto fail;
-        }
-        if (x == NULL)
-            continue;
-        if (xml_child_nr(x) == 0){
+        if ((ret = clixon_statedata_merge(yspec, nsc, xpath, x, xret)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+        if (x){
             xml_free(x);
             x = NULL;
+        }
+    } /* while plugin */
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    if ((sp = sp_list) == NULL)
+        goto ok;
+    /* Request xpath "/" or not a plain path (eg union): all providers intersect */
+    if (xpath == NULL || strcmp(xpath, "/") == 0)
+        plain = 0;
+    else if ((plain = statedata_xpath_steps(xpath, &steps, &nsteps)) < 0)
+        goto done;
+    do {
+        if (sp->sp_fn == NULL || /* Asynchronous, see clixon_statedata_async_start */
+            (plain && !statedata_provider_intersect(sp, steps, nsteps))){
+            sp = NEXTQ(statedata_provider_t *, sp);
             continue;
         }
-        clixon_debug_xml(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, x, "%s STATE:", clixon_plugin_name_get(cp));
-        /* XXX: ret == 0 invalid yang binding should be handled as internal error */
-        if ((ret = xml_bind_yang(h, x, YB_MODULE, yspec, &xerr)) < 0)
-            goto done;
-        if (ret == 0){
-            if (clixon_netconf_internal_error(xerr,
-                                              ". Internal error, state callback returned invalid XML from plugin: ",
-                                              clixon_plugin_name_get(cp)) < 0)
+        clixon_debug(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, "provider %s", sp->sp_xpath);
+        if (sp->sp_maxage)
+            ret = clixon_statedata_cached(h, yspec, sp, &x, xret);
+        else{
+            /* Call with the narrowest path */
+            if (plain && nsteps >= sp->sp_nsteps)
+                ret = clixon_statedata_call(h, sp->sp_fn, sp->sp_xpath, nsc, xpath, &x);
+            else
+                ret = clixon_statedata_call(h, sp->sp_fn, sp->sp_xpath,
+                                            clicon_nsctx_global_get(h), sp->sp_xpath, &x);
+            if (ret < 0)
                 goto done;
-            xml_free(*xret);
-            *xret = xerr;
-            xerr = NULL;
-            goto fail;
+            ret = clixon_statedata_bind(h, yspec, sp->sp_xpath, ret, x, xret);
         }
-        if (xml_sort_recurse(x) < 0)
+        if (ret < 0)
             goto done;
-        /* Remove global defaults and empty non-presence containers */
-        /* XXX: only for state data and according to with-defaults setting */
-        if (xml_default_nopresence(x, 2, 0) < 0)
+        if (ret == 0)
+            goto fail;
+        if ((ret = clixon_statedata_merge(yspec, nsc, xpath, x, xret)) < 0)
             goto done;
-        if (xpath_first(x, nsc, "%s", xpath) != NULL){
-            if ((ret = netconf_trymerge(x, yspec, xret)) < 0)
-                goto done;
-            if (ret == 0)
-                goto fail;
-        }
+        if (ret == 0)
+            goto fail;
         if (x){
             xml_free(x);
             x = NULL;
         }
-    } /* while plugin */
+        sp = NEXTQ(statedata_provider_t *, sp);
+    } while (sp && sp != sp_list);
+ ok:
+    retval = 1;
+ done:
+    if (steps){
+        for (i=0; i<nsteps; i++)
+            free(steps[i]);
+        free(steps);
+    }
+    if (x)
+        xml_free(x);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Register a state data provider on a schema path
+ *
+ * The callback is called on get requests whose xpath intersects the path, ie either the
+ * request is within the path or the path is within the request. It is called with the
+ * narrower of the two as xpath.
+ * The ca_statedata plugin callback is still called on all requests.
+ * @param[in]  h      Clixon handle
+ * @param[in]  fn     State data callback
+ * @param[in]  xpath  Plain absolute path using canonical prefixes, eg /if:interfaces-state
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @code
+ *   if (clixon_statedata_cb_register(h, example_statedata, "/ex:state") < 0)
+ *      goto done;
+ * @endcode
+ */
+int
+clixon_statedata_cb_register(clixon_handle   h,
+                             plgstatedata_t *fn,
+                             char           *xpath)
+{
+    int                   retval = -1;
+    statedata_provider_t *sp = NULL;
+    statedata_provider_t *sp_list = NULL;
+    int                   ret;
+
+    if ((sp = malloc(sizeof(*sp))) == NULL){
+        clixon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(sp, 0, sizeof(*sp));
+    sp->sp_fn = fn;
+    if ((sp->sp_xpath = strdup(xpath)) == NULL){
+        clixon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    if ((ret = statedata_xpath_steps(xpath, &sp->sp_steps, &sp->sp_nsteps)) < 0)
+        goto done;
+    if (ret == 0){
+        clixon_err(OE_PLUGIN, EINVAL, "State data path %s is not a plain absolute path", xpath);
+        goto done;
+    }
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    ADDQ(sp, sp_list);
+    if (clicon_ptr_set(h, "statedata-providers", sp_list) < 0)
+        goto done;
+    sp = NULL;
+    retval = 0;
+ done:
+    if (sp)
+        statedata_provider_free(sp);
+    return retval;
+}
+
+/*! Free state data providers
+ *
+ * @param[in]  h      Clixon handle
+ */
+int
+clixon_statedata_free(clixon_handle h)
+{
+    statedata_provider_t *sp_list = NULL;
+    statedata_provider_t *sp;
+    statedata_async_t    *sa = NULL;
+
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    while ((sp = sp_list) != NULL){
+        DELQ(sp, sp_list, statedata_provider_t *);
+        statedata_provider_free(sp);
+    }
+    clicon_ptr_set(h, "statedata-providers", NULL);
+    clicon_ptr_get(h, "statedata-async", (void**)&sa);
+    while (sa != NULL){
+        statedata_async_free(h, sa);
+        clicon_ptr_get(h, "statedata-async", (void**)&sa);
+    }
+    return 0;
+}
+
+/*! Set max-age of the state cache of a state data provider
+ *
+ * When set, the provider is called with its own path and the bound state tree is cached.
+ * Get requests intersecting the path are served from the cache until it is older than max-age.
+ * @param[in]  h      Clixon handle
+ * @param[in]  xpath  Path the provider was registered with, see clixon_statedata_cb_register
+ * @param[in]  maxage Max age of cached state in milliseconds, 0 disables caching
+ * @retval     0      OK
+ * @retval    -1      Error, eg no provider registered on xpath
+ * @code
+ *   if (clixon_statedata_cb_register(h, example_statedata, "/ex:state") < 0)
+ *      goto done;
+ *   if (clixon_statedata_cache_set(h, "/ex:state", 5000) < 0)
+ *      goto done;
+ * @endcode
+ */
+int
+clixon_statedata_cache_set(clixon_handle h,
+                           char         *xpath,
+                           uint32_t      maxage)
+{
+    int                   retval = -1;
+    statedata_provider_t *sp_list = NULL;
+    statedata_provider_t *sp;
+    int                   found = 0;
+
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    if ((sp = sp_list) != NULL){
+        do {
+            if (sp->sp_fn && strcmp(sp->sp_xpath, xpath) == 0){
+                sp->sp_maxage = maxage;
+                if (sp->sp_cache){
+                    xml_free(sp->sp_cache);
+                    sp->sp_cache = NULL;
+                }
+                found++;
+            }
+            sp = NEXTQ(statedata_provider_t *, sp);
+        } while (sp && sp != sp_list);
+    }
+    if (!found){
+        clixon_err(OE_PLUGIN, ENOENT, "No state data provider registered on %s", xpath);
+        goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Invalidate cached state of state data providers
+ *
+ * A plugin calls this when it knows state has changed, eg on a link event, so that the
+ * next get calls the provider even if the cache is younger than max-age.
+ * @param[in]  h      Clixon handle
+ * @param[in]  xpath  Invalidate providers whose path intersects this path, or NULL for all
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+int
+clixon_statedata_cache_invalidate(clixon_handle h,
+                                  char         *xpath)
+{
+    int                   retval = -1;
+    statedata_provider_t *sp_list = NULL;
+    statedata_provider_t *sp;
+    char                **steps = NULL;
+    int                   nsteps = 0;
+    int                   plain = 0;
+    int                   i;
+
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    if ((sp = sp_list) == NULL)
+        goto ok;
+    if (xpath != NULL && strcmp(xpath, "/") != 0)
+        if ((plain = statedata_xpath_steps(xpath, &steps, &nsteps)) < 0)
+            goto done;
+    do {
+        if (sp->sp_cache &&
+            (!plain || statedata_provider_intersect(sp, steps, nsteps))){
+            xml_free(sp->sp_cache);
+            sp->sp_cache = NULL;
+        }
+        sp = NEXTQ(statedata_provider_t *, sp);
+    } while (sp && sp != sp_list);
+ ok:
+    retval = 0;
+ done:
+    if (steps){
+        for (i=0; i<nsteps; i++)
+            free(steps[i]);
+        free(steps);
+    }
+    return retval;
+}
+
+/*! Print state cache statistics of state data providers with max-age set
+ *
+ * @param[in]  h      Clixon handle
+ * @param[out] cb     Output buffer, list of provider entries of clixon-lib stats
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+int
+clixon_statedata_cache_stats(clixon_handle h,
+                             cbuf         *cb)
+{
+    int                   retval = -1;
+    statedata_provider_t *sp_list = NULL;
+    statedata_provider_t *sp;
+    struct timeval        now;
+    struct timeval        age;
+
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    if ((sp = sp_list) == NULL)
+        goto ok;
+    gettimeofday(&now, NULL);
+    do {
+        if (sp->sp_maxage){
+            cprintf(cb, "<provider><path>");
+            if (xml_chardata_cbuf_append(cb, sp->sp_xpath) < 0)
+                goto done;
+            cprintf(cb, "</path>");
+            cprintf(cb, "<max-age>%u</max-age>", sp->sp_maxage);
+            cprintf(cb, "<hits>%" PRIu64 "</hits>", sp->sp_hits);
+            cprintf(cb, "<misses>%" PRIu64 "</misses>", sp->sp_misses);
+            if (sp->sp_cache){
+                timersub(&now, &sp->sp_cachetime, &age);
+                cprintf(cb, "<age>%lu</age>",
+                        (unsigned long)(age.tv_sec*1000 + age.tv_usec/1000));
+            }
+            cprintf(cb, "</provider>");
+        }
+        sp = NEXTQ(statedata_provider_t *, sp);
+    } while (sp && sp != sp_list);
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Register an asynchronous state data provider on a schema path
+ *
+ * Same as clixon_statedata_cb_register but the callback only starts collecting state data
+ * and returns. It is given a call id and reports the result with clixon_statedata_async_done,
+ * typically from a callback of its own file descriptors registered with clixon_event_reg_fd.
+ * Meanwhile, the backend continues to serve other sessions.
+ * @param[in]  h      Clixon handle
+ * @param[in]  fn     Asynchronous state data callback
+ * @param[in]  xpath  Plain absolute path using canonical prefixes, eg /if:interfaces-state
+ * @param[in]  arg    Argument given to fn
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see CLICON_BACKEND_STATE_TIMEOUT
+ */
+int
+clixon_statedata_async_register(clixon_handle         h,
+                                plgstatedata_async_t *fn,
+                                char                 *xpath,
+                                void                 *arg)
+{
+    int                   retval = -1;
+    statedata_provider_t *sp_list = NULL;
+    statedata_provider_t *sp;
+
+    if (clixon_statedata_cb_register(h, NULL, xpath) < 0)
+        goto done;
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    sp = PREVQ(statedata_provider_t *, sp_list); /* Last added */
+    sp->sp_afn = fn;
+    sp->sp_arg = arg;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Get ongoing asynchronous state data request by request id or call id
+ *
+ * @param[in]  h       Clixon handle
+ * @param[in]  id      Request id, or 0
+ * @param[in]  callid  Call id, or 0
+ * @param[out] ip      Index of call id in request, if callid given
+ * @retval     sa      Found request
+ * @retval     NULL    Not found, eg timed out or cancelled
+ */
+static statedata_async_t *
+statedata_async_find(clixon_handle h,
+                     uint32_t      id,
+                     uint32_t      callid,
+                     int          *ip)
+{
+    statedata_async_t *sa_list = NULL;
+    statedata_async_t *sa;
+    int                i;
+
+    clicon_ptr_get(h, "statedata-async", (void**)&sa_list);
+    if ((sa = sa_list) == NULL)
+        return NULL;
+    do {
+        if (id && sa->sa_id == id)
+            return sa;
+        if (callid)
+            for (i=0; i<sa->sa_ncalls; i++)
+                if (sa->sa_calls[i].sc_id == callid){
+                    if (ip)
+                        *ip = i;
+                    return sa;
+                }
+        sa = NEXTQ(statedata_async_t *, sa);
+    } while (sa && sa != sa_list);
+    return NULL;
+}
+
+/*! All providers of an asynchronous request are done or timeout, resume the request
+ *
+ * Called as a timeout, either on CLICON_BACKEND_STATE_TIMEOUT or immediately when the last
+ * provider is done, so that the plugin's call to clixon_statedata_async_done returns first.
+ * @param[in]  s     Not used
+ * @param[in]  arg   Asynchronous state data request
+ * @retval     0     OK
+ * @retval    -1    Error
+ */
+static int
+statedata_async_resume(int   s,
+                       void *arg)
+{
+    statedata_async_t *sa = (statedata_async_t *)arg;
+    int                i;
+
+    if (sa->sa_outstanding){
+        clixon_log(sa->sa_h, LOG_WARNING, "%s: %d asynchronous state data providers timed out",
+                   __FUNCTION__, sa->sa_outstanding);
+        for (i=0; i<sa->sa_ncalls; i++)
+            sa->sa_calls[i].sc_id = 0;
+        sa->sa_outstanding = 0;
+    }
+    return sa->sa_fn(sa->sa_h, sa->sa_id, sa->sa_fnarg);
+}
+
+/*! Remove and free asynchronous state data request
+ */
+static int
+statedata_async_free(clixon_handle      h,
+                     statedata_async_t *sa)
+{
+    statedata_async_t *sa_list = NULL;
+
+    clixon_event_unreg_timeout(statedata_async_resume, sa);
+    clicon_ptr_get(h, "statedata-async", (void**)&sa_list);
+    DELQ(sa, sa_list, statedata_async_t *);
+    clicon_ptr_set(h, "statedata-async", sa_list);
+    if (sa->sa_calls)
+        free(sa->sa_calls);
+    if (sa->sa_xstate)
+        xml_free(sa->sa_xstate);
+    free(sa);
+    return 0;
+}
+
+/*! Start asynchronous state data providers intersecting a request xpath
+ *
+ * If any provider is started, the caller should defer its reply until fn is called, and
+ * then get the collected state with clixon_statedata_async_result.
+ * @param[in]  h      Clixon handle
+ * @param[in]  nsc    Namespace context of xpath
+ * @param[in]  xpath  Request xpath using canonical prefixes
+ * @param[in]  fn     Called when all providers are done or on timeout
+ * @param[in]  arg    Argument given to fn
+ * @param[out] idp    Request id, if retval is 1
+ * @retval     1      Providers started, wait for fn
+ * @retval     0      No asynchronous provider intersects xpath
+ * @retval    -1      Error
+ */
+int
+clixon_statedata_async_start(clixon_handle             h,
+                             cvec                     *nsc,
+                             char                     *xpath,
+                             statedata_async_resume_t *fn,
+                             void                     *arg,
+                             uint32_t                 *idp)
+{
+    int                   retval = -1;
+    statedata_provider_t *sp_list = NULL;
+    statedata_provider_t *sp;
+    statedata_async_t    *sa = NULL;
+    statedata_async_t    *sa_list = NULL;
+    char                **steps = NULL;
+    int                   nsteps = 0;
+    int                   plain = 0;
+    int                   n = 0;
+    int                   i;
+    uint32_t              id;
+    uint32_t              timeout = 0;
+    struct timeval        t;
+    struct timeval        t1;
+
+    clicon_ptr_get(h, "statedata-providers", (void**)&sp_list);
+    if ((sp = sp_list) == NULL)
+        goto ok;
+    if (xpath != NULL && strcmp(xpath, "/") != 0)
+        if ((plain = statedata_xpath_steps(xpath, &steps, &nsteps)) < 0)
+            goto done;
+    do {
+        if (sp->sp_afn && (!plain || statedata_provider_intersect(sp, steps, nsteps)))
+            n++;
+        sp = NEXTQ(statedata_provider_t *, sp);
+    } while (sp && sp != sp_list);
+    if (n == 0)
+        goto ok;
+    if ((sa = malloc(sizeof(*sa))) == NULL){
+        clixon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(sa, 0, sizeof(*sa));
+    if ((sa->sa_calls = calloc(n, sizeof(*sa->sa_calls))) == NULL){
+        clixon_err(OE_UNIX, errno, "calloc");
+        free(sa);
+        sa = NULL;
+        goto done;
+    }
+    sa->sa_h = h;
+    sa->sa_id = ++_statedata_async_id;
+    sa->sa_fn = fn;
+    sa->sa_fnarg = arg;
+    clicon_ptr_get(h, "statedata-async", (void**)&sa_list);
+    ADDQ(sa, sa_list);
+    clicon_ptr_set(h, "statedata-async", sa_list);
+    id = sa->sa_id;
+    /* Assign all call ids before starting, a provider may be done immediately */
+    sp = sp_list;
+    do {
+        if (sp->sp_afn && (!plain || statedata_provider_intersect(sp, steps, nsteps))){
+            sa->sa_calls[sa->sa_ncalls].sc_id = ++_statedata_async_id;
+            sa->sa_calls[sa->sa_ncalls].sc_sp = sp;
+            sa->sa_ncalls++;
+            sa->sa_outstanding++;
+        }
+        sp = NEXTQ(statedata_provider_t *, sp);
+    } while (sp && sp != sp_list);
+    sa->sa_starting = 1;
+    sp = sp_list;
+    i = 0;
+    do {
+        if (sp->sp_afn && (!plain || statedata_provider_intersect(sp, steps, nsteps))){
+            clixon_debug(CLIXON_DBG_BACKEND | CLIXON_DBG_DETAIL, "async provider %s", sp->sp_xpath);
+            /* Call with the narrowest path */
+            if (plain && nsteps >= sp->sp_nsteps){
+                if (sp->sp_afn(h, nsc, xpath, sa->sa_calls[i].sc_id, sp->sp_arg) < 0)
+                    goto done;
+            }
+            else if (sp->sp_afn(h, clicon_nsctx_global_get(h), sp->sp_xpath,
+                                sa->sa_calls[i].sc_id, sp->sp_arg) < 0)
+                goto done;
+            i++;
+        }
+        sp = NEXTQ(statedata_provider_t *, sp);
+    } while (sp && sp != sp_list);
+    sa->sa_starting = 0;
+    gettimeofday(&t, NULL);
+    if (sa->sa_outstanding &&
+        (timeout = clicon_option_int(h, "CLICON_BACKEND_STATE_TIMEOUT")) != 0){
+        t1.tv_sec = timeout/1000;
+        t1.tv_usec = (timeout%1000)*1000;
+        timeradd(&t, &t1, &t);
+    }
+    if ((sa->sa_outstanding == 0 || timeout != 0) &&
+        clixon_event_reg_timeout(t, statedata_async_resume, sa, "async state data") < 0)
+        goto done;
+    *idp = id;
+    sa = NULL;
     retval = 1;
+ done:
+    if (sa)  /* Error: cancel request, late calls to clixon_statedata_async_done are ignored */
+        statedata_async_free(h, sa);
+    if (steps){
+        for (i=0; i<nsteps; i++)
+            free(steps[i]);
+        free(steps);
+    }
+    return retval;
+ ok:
+    retval = 0;
+    goto done;
+}
+
+/*! Report state data collected by an asynchronous state data provider
+ *
+ * Called by the plugin when done. If the request has timed out or been cancelled, the
+ * state is ignored.
+ * @param[in]  h       Clixon handle
+ * @param[in]  callid  Call id given to the asynchronous callback
+ * @param[in]  xstate  State tree on the form <config>...</config>, or NULL on failure. Not freed
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+int
+clixon_statedata_async_done(clixon_handle h,
+                            uint32_t      callid,
+                            cxobj        *xstate)
+{
+    int                retval = -1;
+    statedata_async_t *sa;
+    cxobj             *x = NULL;
+    yang_stmt         *yspec;
+    char              *name;
+    int                i = 0;
+    int                ret;
+    struct timeval     t;
+    cbuf              *cberr = NULL;
+    cxobj             *xerr = NULL;
+
+    if (callid == 0 || (sa = statedata_async_find(h, 0, callid, &i)) == NULL)
+        goto ok;
+    name = sa->sa_calls[i].sc_sp->sp_xpath;
+    sa->sa_calls[i].sc_id = 0;
+    sa->sa_outstanding--;
+    if (sa->sa_failed)
+        ;
+    else if (xstate == NULL){
+        if ((cberr = cbuf_new()) == NULL){
+            clixon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        cprintf(cberr, "Asynchronous state data provider %s failed", name);
+        if (netconf_operation_failed_xml(&xerr, "application", cbuf_get(cberr)) < 0)
+            goto done;
+        if (sa->sa_xstate)
+            xml_free(sa->sa_xstate);
+        sa->sa_xstate = xerr;
+        xerr = NULL;
+        sa->sa_failed = 1;
+    }
+    else {
+        yspec = clicon_dbspec_yang(h);
+        if ((x = xml_dup(xstate)) == NULL)
+            goto done;
+        if ((ret = clixon_statedata_bind(h, yspec, name, 1, x, &sa->sa_xstate)) < 0)
+            goto done;
+        if (ret == 0)
+            sa->sa_failed = 1;
+        else if (xml_child_nr(x)){
+            if ((ret = netconf_trymerge(x, yspec, &sa->sa_xstate)) < 0)
+                goto done;
+            if (ret == 0)
+                sa->sa_failed = 1;
+        }
+    }
+    if (sa->sa_outstanding == 0 && !sa->sa_starting){
+        clixon_event_unreg_timeout(statedata_async_resume, sa);
+        gettimeofday(&t, NULL);
+        if (clixon_event_reg_timeout(t, statedata_async_resume, sa, "async state data") < 0)
+            goto done;
+    }
+ ok:
+    retval = 0;
  done:
     if (xerr)
         xml_free(xerr);
@@ -415,11 +1326,73 @@ clixon_plugin_statedata_all(clixon_handle   h,
     if (x)
         xml_free(x);
     return retval;
+}
+
+/*! Merge state collected by asynchronous state data providers and end the request
+ *
+ * @param[in]     h       Clixon handle
+ * @param[in]     id      Request id from clixon_statedata_async_start
+ * @param[in]     yspec   Yang spec
+ * @param[in]     nsc     Namespace context of request xpath
+ * @param[in]     xpath   Request xpath
+ * @param[in,out] xret    State XML tree is merged with existing tree.
+ * @retval        1       OK
+ * @retval        0       A provider failed (xret set with netconf-error)
+ * @retval       -1       Error
+ */
+int
+clixon_statedata_async_result(clixon_handle h,
+                              uint32_t      id,
+                              yang_stmt    *yspec,
+                              cvec         *nsc,
+                              char         *xpath,
+                              cxobj       **xret)
+{
+    int                retval = -1;
+    statedata_async_t *sa;
+    int                ret;
+
+    if ((sa = statedata_async_find(h, id, 0, NULL)) == NULL)
+        goto ok;
+    if (sa->sa_failed){
+        xml_free(*xret);
+        *xret = sa->sa_xstate;
+        sa->sa_xstate = NULL;
+        statedata_async_free(h, sa);
+        goto fail;
+    }
+    ret = clixon_statedata_merge(yspec, nsc, xpath, sa->sa_xstate, xret);
+    statedata_async_free(h, sa);
+    if (ret < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+ ok:
+    retval = 1;
+ done:
+    return retval;
  fail:
     retval = 0;
     goto done;
 }
 
+/*! Cancel asynchronous state data request, eg when the client session is closed
+ *
+ * @param[in]  h       Clixon handle
+ * @param[in]  id      Request id from clixon_statedata_async_start
+ * @retval     0       OK
+ */
+int
+clixon_statedata_async_cancel(clixon_handle h,
+                              uint32_t      id)
+{
+    statedata_async_t *sa;
+
+    if ((sa = statedata_async_find(h, id, 0, NULL)) != NULL)
+        statedata_async_free(h, sa);
+    return 0;
+}
+
 /*! Lock database status has changed status
  *
  * @param[in]  cp      Plugin handle
@@ -91,6 +91,20 @@ typedef struct {
     cxobj            *pd_xstate;    /* Returned xml state tree */
 } pagination_data_t;
 
+/*! Asynchronous state data callback
+ *
+ * Start collecting state data of xpath and return. When done, call
+ * clixon_statedata_async_done with callid.
+ * @see clixon_statedata_async_register
+ */
+typedef int (plgstatedata_async_t)(clixon_handle h, cvec *nsc, char *xpath, uint32_t callid, void *arg);
+
+/*! Called when all asynchronous state data providers of a request are done or timed out
+ *
+ * @see clixon_statedata_async_start
+ */
+typedef int (statedata_async_resume_t)(clixon_handle h, uint32_t id, void *arg);
+
 /*
  * Prototypes
  */
@@ -101,6 +115,17 @@ int clixon_plugin_pre_daemon_all(clixon_handle h);
 int clixon_plugin_daemon_all(clixon_handle h);
 
 int clixon_plugin_statedata_all(clixon_handle h, yang_stmt *yspec, cvec *nsc, char *xpath, cxobj **xtop);
+int clixon_statedata_cb_register(clixon_handle h, plgstatedata_t *fn, char *xpath);
+int clixon_statedata_free(clixon_handle h);
+int clixon_statedata_cache_set(clixon_handle h, char *xpath, uint32_t maxage);
+int clixon_statedata_cache_invalidate(clixon_handle h, char *xpath);
+int clixon_statedata_cache_stats(clixon_handle h, cbuf *cb);
+int clixon_statedata_async_register(clixon_handle h, plgstatedata_async_t *fn, char *xpath, void *arg);
+int clixon_statedata_async_start(clixon_handle h, cvec *nsc, char *xpath,
+                                 statedata_async_resume_t *fn, void *arg, uint32_t *idp);
+int clixon_statedata_async_done(clixon_handle h, uint32_t callid, cxobj *xstate);
+int clixon_statedata_async_result(clixon_handle h, uint32_t id, yang_stmt *yspec, cvec *nsc, char *xpath, cxobj **xret);
+int clixon_statedata_async_cancel(clixon_handle h, uint32_t id);
 int clixon_plugin_lockdb_all(clixon_handle h, char *db, int lock, int id);
 
 int clixon_pagination_cb_register(clixon_handle h, handler_function fn, char *path, void *arg);
@@ -71,6 +71,20 @@
 #include "cli_plugin.h"
 #include "cli_common.h"
 
+/* Edit of CLI batch mode, kept to map errors back to the command */
+typedef struct {
+    qelem_t  be_qelem;   /* List header */
+    int      be_line;    /* Line number of command, or -1 if unknown */
+    char    *be_cmd;     /* CLI command */
+    char    *be_xml;     /* Edit-config of the command */
+} batch_edit_t;
+
+/* CLI batch mode, stored as "cli-batch" in the clixon handle, see cli_batch_begin */
+typedef struct {
+    cxobj        *cb_xtop;   /* Merged edit-config of pending edits */
+    batch_edit_t *cb_edits;  /* Pending edits in order */
+} cli_batch_t;
+
 /*! Register log notification stream
  *
  * @param[in] h       Clixon handle
@@ -361,6 +375,299 @@ mtpoint_paths(yang_stmt *yspec0,
     return retval;
 }
 
+/*! Free pending edits of CLI batch and reset its merged edit-config tree
+ *
+ * @param[in]  cbt   CLI batch
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+cli_batch_reset(cli_batch_t *cbt)
+{
+    batch_edit_t *be;
+
+    while ((be = cbt->cb_edits) != NULL){
+        DELQ(be, cbt->cb_edits, batch_edit_t *);
+        if (be->be_cmd)
+            free(be->be_cmd);
+        if (be->be_xml)
+            free(be->be_xml);
+        free(be);
+    }
+    if (cbt->cb_xtop)
+        xml_free(cbt->cb_xtop);
+    if ((cbt->cb_xtop = xml_new(NETCONF_INPUT_CONFIG, NULL, CX_ELMNT)) == NULL)
+        return -1;
+    return 0;
+}
+
+/*! Merge an edit into the merged edit-config of a CLI batch
+ *
+ * An edit is a path of elements from the top to the edited node which carries the operation.
+ * It is merged by moving the first element of the path not present in the merged tree.
+ * The edit conflicts if its edited node, or a node on its path with an operation, is already
+ * in the merged tree. Conflicting edits need the pending edits to be sent first to keep
+ * the order of operations.
+ * @param[in]  x0    Merged edit-config tree
+ * @param[in]  x1    Edit, the merged parts are moved from it
+ * @retval     1     Merged
+ * @retval     0     Conflict, nothing merged
+ * @retval    -1     Error
+ */
+static int
+cli_batch_merge(cxobj *x0,
+                cxobj *x1)
+{
+    int    retval = -1;
+    cxobj *x1c;
+    cxobj *x0c;
+    int    ret;
+
+    x1c = NULL;
+    while ((x1c = xml_child_each(x1, x1c, CX_ELMNT)) != NULL) {
+        if (match_base_child(x0, x1c, xml_spec(x1c), &x0c) < 0)
+            goto done;
+        if (x0c == NULL){
+            if (xml_rm(x1c) < 0)
+                goto done;
+            /* Matching in the merged tree assumes sorted children */
+            if (xml_sort_recurse(x1c) < 0)
+                goto done;
+            if (xml_insert(x0, x1c, INS_LAST, NULL, NULL) < 0)
+                goto done;
+            x1c = NULL; /* x1c is moved, restart */
+            continue;
+        }
+        if (xml_find_type(x0c, NULL, "operation", CX_ATTR) != NULL ||
+            xml_find_type(x1c, NULL, "operation", CX_ATTR) != NULL)
+            goto conflict;
+        /* Matching list keys and path nodes, continue down */
+        if ((ret = cli_batch_merge(x0c, x1c)) < 0)
+            goto done;
+        if (ret == 0)
+            goto conflict;
+    }
+    retval = 1;
+ done:
+    return retval;
+ conflict:
+    retval = 0;
+    goto done;
+}
+
+/*! Send pending edits of CLI batch mode to the backend as a single edit-config
+ *
+ * If the merged edit-config fails, the edits are sent one by one to map the error to
+ * the command and line that caused it. Edits after the failing command are discarded.
+ * No-op if no batch is started or no edits are pending.
+ * @param[in]  h     Clixon handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see cli_batch_begin
+ */
+int
+cli_batch_flush(clixon_handle h)
+{
+    int           retval = -1;
+    cli_batch_t  *cbt = NULL;
+    batch_edit_t *be;
+    cbuf         *cb = NULL;
+    char         *reason = NULL;
+
+    clicon_ptr_get(h, "cli-batch", (void**)&cbt);
+    if (cbt == NULL || cbt->cb_edits == NULL)
+        goto ok;
+    if ((cb = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (clixon_xml2cbuf(cb, cbt->cb_xtop, 0, 0, NULL, -1, 0) < 0)
+        goto done;
+    if (clicon_rpc_edit_config(h, "candidate", OP_NONE, cbuf_get(cb)) < 0){
+        /* Map the error to a command by sending the edits one by one */
+        be = cbt->cb_edits;
+        do {
+            if (clicon_rpc_edit_config(h, "candidate", OP_NONE, be->be_xml) < 0){
+                if ((reason = strdup(clixon_err_reason())) == NULL){
+                    clixon_err(OE_UNIX, errno, "strdup");
+                    goto done;
+                }
+                if (be->be_line < 0)
+                    clixon_err(OE_CFG, 0, "\"%s\": %s", be->be_cmd, reason);
+                else
+                    clixon_err(OE_CFG, 0, "line %d \"%s\": %s", be->be_line, be->be_cmd, reason);
+                goto done;
+            }
+            be = NEXTQ(batch_edit_t *, be);
+        } while (be && be != cbt->cb_edits);
+    }
+ ok:
+    retval = 0;
+ done:
+    if (cbt && cli_batch_reset(cbt) < 0)
+        retval = -1;
+    if (reason)
+        free(reason);
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Report a command as not applied since sending the pending edits before it failed
+ *
+ * Called after cli_batch_flush failed, which has reported the failing command
+ * @param[in]  h     Clixon handle
+ * @param[in]  cmd   CLI command
+ */
+static void
+cli_batch_not_applied(clixon_handle h,
+                      char         *cmd)
+{
+    int line;
+
+    line = clicon_data_int_get(h, "cli-lineno");
+    if (line < 0)
+        clixon_err(OE_CFG, 0, "\"%s\": not applied", cmd?cmd:"");
+    else
+        clixon_err(OE_CFG, 0, "line %d \"%s\": not applied", line, cmd?cmd:"");
+}
+
+/*! Add an edit to CLI batch mode, send pending edits first if it conflicts with them
+ *
+ * If sending the pending edits fails, the edit is not applied and reported as such.
+ * @param[in]  h     Clixon handle
+ * @param[in]  cbt   CLI batch
+ * @param[in]  cmd   CLI command
+ * @param[in]  xtop  Edit-config of the command, merged parts are moved from it
+ * @param[in]  xml   Edit-config of the command as string
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+cli_batch_add(clixon_handle h,
+              cli_batch_t  *cbt,
+              char         *cmd,
+              cxobj        *xtop,
+              char         *xml)
+{
+    int           retval = -1;
+    batch_edit_t *be;
+    int           ret;
+
+    if ((ret = cli_batch_merge(cbt->cb_xtop, xtop)) < 0)
+        goto done;
+    if (ret == 0){
+        if (cli_batch_flush(h) < 0){
+            cli_batch_not_applied(h, cmd);
+            goto done;
+        }
+        if ((ret = cli_batch_merge(cbt->cb_xtop, xtop)) < 0)
+            goto done;
+    }
+    if ((be = malloc(sizeof(*be))) == NULL){
+        clixon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(be, 0, sizeof(*be));
+    be->be_line = clicon_data_int_get(h, "cli-lineno");
+    ADDQ(be, cbt->cb_edits);
+    if ((be->be_cmd = strdup(cmd?cmd:"")) == NULL ||
+        (be->be_xml = strdup(xml)) == NULL){
+        clixon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Start CLI batch mode: accumulate edits and send them as a single edit-config
+ *
+ * Edits of cli_set, cli_merge, cli_remove, etc, are merged into one edit-config tree which is
+ * sent to the backend on cli_batch_end, or before commit, validate and other commands
+ * operating on the candidate datastore. Create operations and edits touching pending edits
+ * send the pending edits first to keep the order of operations. Discarding or deleting the
+ * candidate drops pending edits without sending them.
+ * Note that show commands do not see pending edits.
+ * Example clispec:
+ * @code
+ *   batch begin, cli_batch_begin();
+ *   batch end, cli_batch_end();
+ * @endcode
+ * @param[in]  h     Clixon handle
+ * @param[in]  cvv   Vector of command variables (not used)
+ * @param[in]  argv  Arguments (not used)
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see clixon_cli -b
+ */
+int
+cli_batch_begin(clixon_handle h,
+                cvec         *cvv,
+                cvec         *argv)
+{
+    int          retval = -1;
+    cli_batch_t *cbt = NULL;
+
+    clicon_ptr_get(h, "cli-batch", (void**)&cbt);
+    if (cbt != NULL){
+        clixon_err(OE_CFG, EEXIST, "CLI batch already started");
+        goto done;
+    }
+    if ((cbt = malloc(sizeof(*cbt))) == NULL){
+        clixon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(cbt, 0, sizeof(*cbt));
+    if (cli_batch_reset(cbt) < 0){
+        free(cbt);
+        goto done;
+    }
+    if (clicon_ptr_set(h, "cli-batch", cbt) < 0){
+        xml_free(cbt->cb_xtop);
+        free(cbt);
+        goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! End CLI batch mode: send pending edits to the backend
+ *
+ * No-op if no batch is started
+ * @param[in]  h     Clixon handle
+ * @param[in]  cvv   Vector of command variables (not used)
+ * @param[in]  argv  Arguments (not used)
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see cli_batch_begin
+ */
+int
+cli_batch_end(clixon_handle h,
+              cvec         *cvv,
+              cvec         *argv)
+{
+    int          retval = -1;
+    cli_batch_t *cbt = NULL;
+    int          ret;
+
+    clicon_ptr_get(h, "cli-batch", (void**)&cbt);
+    if (cbt == NULL)
+        goto ok;
+    ret = cli_batch_flush(h);
+    clicon_ptr_del(h, "cli-batch");
+    if (cbt->cb_xtop)
+        xml_free(cbt->cb_xtop);
+    free(cbt);
+    if (ret < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Modify xml datastore from a callback using xml key format strings
  *
  * @param[in]  h     Clixon handle
@@ -411,6 +718,7 @@ cli_dbxml(clixon_handle       h,
     char      *mtpoint = NULL;
     yang_stmt *yspec0 = NULL;
     int        argc = 0;
+    cli_batch_t *cbt = NULL;
 
     /* Top-level yspec */
     if ((yspec0 = clicon_dbspec_yang(h)) == NULL){
@@ -505,8 +813,20 @@ cli_dbxml(clixon_handle       h,
     }
     if (clixon_xml2cbuf(cb, xtop, 0, 0, NULL, -1, 0) < 0)
         goto done;
-    if (clicon_rpc_edit_config(h, "candidate", OP_NONE, cbuf_get(cb)) < 0)
-        goto done;
+    clicon_ptr_get(h, "cli-batch", (void**)&cbt);
+    if (cbt != NULL && op != OP_CREATE){
+        /* Batch mode: merge the edit with pending edits, see cli_batch_begin */
+        if (cli_batch_add(h, cbt, cv_string_get(cvec_i(cvv, 0)), xtop, cbuf_get(cb)) < 0)
+            goto done;
+    }
+    else {
+        if (cli_batch_flush(h) < 0){
+            cli_batch_not_applied(h, cv_string_get(cvec_i(cvv, 0)));
+            goto done;
+        }
+        if (clicon_rpc_edit_config(h, "candidate", OP_NONE, cbuf_get(cb)) < 0)
+            goto done;
+    }
     retval = 0;
  done:
     if (api_path_fmt_cb)
@@ -890,6 +1210,8 @@ cli_commit(clixon_handle h,
     }
     persist = cvec_find_str(cvv, "persist-val");
     persist_id = cvec_find_str(cvv, "persist-id-val");
+    if (cli_batch_flush(h) < 0)
+        goto done;
     if (clicon_rpc_commit(h, confirmed, cancel, timeout, persist, persist_id) < 1)
         goto done;
     retval = 0;
@@ -911,6 +1233,8 @@ cli_validate(clixon_handle h,
 {
     int     retval = -1;
 
+    if (cli_batch_flush(h) < 0)
+        goto done;
     if (clicon_rpc_validate(h, "candidate") < 1)
         goto done;
     retval = 0;
@@ -1200,6 +1524,8 @@ load_config_file(clixon_handle h,
     }
     if (clixon_xml2cbuf(cbxml, xt, 0, 0, NULL, -1, 1) < 0)
         goto done;
+    if (cli_batch_flush(h) < 0)
+        goto done;
     if (clicon_rpc_edit_config(h, "candidate",
                                replace?OP_REPLACE:OP_MERGE,
                                cbuf_get(cbxml)) < 0)
@@ -1282,6 +1608,8 @@ save_config_file(clixon_handle h,
         goto done;
     }
     filename = cv_string_get(cv);
+    if (cli_batch_flush(h) < 0)
+        goto done;
     if (clicon_rpc_get_config(h, NULL, dbstr,"/", NULL, NULL, &xt) < 0)
         goto done;
     if (xt == NULL){
@@ -1356,6 +1684,7 @@ delete_all(clixon_handle h,
 {
     char            *dbstr;
     int              retval = -1;
+    cli_batch_t     *cbt = NULL;
 
     if (cvec_len(argv) != 1){
         clixon_err(OE_PLUGIN, EINVAL, "Requires one element: dbname");
@@ -1368,6 +1697,14 @@ delete_all(clixon_handle h,
         clixon_err(OE_PLUGIN, 0, "No such db name: %s", dbstr);
         goto done;
     }
+    if (strcmp(dbstr, "candidate") == 0){
+        /* Pending edits would be deleted, drop them without sending */
+        clicon_ptr_get(h, "cli-batch", (void**)&cbt);
+        if (cbt && cli_batch_reset(cbt) < 0)
+            goto done;
+    }
+    else if (cli_batch_flush(h) < 0)
+        goto done;
     if (clicon_rpc_delete_config(h, dbstr) < 0)
         goto done;
     retval = 0;
@@ -1376,14 +1713,20 @@ delete_all(clixon_handle h,
 }
 
 /*! Discard all changes in candidate and replace with running
+ *
+ * Pending edits of CLI batch mode are dropped without sending them
  */
 int
 discard_changes(clixon_handle h,
                 cvec         *cvv,
                 cvec         *argv)
 {
-    return clicon_rpc_discard_changes(h);
+    cli_batch_t *cbt = NULL;
 
+    clicon_ptr_get(h, "cli-batch", (void**)&cbt);
+    if (cbt && cli_batch_reset(cbt) < 0)
+        return -1;
+    return clicon_rpc_discard_changes(h);
 }
 /*! Copy from one database to another, eg running->startup
  *
@@ -1401,6 +1744,8 @@ db_copy(clixon_handle h,
 
     db1 = cv_string_get(cvec_i(argv, 0));
     db2 = cv_string_get(cvec_i(argv, 1));
+    if (cli_batch_flush(h) < 0)
+        return -1;
     return clicon_rpc_copy_config(h, db1, db2);
 }
 
@@ -1701,6 +2046,8 @@ cli_copy_config(clixon_handle h,
     cprintf(cb, xpath, keyname, fromname);
     if ((nsc = xml_nsctx_init(NULL, namespace)) == NULL)
         goto done;
+    if (cli_batch_flush(h) < 0)
+        goto done;
     /* Get from object configuration and store in x1 */
     if (clicon_rpc_get_config(h, NULL, db, cbuf_get(cb), nsc, NULL, &x1) < 0)
         goto done;
@@ -447,6 +447,7 @@ yang2cli_var_pattern(clixon_handle h,
 
 /* Forward */
 static int yang2cli_stmt(clixon_handle h, yang_stmt *ys, int level, cbuf *cb);
+static int yang2cli_lazy_ref(clixon_handle h, yang_stmt *ys, int level, cbuf *cb);
 
 static int yang2cli_var_union(clixon_handle h, yang_stmt *ys, char *origtype,
                               yang_stmt *ytype, char *helptext, cbuf *cb);
@@ -992,10 +993,20 @@ yang2cli_container(clixon_handle h,
             cprintf(cb, "%*s%s", (level+1)*3, "", "@mountpoint;\n");
         }
     }
-    yc = NULL;
-    while ((yc = yn_each(ys, yc)) != NULL)
-        if (yang2cli_stmt(h, yc, level+1, cb) < 0)
+    /* Lazy autocli: contents of top-level containers are generated on first use */
+    if (!compress &&
+        clicon_option_bool(h, "CLICON_CLI_AUTOCLI_LAZY") &&
+        (yang_keyword_get(yang_parent_get(ys)) == Y_MODULE ||
+         yang_keyword_get(yang_parent_get(ys)) == Y_SUBMODULE)){
+        if (yang2cli_lazy_ref(h, ys, level+1, cb) < 0)
             goto done;
+    }
+    else {
+        yc = NULL;
+        while ((yc = yn_each(ys, yc)) != NULL)
+            if (yang2cli_stmt(h, yc, level+1, cb) < 0)
+                goto done;
+    }
     if (!compress)
         cprintf(cb, "%*s}\n", level*3, "");
     retval = 0;
@@ -1505,7 +1516,7 @@ yang2cli_post(clixon_handle h,
 /*! Generate clispec for all modules in a grouping
  *
  * Called in cli main function for top-level yangs. But may also be called dynamically for
- * mountpoints.
+ * mountpoints, and for lazy top-level containers, see yang2cli_lazy_wrap
  * @param[in]  h         Clixon handle
  * @param[in]  ys        Top-level Yang statement
  * @param[in]  treename  Name of tree
@@ -1639,6 +1650,109 @@ yang2cli_grouping(clixon_handle      h,
     goto done;
 }
 
+/*! Generate a tree reference to the lazily generated contents of a top-level container
+ *
+ * The tree is named by the module and name of the container and is not generated until
+ * CLIgen first expands the reference, see yang2cli_lazy_wrap
+ * Module names are unique and consist of safe characters, as opposed to namespaces which may be
+ * URLs
+ * @param[in]  h     Clixon handle
+ * @param[in]  ys    Yang top-level container
+ * @param[in]  level Indentation level
+ * @param[out] cb    Buffer where cligen code is written
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+yang2cli_lazy_ref(clixon_handle h,
+                  yang_stmt    *ys,
+                  int           level,
+                  cbuf         *cb)
+{
+    int        retval = -1;
+    cbuf      *cbtree = NULL;
+    yang_stmt *ymod;
+
+    if ((cbtree = cbuf_new()) == NULL){
+        clixon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    /* prefix is not globally unique, need module */
+    if (ys_real_module(ys, &ymod) < 0)
+        goto done;
+    if (ymod == NULL){
+        clixon_err(OE_YANG, ENOENT, "No module of %s", yang_argument_get(ys));
+        goto done;
+    }
+    cprintf(cbtree, "%s-%s-%s", AUTOCLI_LAZY_PREFIX, yang_argument_get(ymod), yang_argument_get(ys));
+    if (clicon_ptr_set(h, cbuf_get(cbtree), ys) < 0)
+        goto done;
+    cprintf(cb, "%*s@%s;\n", level*3, "", cbuf_get(cbtree));
+    retval = 0;
+ done:
+    if (cbtree)
+        cbuf_free(cbtree);
+    return retval;
+}
+
+/*! CLIgen tree resolve wrapper generating lazy autocli trees on first expansion
+ *
+ * Registered by yang2cli_init if CLICON_CLI_AUTOCLI_LAZY is set.
+ * @param[in]  ch     CLIgen handle
+ * @param[in]  name   Name of referenced tree
+ * @param[in]  cvt    Tokenized command line
+ * @param[in]  arg    Clixon handle
+ * @param[out] namep  New name of tree if changed, not changed here
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see yang2cli_lazy_ref
+ */
+static int
+yang2cli_lazy_wrap(cligen_handle ch,
+                   char         *name,
+                   cvec         *cvt,
+                   void         *arg,
+                   char        **namep)
+{
+    int           retval = -1;
+    clixon_handle h = (clixon_handle)arg;
+    yang_stmt    *ys = NULL;
+    pt_head      *ph;
+    parse_tree   *pt = NULL;
+    int           ret;
+
+    if (strncmp(name, AUTOCLI_LAZY_PREFIX, strlen(AUTOCLI_LAZY_PREFIX)) != 0)
+        goto ok;
+    if (cligen_ph_find(ch, name) != NULL) /* Already generated */
+        goto ok;
+    if (clicon_ptr_get(h, name, (void**)&ys) < 0 || ys == NULL)
+        goto ok;
+    if ((ret = yang2cli_grouping(h, ys, name)) < 0)
+        goto done;
+    if (ret == 0){ /* Empty, add an empty tree so that the reference resolves */
+        if ((pt = pt_new()) == NULL){
+            clixon_err(OE_UNIX, errno, "pt_new");
+            goto done;
+        }
+        if ((ph = cligen_ph_add(ch, name)) == NULL){
+            clixon_err(OE_UNIX, 0, "cligen_ph_add");
+            goto done;
+        }
+        if (cligen_ph_parsetree_set(ph, pt) < 0){
+            clixon_err(OE_UNIX, 0, "cligen_ph_parsetree_set");
+            goto done;
+        }
+        pt = NULL;
+    }
+    clixon_debug(CLIXON_DBG_CLI, "Generated lazy auto-cli tree %s", name);
+ ok:
+    retval = 0;
+ done:
+    if (pt)
+        pt_free(pt, 1);
+    return retval;
+}
+
 /*! Generate clispec for all modules in yspec (except excluded)
  * 
  * Called in cli main function for top-level yangs. But may also be called dynamically for
@@ -1776,12 +1890,25 @@ yang2cli_yspec(clixon_handle      h,
 /*! Init yang2cli
  *
  * Initialize CLIgen generation from YANG models.
- * Nothing now
- *
+ * If CLICON_CLI_AUTOCLI_LAZY is set, register the tree resolve wrapper generating the
+ * contents of top-level containers on first use.
  * @param[in]  h      Clixon handle
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @note An application registering its own CLIgen tree resolve wrapper replaces the lazy one
  */
 int
 yang2cli_init(clixon_handle h)
 {
-    return 0;
+    int retval = -1;
+
+    if (clicon_option_bool(h, "CLICON_CLI_AUTOCLI_LAZY")){
+        if (cligen_tree_resolve_wrapper_set(cli_cligen(h), yang2cli_lazy_wrap, h) < 0){
+            clixon_err(OE_UNIX, 0, "cligen_tree_resolve_wrapper_set");
+            goto done;
+        }
+    }
+    retval = 0;
+ done:
+    return retval;
 }
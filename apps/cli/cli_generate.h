@@ -51,6 +51,9 @@
 #define GROUPING_CALLBACK "prepend_me"
 #define MTPOINT_PREFIX    "mtpoint:"
 
+/* Prefix of lazily generated autocli trees of top-level containers, see CLICON_CLI_AUTOCLI_LAZY */
+#define AUTOCLI_LAZY_PREFIX "autocli-lazy"
+
 /* variable expand function */
 #define GENERATE_EXPAND_XMLDB "expand_dbvar"
 
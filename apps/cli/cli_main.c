@@ -73,7 +73,7 @@
 #include "cli_handle.h"
 
 /* Command line options to be passed to getopt(3) */
-#define CLI_OPTS "+hVD:f:E:l:C:F:1a:u:d:m:qp:GLy:c:U:o:"
+#define CLI_OPTS "+hVD:f:E:l:C:F:1ba:u:d:m:qp:GLy:c:U:o:"
 /*! Check if there is a CLI history file and if so dump the CLI histiry to it
  *
  * Just log if file does not exist or is not readable
@@ -247,6 +247,7 @@ cli_interactive(clixon_handle h)
     cligen_result result;
     int           ret;
     pt_head      *ph;
+    int           lineno = 0;
 
     /* Loop through all commands */
     while(!cligen_exiting(cli_cligen(h))) {
@@ -265,6 +266,8 @@ cli_interactive(clixon_handle h)
             cligen_exiting_set(cli_cligen(h), 1);
             continue;
         }
+        /* Line number of command, eg for errors of batch mode */
+        clicon_data_int_set(h, "cli-lineno", ++lineno);
         /* Here errors are handled */
         if (clicon_parse(h, cmd, &new_mode, &result, NULL) < 0)
             goto done;
@@ -526,6 +529,7 @@ usage(clixon_handle h,
             "\t-C <format>\tDump configuration options on stdout after loading. Format is xml|json|text\n"
             "\t-F <file> \tRead commands from file (default stdin)\n"
             "\t-1\t\tDo not enter interactive mode\n"
+            "\t-b\t\tBatch mode, send edits as a single edit-config at end of input\n"
             "\t-a UNIX|IPv4|IPv6\tInternal backend socket family\n"
             "\t-u <path|addr>\tInternal socket domain path or IP addr (see -a)\n"
             "\t-d <dir>\tSpecify plugin directory (default: %s)\n"
@@ -575,6 +579,7 @@ main(int    argc,
     int            config_dump;
     enum format_enum config_dump_format = FORMAT_XML;
     int            print_version = 0;
+    int            batch = 0;
 
     /* Defaults */
     once = 0;
@@ -690,6 +695,9 @@ main(int    argc,
         case '1' : /* Quit after reading database once - dont wait for events */
             once = 1;
             break;
+        case 'b' : /* Batch mode, see cli_batch_begin */
+            batch = 1;
+            break;
         case 'a': /* internal backend socket address family */
             if (clicon_option_add(h, "CLICON_SOCK_FAMILY", optarg) < 0)
                 goto done;
@@ -947,6 +955,8 @@ main(int    argc,
      */
     clicon_data_set(h, "session-transport", "cl:cli");
 
+    if (batch && cli_batch_begin(h, NULL, NULL) < 0)
+        goto done;
     /* Launch interfactive event loop, 
      * unless options, in which case they are catched by clicon_argv_get/set */
     if (restarg != NULL && strlen(restarg) && restarg[0] != '-'){
@@ -960,6 +970,11 @@ main(int    argc,
     }
     else
         retval = 0;
+    /* Send pending edits of batch mode, also if started with cli_batch_begin */
+    if (cli_batch_end(h, NULL, NULL) < 0){
+        cli_handler_err(stdout);
+        retval = -1;
+    }
   done:
     if (restarg)
         free(restarg);
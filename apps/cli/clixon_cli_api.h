@@ -85,6 +85,9 @@ int mtpoint_paths(yang_stmt *yspec0, char *mtpoint, char *api_path_fmt1, char **
 int dbxml_body(cxobj *xbot, cvec *cvv);
 int identityref_add_ns(cxobj *x, void *arg);
 
+int cli_batch_flush(clixon_handle h);
+int cli_batch_begin(clixon_handle h, cvec *vars, cvec *argv);
+int cli_batch_end(clixon_handle h, cvec *vars, cvec *argv);
 int cli_dbxml(clixon_handle h, cvec *vars, cvec *argv, enum operation_type op, cvec *nsctx);
 int cli_set(clixon_handle h, cvec *vars, cvec *argv);
 int cli_merge(clixon_handle h, cvec *vars, cvec *argv);
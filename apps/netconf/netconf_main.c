@@ -39,11 +39,13 @@
 #include "clixon_config.h" /* generated by config & autoconf */
 #endif
 
+#define _GNU_SOURCE /* for ucred, before any system header */
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdarg.h>
+#include <ctype.h>
 #include <errno.h>
 #include <signal.h>
 #include <fcntl.h>
@@ -53,9 +55,13 @@
 #include <syslog.h>
 #include <sys/time.h>
 #include <sys/socket.h>
+#ifdef HAVE_LOCAL_PEERCRED
+#include <sys/ucred.h>
+#endif
 #include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -70,7 +76,7 @@
 #include "netconf_rpc.h"
 
 /* Command line options to be passed to getopt(3) */
-#define NETCONF_OPTS "hVD:f:E:l:C:q01ca:u:d:p:y:U:t:eo:"
+#define NETCONF_OPTS "hVD:f:E:l:C:q01ca:u:d:p:y:U:t:eSo:"
 
 #define NETCONF_LOGFILE "/tmp/clixon_netconf.log"
 
@@ -91,6 +97,14 @@ static int ignore_packet_errors = 1;
 /* Hello request received */
 static int _netconf_hello_nr = 0;
 
+/*! Session parameters given on command-line, applied on each session in server mode */
+static int            _netconf_quiet = 0;
+static struct timeval _netconf_timeout = {0,};
+static int            _netconf_pseudo_user = 0;
+
+/*! Listen socket in netconf server mode, -1 in sessions and in single session mode */
+static int _netconf_server_sock = -1;
+
 /*! Copy attributes from incoming request to reply. Skip already present (dont overwrite)
  *
  * RFC 6241:
@@ -389,6 +403,243 @@ netconf_input_packet(clixon_handle h,
     return retval;
 }
 
+/*! Skip whitespace, XML declarations and comments
+ *
+ * @param[in]  str  String
+ * @param[in]  i    Start index
+ * @retval     i    Index of first other character
+ */
+static size_t
+netconf_envelope_skip(char  *str,
+                      size_t i)
+{
+    char *p;
+
+    while (str[i] != '\0'){
+        if (isspace(str[i]))
+            i++;
+        else if (strncmp(&str[i], "<?", 2) == 0){
+            if ((p = strstr(&str[i], "?>")) == NULL)
+                break;
+            i = p - str + 2;
+        }
+        else if (strncmp(&str[i], "<!--", 4) == 0){
+            if ((p = strstr(&str[i], "-->")) == NULL)
+                break;
+            i = p - str + 3;
+        }
+        else
+            break;
+    }
+    return i;
+}
+
+/*! Scan the envelope of a netconf message without parsing the whole message
+ *
+ * Only the <rpc> start tag and the name of the operation element are scanned
+ * @param[in]  str    Netconf message
+ * @param[out] attr0  Start index of <rpc> attributes
+ * @param[out] attr1  End index of <rpc> attributes, ie index of '>'
+ * @param[out] op     Start of operation name
+ * @param[out] oplen  Length of operation name
+ * @retval     1      OK, unprefixed <rpc> with unprefixed operation element
+ * @retval     0      Other message, or not recognized
+ */
+static int
+netconf_envelope_scan(char   *str,
+                      size_t *attr0,
+                      size_t *attr1,
+                      char  **op,
+                      size_t *oplen)
+{
+    size_t i;
+    size_t j;
+    char   q = '\0';
+
+    i = netconf_envelope_skip(str, 0);
+    if (strncmp(&str[i], "<rpc", 4) != 0 ||
+        !(isspace(str[i+4]) || str[i+4] == '>'))
+        return 0;
+    i += 4;
+    *attr0 = i;
+    for (; str[i] != '\0'; i++){
+        if (q){
+            if (str[i] == q)
+                q = '\0';
+        }
+        else if (str[i] == '"' || str[i] == '\'')
+            q = str[i];
+        else if (str[i] == '>')
+            break;
+    }
+    if (str[i] != '>' || str[i-1] == '/')
+        return 0;
+    *attr1 = i;
+    i = netconf_envelope_skip(str, i+1);
+    if (str[i] != '<')
+        return 0;
+    i++;
+    for (j = i; str[j] != '\0'; j++)
+        if (isspace(str[j]) || str[j] == '/' || str[j] == '>')
+            break;
+    if (j == i || !isalpha(str[i]) || memchr(&str[i], ':', j-i) != NULL)
+        return 0;
+    *op = &str[i];
+    *oplen = j - i;
+    return 1;
+}
+
+/*! Forward a netconf message to the backend without parsing it, if possible
+ *
+ * Only the envelope is scanned, ie the <rpc> start tag and the operation name.
+ * The original message is forwarded to the backend, where it is parsed and validated.
+ * Only operations that are forwarded unmodified to the backend are passed through,
+ * other messages are not handled and are parsed as usual.
+ * Netconf client plugins are not invoked for passed-through messages, ie their RPC callbacks
+ * and any extensions of client-side parsing and validation
+ * @param[in]   h     Clixon handle
+ * @param[in]   cbmsg Complete netconf message (without framing)
+ * @retval      1     Handled, reply sent
+ * @retval      0     Not handled, parse message as usual
+ * @retval     -1     Error
+ * @see CLICON_NETCONF_PASSTHROUGH
+ * @see netconf_rpc_dispatch
+ */
+static int
+netconf_input_passthrough(clixon_handle h,
+                          cbuf         *cbmsg)
+{
+    int                  retval = -1;
+    char                *str;
+    size_t               attr0;
+    size_t               attr1;
+    char                *op;
+    size_t               oplen;
+    char                *opname = NULL;
+    char                *username;
+    char                *encstr = NULL;
+    char                *ns = NULL;
+    cbuf                *cb = NULL;
+    cxobj               *xtop = NULL;
+    cxobj               *xrpc;
+    cxobj               *xa;
+    cxobj               *xret = NULL;
+    cxobj               *xreply;
+    cxobj               *xerr = NULL;
+    netconf_framing_type framing;
+    int                  ret;
+
+    if (_netconf_hello_nr == 0 &&
+        clicon_option_bool(h, "CLICON_NETCONF_HELLO_OPTIONAL") == 0)
+        goto fail;
+    str = cbuf_get(cbmsg);
+    if (netconf_envelope_scan(str, &attr0, &attr1, &op, &oplen) == 0)
+        goto fail;
+    if ((opname = strndup(op, oplen)) == NULL){
+        clixon_err(OE_UNIX, errno, "strndup");
+        goto done;
+    }
+    if (strcmp(opname, "edit-config") == 0){
+        /* test- and error-options are checked in the netconf client */
+        if (strstr(op, "test-option") != NULL || strstr(op, "error-option") != NULL)
+            goto fail;
+    }
+    else if (strcmp(opname, "copy-config") != 0 &&
+             strcmp(opname, "delete-config") != 0 &&
+             strcmp(opname, "lock") != 0 &&
+             strcmp(opname, "unlock") != 0 &&
+             strcmp(opname, "validate") != 0 &&
+             strcmp(opname, "commit") != 0 &&
+             strcmp(opname, "cancel-commit") != 0 &&
+             strcmp(opname, "discard-changes") != 0)
+        goto fail;
+    /* Parse the <rpc> start tag only, for namespace check and reply attributes */
+    if ((cb = cbuf_new()) == NULL){
+        clixon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "<rpc%.*s/>", (int)(attr1-attr0), &str[attr0]);
+    if ((ret = clixon_xml_parse_string(cbuf_get(cb), YB_NONE, NULL, &xtop, NULL)) < 0){
+        clixon_err_reset();
+        goto fail;
+    }
+    if (ret == 0 || (xrpc = xml_child_i_type(xtop, 0, CX_ELMNT)) == NULL)
+        goto fail;
+    if (xml2ns(xrpc, NULL, &ns) < 0)
+        goto done;
+    if (ns == NULL || strcmp(ns, NETCONF_BASE_NAMESPACE) != 0)
+        goto fail;
+    /* Internal clixon-lib attributes, such as username, are set by the netconf client only */
+    xa = NULL;
+    while ((xa = xml_child_each(xrpc, xa, CX_ATTR)) != NULL)
+        if (strcmp(xml_name(xa), CLIXON_LIB_PREFIX) == 0 ||
+            strcmp(xml_value(xa), CLIXON_LIB_NS) == 0)
+            goto fail;
+    /* Tag username, see netconf_rpc_dispatch */
+    cbuf_reset(cb);
+    cprintf(cb, "<rpc");
+    if ((username = clicon_username_get(h)) != NULL){
+        if (strchr(username, '"') != NULL) /* Not encoded in attribute value */
+            goto fail;
+        if (xml_chardata_encode(&encstr, "%s", username) < 0)
+            goto done;
+        cprintf(cb, " %s:username=\"%s\"", CLIXON_LIB_PREFIX, encstr);
+        cprintf(cb, " xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    }
+    cprintf(cb, "%s", &str[attr0]);
+    clixon_debug(CLIXON_DBG_NETCONF, "passthrough %s", opname);
+    if (clicon_rpc_netconf(h, cbuf_get(cb), &xret, NULL) < 0)
+        goto done;
+    if ((xreply = xml_find_type(xret, NULL, "rpc-reply", CX_ELMNT)) == NULL){
+        if (netconf_operation_failed_xml(&xerr, "rpc", "Internal error: no xml return")< 0)
+            goto done;
+        xml_free(xret);
+        xret = xerr;
+        xerr = NULL;
+        xreply = xret;
+    }
+    else if (xml_find_type(xreply, NULL, "rpc-error", CX_ELMNT) == NULL){
+        if ((ret = xml_bind_yang_rpc_reply(h, xreply, opname, clicon_dbspec_yang(h), &xerr)) < 0)
+            goto done;
+        if (ret == 0){
+            xml_purge(xreply);
+            if (xml_addsub(xret, xerr) < 0)
+                goto done;
+            xreply = xerr;
+            xerr = NULL;
+        }
+    }
+    /* Copy attributes from incoming request to reply. Skip already present (dont overwrite) */
+    if (netconf_add_request_attr(xrpc, xreply) < 0)
+        goto done;
+    cbuf_reset(cb);
+    if (clixon_xml2cbuf(cb, xreply, 0, 0, NULL, -1, 0) < 0)
+        goto done;
+    framing = clicon_data_int_get(h, NETCONF_FRAMING_TYPE);
+    if (netconf_output_encap(framing, cb) < 0)
+        goto done;
+    if (netconf_output(1, cb, "rpc-reply") < 0)
+        goto done;
+    retval = 1;
+ done:
+    if (opname)
+        free(opname);
+    if (encstr)
+        free(encstr);
+    if (cb)
+        cbuf_free(cb);
+    if (xtop)
+        xml_free(xtop);
+    if (xret)
+        xml_free(xret);
+    if (xerr)
+        xml_free(xerr);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
 /*! Get netconf message: detect end-of-msg 
  *
  * @param[in]  s    Socket where input arrived. read from this.
@@ -430,8 +681,10 @@ netconf_input_cb(int   s,
     unsigned char *p = buf;
     ssize_t        len;
     size_t         plen;
+    int            passthrough;
 
     yspec = clicon_dbspec_yang(h);
+    passthrough = clicon_option_bool(h, "CLICON_NETCONF_PASSTHROUGH");
     /* Get unfinished frame */
     if ((ptr = clicon_hash_value(cdat, NETCONF_FRAME_MSG, &cdatlen)) != NULL){
         if (cdatlen != sizeof(cbmsg)){
@@ -477,6 +730,14 @@ netconf_input_cb(int   s,
             break;
         }
         clixon_debug(CLIXON_DBG_MSG, "Recv ext: %s", cbuf_get(cbmsg));
+        if (passthrough){
+            if ((ret = netconf_input_passthrough(h, cbmsg)) < 0)
+                goto done;
+            if (ret == 1){
+                cbuf_reset(cbmsg);
+                continue;
+            }
+        }
         if ((ret = netconf_input_frame2(cbmsg, YB_RPC, yspec, &xtop, &xerr)) < 0)
             goto done;
         cbuf_reset(cbmsg);
@@ -567,6 +828,239 @@ send_hello(clixon_handle h,
     return retval;
 }
 
+static int
+timeout_fn(int s,
+           void *arg)
+{
+    clixon_err(OE_EVENTS, ETIMEDOUT, "User request timeout");
+    return -1;
+}
+
+/*! Start a netconf session on stdin/stdout
+ *
+ * Get a session-id from the backend, send hello and register input and timeout
+ * @param[in]   h   Clixon handle
+ * @retval      0   OK
+ * @retval     -1   Error
+ */
+static int
+netconf_session_start(clixon_handle h)
+{
+    int            retval = -1;
+    uint32_t       id;
+    struct timeval t;
+
+    /* Send hello request to backend to get session-id back
+     * This is done once at the beginning of the session and then this is
+     * used by the client, even though new TCP sessions are created for
+     * each message sent to the backend.
+     */
+    if (clicon_hello_req(h, "cl:netconf", NULL, &id) < 0)
+        goto done;
+    clicon_session_id_set(h, id);
+
+    /* Send hello to northbound client 
+     * Note that this is a violation of RDFC 6241 Sec 8.1:
+     * When the NETCONF session is opened, each peer(both client and server) MUST send a <hello..
+     */
+    if (!_netconf_quiet){
+        if (send_hello(h, 1, id) < 0)
+            goto done;
+    }
+#ifdef __AFL_HAVE_MANUAL_CONTROL
+    /* American fuzzy loop deferred init, see CLICON_NETCONF_HELLO_OPTIONAL=true, see a speedup of x10 */
+    __AFL_INIT();
+#endif
+    if (clixon_event_reg_fd(0, netconf_input_cb, h, "netconf socket") < 0)
+        goto done;
+    if (timerisset(&_netconf_timeout)){
+        gettimeofday(&t, NULL);
+        timeradd(&t, &_netconf_timeout, &t);
+        if (clixon_event_reg_timeout(t, timeout_fn, NULL, "timeout") < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Accept a new netconf session in server mode
+ *
+ * Fork a session process which inherits the already loaded yang specs and plugins.
+ * The session process replaces stdin/stdout with the accepted socket, stops listening
+ * and continues in the same event loop serving the session only.
+ * The username of the session is the peer credential of the socket unless -U is given.
+ * Accept and fork failures are logged and the session dropped, the server continues
+ * serving other sessions.
+ * @param[in]   ss   Server socket
+ * @param[in]   arg  Clixon handle
+ * @retval      0    OK
+ * @retval     -1   Error
+ */
+static int
+netconf_server_accept(int   ss,
+                      void *arg)
+{
+    int             retval = -1;
+    clixon_handle   h = (clixon_handle)arg;
+    int             s = -1;
+    struct sockaddr from;
+    socklen_t       len;
+    pid_t           pid;
+    char           *name = NULL;
+#ifdef HAVE_SO_PEERCRED        /* Linux. */
+    socklen_t       clen;
+    struct ucred    cr = {0,};
+#elif defined(HAVE_GETPEEREID) /* FreeBSD */
+    uid_t           euid;
+    uid_t           guid;
+#endif
+
+    clixon_debug(CLIXON_DBG_NETCONF, "");
+    len = sizeof(from);
+    if ((s = accept(ss, &from, &len)) < 0){
+        /* Eg EMFILE or ECONNABORTED: log and keep serving */
+        clixon_err(OE_UNIX, errno, "accept");
+        goto ok;
+    }
+    fflush(stdout);
+    if ((pid = fork()) < 0){
+        /* Eg EAGAIN: log, close the session socket and keep serving */
+        clixon_err(OE_UNIX, errno, "fork");
+        goto ok;
+    }
+    if (pid != 0){ /* Server: continue listening */
+        clixon_debug(CLIXON_DBG_NETCONF, "session pid:%d", pid);
+        goto ok;
+    }
+    /* Session process */
+    clixon_event_unreg_fd(ss, netconf_server_accept);
+    close(ss);
+    _netconf_server_sock = -1;
+    /* Do not share any backend socket opened by the server, eg by plugins */
+    if (clicon_client_socket_get(h) >= 0){
+        close(clicon_client_socket_get(h));
+        clicon_client_socket_set(h, -1);
+    }
+    if (set_signal(SIGCHLD, SIG_DFL, NULL) < 0){
+        clixon_err(OE_UNIX, errno, "Setting SIGCHLD signal");
+        goto done;
+    }
+    if (!_netconf_pseudo_user){
+#if defined(HAVE_SO_PEERCRED)
+        clen =  sizeof(cr);
+        if (getsockopt(s, SOL_SOCKET, SO_PEERCRED, &cr, &clen) < 0){
+            clixon_err(OE_UNIX, errno, "getsockopt");
+            goto done;
+        }
+        if (uid2name(cr.uid, &name) < 0)
+            goto done;
+#elif defined(HAVE_GETPEEREID)
+        if (getpeereid(s, &euid, &guid) < 0){
+            clixon_err(OE_UNIX, errno, "getpeereid");
+            goto done;
+        }
+        if (uid2name(euid, &name) < 0)
+            goto done;
+#else
+#error "Need getsockopt O_PEERCRED or getpeereid for unix socket peer cred"
+#endif
+        if (name == NULL){
+            clixon_err(OE_UNIX, 0, "No user name of netconf session peer");
+            goto done;
+        }
+        if (clicon_username_set(h, name) < 0)
+            goto done;
+    }
+    if (dup2(s, 0) < 0 || dup2(s, 1) < 0){
+        clixon_err(OE_UNIX, errno, "dup2");
+        goto done;
+    }
+    if (netconf_session_start(h) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    if (s != -1)
+        close(s);
+    if (name)
+        free(name);
+    return retval;
+}
+
+/*! Open netconf server UNIX socket and register accept callback
+ *
+ * The socket is accessed via CLICON_NETCONF_SERVER_SOCK option, and has group according
+ * to CLICON_SOCK_GROUP option. An SSH netconf subsystem relays to this socket.
+ * @param[in]   h   Clixon handle
+ * @retval      0   OK
+ * @retval     -1   Error
+ */
+static int
+netconf_server_init(clixon_handle h)
+{
+    int                retval = -1;
+    int                s = -1;
+    char              *sock;
+    char              *group;
+    gid_t              gid;
+    struct sockaddr_un addr;
+    mode_t             old_mask;
+    struct stat        st;
+
+    if ((sock = clicon_option_str(h, "CLICON_NETCONF_SERVER_SOCK")) == NULL){
+        clixon_err(OE_CFG, 0, "CLICON_NETCONF_SERVER_SOCK option not set");
+        goto done;
+    }
+    if ((group = clicon_sock_group(h)) == NULL){
+        clixon_err(OE_CFG, 0, "CLICON_SOCK_GROUP option not set");
+        goto done;
+    }
+    if (group_name2gid(group, &gid) < 0)
+        goto done;
+    if (lstat(sock, &st) == 0 && unlink(sock) < 0){
+        clixon_err(OE_UNIX, errno, "unlink(%s)", sock);
+        goto done;
+    }
+    if ((s = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        clixon_err(OE_UNIX, errno, "socket");
+        goto done;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, sock, sizeof(addr.sun_path)-1);
+    old_mask = umask(S_IRWXO | S_IXGRP | S_IXUSR);
+    if (bind(s, (struct sockaddr *)&addr, SUN_LEN(&addr)) < 0){
+        clixon_err(OE_UNIX, errno, "bind");
+        umask(old_mask);
+        goto done;
+    }
+    umask(old_mask);
+    if (lchown(sock, -1, gid) < 0){
+        clixon_err(OE_UNIX, errno, "lchown(%s, %s)", sock, group);
+        goto done;
+    }
+    if (listen(s, SOMAXCONN) < 0){
+        clixon_err(OE_UNIX, errno, "listen");
+        goto done;
+    }
+    /* Reap session processes */
+    if (set_signal(SIGCHLD, SIG_IGN, NULL) < 0){
+        clixon_err(OE_UNIX, errno, "Setting SIGCHLD signal");
+        goto done;
+    }
+    if (clixon_event_reg_fd(s, netconf_server_accept, h, "netconf server socket") < 0)
+        goto done;
+    clixon_debug(CLIXON_DBG_NETCONF, "Listen on netconf server socket at %s", sock);
+    _netconf_server_sock = s;
+    s = -1;
+    retval = 0;
+ done:
+    if (s != -1)
+        close(s);
+    return retval;
+}
+
 /*! Clean and close all state of netconf process (but dont exit). 
  *
  * Cannot use h after this 
@@ -578,12 +1072,19 @@ netconf_terminate(clixon_handle h)
     yang_stmt  *yspec;
     cvec       *nsctx;
     cxobj      *x;
+    char       *sock;
 
     if (clixon_exit_get() == 0)
         clixon_exit_set(1);
     /* Delete all plugins, and RPC callbacks */
     clixon_plugin_module_exit(h);
-    clicon_rpc_close_session(h);
+    if (_netconf_server_sock != -1){ /* Server mode: no session of its own */
+        close(_netconf_server_sock);
+        if ((sock = clicon_option_str(h, "CLICON_NETCONF_SERVER_SOCK")) != NULL)
+            unlink(sock);
+    }
+    else
+        clicon_rpc_close_session(h);
     if ((yspec = clicon_dbspec_yang(h)) != NULL)
         ys_free(yspec);
     if ((yspec = clicon_config_yang(h)) != NULL)
@@ -616,14 +1117,6 @@ netconf_signal_init (clixon_handle h)
     return retval;
 }
 
-static int
-timeout_fn(int s,
-           void *arg)
-{
-    clixon_err(OE_EVENTS, ETIMEDOUT, "User request timeout");
-    return -1;
-}
-
 /*! Usage help routine
  *
  * @param[in]  h      Clixon handle
@@ -653,6 +1146,7 @@ usage(clixon_handle h,
             "\t-U <user>\tOver-ride unix user with a pseudo user for NACM.\n"
             "\t-t <sec>\tTimeout in seconds. Quit after this time.\n"
             "\t-e \t\tDont ignore errors on packet input.\n"
+            "\t-S \t\tServer mode: serve sessions on CLICON_NETCONF_SERVER_SOCK\n"
             "\t-o \"<option>=<value>\"\tGive configuration option overriding config file (see clixon-config.yang)\n",
             argv0,
             clicon_netconf_dir(h)
@@ -670,15 +1164,13 @@ main(int    argc,
     int              retval = -1;
     int              c;
     char            *argv0 = argv[0];
-    int              quiet = 0;
     clixon_handle    h;
     char            *dir;
     int              logdst = CLIXON_LOG_SYSLOG;
     struct passwd   *pw;
-    struct timeval   tv = {0,}; /* timeout */
     yang_stmt       *yspec = NULL;
     char            *str;
-    uint32_t         id;
+    int              server = 0;
     cvec            *nsctx_global = NULL; /* Global namespace context */
     size_t           cligen_buflen;
     size_t           cligen_bufthreshold;
@@ -773,7 +1265,7 @@ main(int    argc,
             config_dump++;
             break;
         case 'q':  /* quiet: dont write hello */
-            quiet++;
+            _netconf_quiet++;
             break;
         case 'a': /* internal backend socket address family */
             clicon_option_str_set(h, "CLICON_SOCK_FAMILY", optarg);
@@ -802,13 +1294,17 @@ main(int    argc,
                 usage(h, argv[0]);
             if (clicon_username_set(h, optarg) < 0)
                 goto done;
+            _netconf_pseudo_user++;
             break;
         case 't': /* timeout in seconds */
-            tv.tv_sec = atoi(optarg);
+            _netconf_timeout.tv_sec = atoi(optarg);
             break;
         case 'e': /* dont ignore packet errors */
             ignore_packet_errors = 0;
             break;
+        case 'S': /* Server mode */
+            server++;
+            break;
         case '0': /* Force EOM */
             clicon_option_int_set(h, "CLICON_NETCONF_BASE_CAPABILITY", 0);
             clicon_option_bool_set(h, "CLICON_NETCONF_HELLO_OPTIONAL", 1);
@@ -925,36 +1421,13 @@ main(int    argc,
     /* Debug dump of config options */
     clicon_option_dump(h, CLIXON_DBG_INIT);
 
-    /* Send hello request to backend to get session-id back
-     * This is done once at the beginning of the session and then this is
-     * used by the client, even though new TCP sessions are created for
-     * each message sent to the backend.
-     */
-    if (clicon_hello_req(h, "cl:netconf", NULL, &id) < 0)
-        goto done;
-    clicon_session_id_set(h, id);
-
-    /* Send hello to northbound client 
-     * Note that this is a violation of RDFC 6241 Sec 8.1:
-     * When the NETCONF session is opened, each peer(both client and server) MUST send a <hello..
-     */
-    if (!quiet){
-        if (send_hello(h, 1, id) < 0)
+    if (server){
+        /* Sessions are started in forked processes sharing yang and plugins loaded above */
+        if (netconf_server_init(h) < 0)
             goto done;
     }
-#ifdef __AFL_HAVE_MANUAL_CONTROL
-    /* American fuzzy loop deferred init, see CLICON_NETCONF_HELLO_OPTIONAL=true, see a speedup of x10 */
-    __AFL_INIT();
-#endif
-    if (clixon_event_reg_fd(0, netconf_input_cb, h, "netconf socket") < 0)
+    else if (netconf_session_start(h) < 0)
         goto done;
-    if (tv.tv_sec || tv.tv_usec){
-        struct timeval t;
-        gettimeofday(&t, NULL);
-        timeradd(&t, &tv, &t);
-        if (clixon_event_reg_timeout(t, timeout_fn, NULL, "timeout") < 0)
-            goto done;
-    }
     if (clixon_event_loop(h) < 0)
         goto done;
  ok:
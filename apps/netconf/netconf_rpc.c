@@ -180,7 +180,7 @@ netconf_get_config(clixon_handle h,
     if ((xfilter = xpath_first(xn, nsc, "%s%sfilter", prefix ? prefix : "", prefix ? ":" : "")) != NULL)
         ftype = xml_find_value(xfilter, "type");
     if (xfilter == NULL || ftype == NULL || strcmp(ftype, "subtree") == 0) {
-        /* Get whole config first, then filter. This is suboptimal
+        /* The backend selects a superset of the subtree filter, then filter exactly
          */
         if (clicon_rpc_netconf_xml(h, xml_parent(xn), xret, NULL) < 0)
             goto done;
@@ -393,7 +393,7 @@ netconf_get(clixon_handle h,
     if ((xfilter = xpath_first(xn, nsc, "%s%sfilter", prefix ? prefix : "", prefix ? ":" : "")) != NULL)
         ftype = xml_find_value(xfilter, "type");
     if (xfilter == NULL || ftype == NULL || strcmp(ftype, "subtree") == 0) {
-        /* Get whole config + state first, then filter. This is suboptimal
+        /* The backend selects a superset of the subtree filter, then filter exactly
          */
         if (clicon_rpc_netconf_xml(h, xml_parent(xn), xret, NULL) < 0)
             goto done;
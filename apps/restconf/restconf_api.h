@@ -48,4 +48,9 @@ int restconf_reply_send(void *req, int code, cbuf *cb, int head);
 
 cbuf *restconf_get_indata(void *req);
 
+/* Streamed replies, not supported by all transports, see restconf_reply_stream_start */
+int restconf_reply_stream_start(void *req, int code);
+int restconf_reply_stream_data(void *req, cbuf *cb);
+int restconf_reply_stream_end(void *req);
+
 #endif /* _RESTCONF_API_H_ */
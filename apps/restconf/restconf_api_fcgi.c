@@ -250,3 +250,66 @@ restconf_get_indata(void *req0)
         cprintf(cb, "%c", c);
     return cb;
 }
+
+/*! Start a streamed HTTP reply, send status and headers
+ *
+ * FastCGI output is a stream to the reverse proxy which handles framing towards the
+ * client, so the body is written as it is produced.
+ * @param[in]  req   Fastcgi request handle
+ * @param[in]  code  Status code
+ * @retval     1     OK, streaming started, continue with restconf_reply_stream_data
+ * @retval     0     Streaming not supported, use restconf_reply_send
+ * @retval    -1     Error
+ */
+int
+restconf_reply_stream_start(void *req0,
+                            int   code)
+{
+    FCGX_Request *req = (FCGX_Request *)req0;
+    int           retval = -1;
+    const char   *reason_phrase;
+
+    FCGX_SetExitStatus(code, req->out);
+    if ((reason_phrase = restconf_code2reason(code)) == NULL)
+        reason_phrase="";
+    if (restconf_reply_header(req, "Status", "%d %s", code, reason_phrase) < 0)
+        goto done;
+    FCGX_FPrintF(req->out, "\r\n");
+    retval = 1;
+ done:
+    return retval;
+}
+
+/*! Send a part of a streamed HTTP reply body
+ *
+ * @param[in]  req   Fastcgi request handle
+ * @param[in]  cb    Body data, is sent and then reset
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+int
+restconf_reply_stream_data(void *req0,
+                           cbuf *cb)
+{
+    FCGX_Request *req = (FCGX_Request *)req0;
+
+    if (cbuf_len(cb))
+        FCGX_PutStr(cbuf_get(cb), cbuf_len(cb), req->out);
+    cbuf_reset(cb);
+    return 0;
+}
+
+/*! End a streamed HTTP reply
+ *
+ * @param[in]  req   Fastcgi request handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+int
+restconf_reply_stream_end(void *req0)
+{
+    FCGX_Request *req = (FCGX_Request *)req0;
+
+    FCGX_FFlush(req->out);
+    return 0;
+}
@@ -42,7 +42,9 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <errno.h>
 #include <string.h>
 #include <signal.h>
 #include <sys/socket.h>
@@ -191,3 +193,132 @@ restconf_get_indata(void *req0)
     return cb;
 }
 
+/*! Start a streamed HTTP reply, send status and headers
+ *
+ * Only HTTP/1.1 is streamed using chunked transfer-encoding. HTTP/1.0 has no chunked
+ * encoding, and HTTP/2 frames can not be sent from within the nghttp2 receive callback
+ * where requests are processed, so in those cases the caller should buffer the body
+ * and use restconf_reply_send as usual.
+ * @param[in]  req   http request handle
+ * @param[in]  code  Status code
+ * @retval     1     OK, streaming started, continue with restconf_reply_stream_data
+ * @retval     0     Streaming not supported, use restconf_reply_send
+ * @retval    -1     Error
+ * @see restconf_reply_stream_data
+ * @see restconf_reply_stream_end
+ */
+int
+restconf_reply_stream_start(void *req0,
+                            int   code)
+{
+    int                   retval = -1;
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+    restconf_conn        *rc;
+    cg_var               *cv;
+    int                   ret;
+
+    clixon_debug(CLIXON_DBG_RESTCONF, "code:%d", code);
+    if (sd == NULL || (rc = sd->sd_conn) == NULL){
+        clixon_err(OE_CFG, EINVAL, "sd or rc is NULL");
+        goto done;
+    }
+    if (rc->rc_proto != HTTP_11){
+        retval = 0;
+        goto done;
+    }
+    sd->sd_code = code;
+    if (restconf_reply_header(sd, "Transfer-Encoding", "chunked") < 0)
+        goto done;
+    cprintf(sd->sd_outp_buf, "HTTP/%u.%u %u %s\r\n",
+            rc->rc_proto_d1,
+            rc->rc_proto_d2,
+            sd->sd_code,
+            restconf_code2reason(sd->sd_code));
+    cv = NULL;
+    while ((cv = cvec_each(sd->sd_outp_hdrs, cv)) != NULL)
+        cprintf(sd->sd_outp_buf, "%s: %s\r\n", cv_name_get(cv), cv_string_get(cv));
+    cprintf(sd->sd_outp_buf, "\r\n");
+    if ((ret = native_buf_write(rc->rc_h, cbuf_get(sd->sd_outp_buf), cbuf_len(sd->sd_outp_buf),
+                                rc, __FUNCTION__)) < 0)
+        goto done;
+    if (ret == 0)
+        rc->rc_exit = 1;
+    cvec_reset(sd->sd_outp_hdrs);
+    cbuf_reset(sd->sd_outp_buf);
+    sd->sd_streamed = 1;
+    retval = 1;
+ done:
+    return retval;
+}
+
+/*! Send a part of a streamed HTTP reply body as one chunk
+ *
+ * @param[in]  req   http request handle
+ * @param[in]  cb    Body data, is sent and then reset
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see restconf_reply_stream_start
+ */
+int
+restconf_reply_stream_data(void *req0,
+                           cbuf *cb)
+{
+    int                   retval = -1;
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+    restconf_conn        *rc;
+    char                  chunkhdr[24];
+    int                   ret;
+
+    if (sd == NULL || (rc = sd->sd_conn) == NULL || !sd->sd_streamed){
+        clixon_err(OE_CFG, EINVAL, "sd or rc is NULL or stream not started");
+        goto done;
+    }
+    if (cbuf_len(cb) == 0 || rc->rc_exit) /* Nothing to send or peer closed */
+        goto ok;
+    snprintf(chunkhdr, sizeof(chunkhdr), "%zx\r\n", cbuf_len(cb));
+    if ((ret = native_buf_write(rc->rc_h, chunkhdr, strlen(chunkhdr), rc, __FUNCTION__)) < 0)
+        goto done;
+    if (ret == 1 &&
+        (ret = native_buf_write(rc->rc_h, cbuf_get(cb), cbuf_len(cb), rc, __FUNCTION__)) < 0)
+        goto done;
+    if (ret == 1 &&
+        (ret = native_buf_write(rc->rc_h, "\r\n", 2, rc, __FUNCTION__)) < 0)
+        goto done;
+    if (ret == 0)
+        rc->rc_exit = 1;
+ ok:
+    cbuf_reset(cb);
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! End a streamed HTTP reply by sending the last (empty) chunk
+ *
+ * @param[in]  req   http request handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see restconf_reply_stream_start
+ */
+int
+restconf_reply_stream_end(void *req0)
+{
+    int                   retval = -1;
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+    restconf_conn        *rc;
+    int                   ret;
+
+    if (sd == NULL || (rc = sd->sd_conn) == NULL || !sd->sd_streamed){
+        clixon_err(OE_CFG, EINVAL, "sd or rc is NULL or stream not started");
+        goto done;
+    }
+    if (!rc->rc_exit){
+        if ((ret = native_buf_write(rc->rc_h, "0\r\n\r\n", 5, rc, __FUNCTION__)) < 0)
+            goto done;
+        if (ret == 0)
+            rc->rc_exit = 1;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
@@ -458,7 +458,7 @@ restconf_http1_path_root(clixon_handle  h,
 #ifdef HAVE_LIBNGHTTP2
  upgrade:
 #endif
-    if (sd->sd_code)
+    if (sd->sd_code && !sd->sd_streamed) /* Streamed reply is already sent */
         if (restconf_http1_reply(rc, sd) < 0)
             goto done;
     retval = 0;
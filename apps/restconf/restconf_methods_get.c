@@ -63,9 +63,50 @@
 #include "restconf_err.h"
 #include "restconf_methods_get.h"
 
+/* State of a GET reply which may be streamed, see api_data_get_flush
+ */
+typedef struct {
+    void  *gs_req;       /* Generic www handle */
+    size_t gs_threshold; /* Start streaming when encoded output reaches this size */
+    int    gs_state;     /* 0: buffering, 1: streaming, 2: streaming not supported */
+} get_stream;
+
 /* Forward */
 static int api_data_pagination(clixon_handle h, void *req, char *api_path, int pi, cvec *qvec, int pretty, restconf_media media_out);
 
+/*! Encoder flush callback: stream reply body in chunks once it is large enough
+ *
+ * The first time the encoded output exceeds the threshold, status and headers are
+ * sent and the transport switches to streaming, eg HTTP/1.1 chunked encoding.
+ * Thereafter each call sends what has been encoded so far and resets the buffer.
+ * If the transport does not support streaming, the reply is buffered as usual.
+ * @param[in]  cb   Encoded output so far
+ * @param[in]  arg  GET stream state
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @see CLICON_RESTCONF_STREAM_THRESHOLD
+ */
+static int
+api_data_get_flush(cbuf *cb,
+                   void *arg)
+{
+    get_stream *gs = (get_stream *)arg;
+    int         ret;
+
+    if (gs->gs_state == 2 || cbuf_len(cb) < gs->gs_threshold)
+        return 0;
+    if (gs->gs_state == 0){
+        if ((ret = restconf_reply_stream_start(gs->gs_req, 200)) < 0)
+            return -1;
+        if (ret == 0){
+            gs->gs_state = 2;
+            return 0;
+        }
+        gs->gs_state = 1;
+    }
+    return restconf_reply_stream_data(gs->gs_req, cb);
+}
+
 /*! Generic GET (both HEAD and GET)
  * According to restconf 
  * @param[in]  h        Clixon handle
@@ -95,6 +136,7 @@ static int api_data_pagination(clixon_handle h, void *req, char *api_path, int p
  * "400 Bad Request" status-line MUST be returned by the server.
  * Netconf: <get-config>, <get>                        
  * @note there is an ad-hoc method to determine json pagination request instead of regular GET
+ * @note If CLICON_RESTCONF_STREAM_THRESHOLD is set, large replies are streamed while encoded
  */
 static int
 api_data_get2(clixon_handle  h,
@@ -127,6 +169,9 @@ api_data_get2(clixon_handle  h,
     yang_stmt *y = NULL;
     char      *defaults = NULL;
     cvec      *nscd = NULL;
+    get_stream gs = {req, 0, 0};
+    clixon_cbuf_flush_cb *fn = NULL;
+    int        threshold;
 
     clixon_debug(CLIXON_DBG_RESTCONF, "");
     if ((yspec = clicon_dbspec_yang(h)) == NULL){
@@ -225,26 +270,7 @@ api_data_get2(clixon_handle  h,
             goto done;
         goto ok;
     }
-    /* Normal return, no error */
-    if ((cbx = cbuf_new()) == NULL){
-        clixon_err(OE_UNIX, errno, "cbuf_new");
-        goto done;
-    }
-    if (xpath==NULL || strcmp(xpath,"/")==0){ /* Special case: data root */
-        switch (media_out){
-        case YANG_DATA_XML:
-            if (clixon_xml2cbuf(cbx, xret, 0, pretty, NULL, -1, 0) < 0) /* Dont print top object?  */
-                goto done;
-            break;
-        case YANG_DATA_JSON:
-            if (clixon_json2cbuf(cbx, xret, pretty, 0, 0) < 0)
-                goto done;
-            break;
-        default:
-            break;
-        }
-    }
-    else{
+    if (xpath != NULL && strcmp(xpath, "/") != 0){
         if (xpath_vec(xret, nsc, "%s", &xvec, &xlen, xpath) < 0){
             if (netconf_operation_failed_xml(&xerr, "application", clixon_err_reason()) < 0)
                 goto done;
@@ -265,6 +291,35 @@ api_data_get2(clixon_handle  h,
                 goto done;
             goto ok;
         }
+    }
+    /* Normal return, no error */
+    if (restconf_reply_header(req, "Content-Type", "%s", restconf_media_int2str(media_out)) < 0)
+        goto done;
+    if (restconf_reply_header(req, "Cache-Control", "no-cache") < 0)
+        goto done;
+    if (!head && (threshold = clicon_option_int(h, "CLICON_RESTCONF_STREAM_THRESHOLD")) > 0){
+        gs.gs_threshold = threshold;
+        fn = api_data_get_flush;
+    }
+    if ((cbx = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (xpath==NULL || strcmp(xpath,"/")==0){ /* Special case: data root */
+        switch (media_out){
+        case YANG_DATA_XML:
+            if (clixon_xml2cbuf_flush(cbx, xret, 0, pretty, NULL, -1, 0, 0, fn, &gs) < 0) /* Dont print top object?  */
+                goto done;
+            break;
+        case YANG_DATA_JSON:
+            if (clixon_json2cbuf_flush(cbx, xret, pretty, 0, 0, fn, &gs) < 0)
+                goto done;
+            break;
+        default:
+            break;
+        }
+    }
+    else{
         switch (media_out){
         case YANG_DATA_XML:
             for (i=0; i<xlen; i++){
@@ -277,7 +332,9 @@ api_data_get2(clixon_handle  h,
                     cvec_free(nscd);
                     nscd = NULL;
                 }
-                if (clixon_xml2cbuf(cbx, x, 0, pretty, NULL, -1, 0) < 0) /* Dont print top object?  */
+                if (clixon_xml2cbuf_flush(cbx, x, 0, pretty, NULL, -1, 0, 0, fn, &gs) < 0) /* Dont print top object?  */
+                    goto done;
+                if (fn && (*fn)(cbx, &gs) < 0)
                     goto done;
             }
             break;
@@ -285,18 +342,21 @@ api_data_get2(clixon_handle  h,
             /* In: <x xmlns="urn:example:clixon">0</x>
              * Out: {"example:x": {"0"}}
              */
-            if (xml2json_cbuf_vec(cbx, xvec, xlen, pretty, 0) < 0)
+            if (xml2json_cbuf_vec_flush(cbx, xvec, xlen, pretty, 0, fn, &gs) < 0)
                 goto done;
             break;
         default:
             break;
         }
     }
+    if (gs.gs_state == 1){ /* Streamed: send remainder and end */
+        if (restconf_reply_stream_data(req, cbx) < 0)
+            goto done;
+        if (restconf_reply_stream_end(req) < 0)
+            goto done;
+        goto ok;
+    }
     clixon_debug(CLIXON_DBG_RESTCONF, "cbuf:%s", cbuf_get(cbx));
-    if (restconf_reply_header(req, "Content-Type", "%s", restconf_media_int2str(media_out)) < 0)
-        goto done;
-    if (restconf_reply_header(req, "Cache-Control", "no-cache") < 0)
-        goto done;
     if (restconf_reply_send(req, 200, cbx, head) < 0)
         goto done;
     cbx = NULL;
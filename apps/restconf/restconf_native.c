@@ -391,7 +391,7 @@ restconf_connection_sanity(clixon_handle         h,
  * @retval  0  OK, but socket write returned error, caller should close rc
  * @retval -1  Error
  */
-static int
+int
 native_buf_write(clixon_handle    h,
                  char            *buf,
                  size_t           buflen,
@@ -785,6 +785,7 @@ restconf_http1_process(restconf_conn *rc,
         goto done;
     cvec_reset(sd->sd_outp_hdrs); /* Can be done in native_send_reply */
     cbuf_reset(sd->sd_outp_buf);
+    sd->sd_streamed = 0;
     cbuf_reset(sd->sd_inbuf);
     cbuf_reset(sd->sd_indata);
     if (sd->sd_body)
@@ -92,6 +92,7 @@ typedef struct  {
     void                 *sd_req;       /* Lib-specific request */
     int                   sd_upgrade2;  /* Upgrade to http/2 */
     uint8_t              *sd_settings2; /* Settings for upgrade to http/2 request */
+    int                   sd_streamed;  /* Reply already sent using chunked encoding */
 } restconf_stream_data;
 
 typedef struct restconf_socket restconf_socket;
@@ -176,6 +177,8 @@ restconf_stream_data *restconf_stream_find(restconf_conn *rc, int32_t id);
 int               restconf_stream_free(restconf_stream_data *sd);
 restconf_conn    *restconf_conn_new(clixon_handle h, int s, restconf_socket *socket);
 int               ssl_x509_name_oneline(SSL *ssl, char **oneline);
+int               native_buf_write(clixon_handle h, char *buf, size_t buflen,
+                                   restconf_conn *rc, const char *callfn);
 
 int               restconf_close_ssl_socket(restconf_conn *rc, const char *callfn, int sslerr0);
 int               restconf_connection_sanity(clixon_handle h, restconf_conn *rc, restconf_stream_data *sd);
@@ -43,6 +43,10 @@
   *  -s  enable the state function
   *  -S <file>  read state data from file, otherwise construct it programmatically (requires -s)
   *  -i  read state file on init not by request for optimization (requires -sS <file>)
+  *  -p <file> state data provider on /ex:pstate, log its xpath to <file>
+  *  -c <ms> max-age of state cache of /ex:pstate provider, invalidated on commit (requires -p)
+  *  -A <ms> asynchronous state data provider on /ex:astate, done after <ms>
+  *  -F  asynchronous state data provider fails (requires -A)
   *  -u  enable upgrade function - auto-upgrade testing
   *  -U  general-purpose upgrade
   *  -t  enable transaction logging (call syslog for every transaction)
@@ -70,7 +74,7 @@
 #include <clixon/clixon_backend.h>
 
 /* Command line options to be passed to getopt(3) */
-#define BACKEND_EXAMPLE_OPTS "a:m:M:nrsS:x:iuUtV:"
+#define BACKEND_EXAMPLE_OPTS "a:m:M:nrsS:x:ip:c:A:FuUtV:"
 
 /* Enabling this improves performance in tests, but there may trigger the "double XPath"
  * problem.
@@ -145,6 +149,41 @@ static int _state_file_cached = 0;
 static cxobj *_state_xml_cache = NULL; /* XML cache */
 static int _state_file_transaction = 0;
 
+/*! State data provider registered on the schema path /ex:pstate
+ *
+ * Each call of the provider appends the xpath it is called with to this file.
+ * Primarily for testing
+ * Start backend with -- -p <file>
+ */
+static char *_pstate_file = NULL;
+static uint32_t _pstate_calls = 0; /* Number of calls of the provider */
+
+/*! Max age in ms of the state cache of the /ex:pstate provider
+ *
+ * The cache is invalidated on commit
+ * Start backend with -- -p <file> -c <ms>
+ */
+static uint32_t _pstate_maxage = 0;
+
+/*! Delay in ms of asynchronous state data provider registered on /ex:astate
+ *
+ * Primarily for testing
+ * Start backend with -- -A <ms>
+ */
+static int _astate_delay = -1;
+
+/*! Asynchronous state data provider reports failure
+ *
+ * Start backend with -- -A <ms> -F
+ */
+static int _astate_fail = 0;
+
+/* Ongoing call of asynchronous state data provider */
+typedef struct {
+    clixon_handle ac_h;      /* Clixon handle */
+    uint32_t      ac_callid; /* Call id */
+} example_astate_call;
+
 /*! Variable to control module-specific upgrade callbacks.
  *
  * If set, call test-case for upgrading ietf-interfaces, otherwise call 
@@ -244,6 +283,10 @@ main_commit(clixon_handle    h,
         }
     }
 
+    /* Cached state may depend on config */
+    if (_pstate_maxage &&
+        clixon_statedata_cache_invalidate(h, "/ex:pstate") < 0)
+        return -1;
     /* Create namespace context for xpath */
     if ((nsc = xml_nsctx_init(NULL, "urn:ietf:params:xml:ns:yang:ietf-interfaces")) == NULL)
         goto done;
@@ -540,6 +583,142 @@ example_statedata(clixon_handle   h,
     return retval;
 }
 
+/*! State data provider registered on the schema path /ex:pstate
+ *
+ * Only called on get requests whose xpath intersects /ex:pstate, with the narrower of the
+ * two as xpath. Logs the xpath to the -p <file> and returns the number of calls.
+ * @param[in]    h        Clixon handle
+ * @param[in]    nsc      External XML namespace context, or NULL
+ * @param[in]    xpath    String with XPATH syntax
+ * @param[out]   xstate   XML tree, <config/> on entry.
+ * @retval       0        OK
+ * @retval      -1        Error
+ * @see clixon_statedata_cb_register
+ * @note requires this yang snippet in a module with namespace urn:example:clixon and prefix ex:
+       container pstate {
+         config false;
+         leaf calls {
+            type uint32;
+         }
+       }
+ */
+int
+example_pstate(clixon_handle h,
+               cvec         *nsc,
+               char         *xpath,
+               cxobj        *xstate)
+{
+    int   retval = -1;
+    FILE *fp = NULL;
+    cbuf *cb = NULL;
+
+    if ((fp = fopen(_pstate_file, "a")) == NULL){
+        clixon_err(OE_UNIX, errno, "fopen(%s)", _pstate_file);
+        goto done;
+    }
+    fprintf(fp, "%s\n", xpath);
+    _pstate_calls++;
+    if ((cb = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "<pstate xmlns=\"urn:example:clixon\"><calls>%u</calls></pstate>", _pstate_calls);
+    if (clixon_xml_parse_string(cbuf_get(cb), YB_NONE, NULL, &xstate, NULL) < 0)
+        goto done;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    if (fp)
+        fclose(fp);
+    return retval;
+}
+
+/*! Asynchronous state data provider done, report state
+ *
+ * @param[in]  s     Not used
+ * @param[in]  arg   Ongoing call
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+example_astate_done(int   s,
+                    void *arg)
+{
+    int                  retval = -1;
+    example_astate_call *ac = (example_astate_call *)arg;
+    cxobj               *xstate = NULL;
+
+    if (_astate_fail){
+        if (clixon_statedata_async_done(ac->ac_h, ac->ac_callid, NULL) < 0)
+            goto done;
+    }
+    else {
+        if (clixon_xml_parse_string("<astate xmlns=\"urn:example:clixon\"><value>42</value></astate>",
+                                    YB_NONE, NULL, &xstate, NULL) < 0)
+            goto done;
+        if (clixon_statedata_async_done(ac->ac_h, ac->ac_callid, xstate) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    if (xstate)
+        xml_free(xstate);
+    free(ac);
+    return retval;
+}
+
+/*! Asynchronous state data provider registered on the schema path /ex:astate
+ *
+ * Starts collecting state and returns, the state is reported after the -A <ms> delay
+ * @param[in]  h       Clixon handle
+ * @param[in]  nsc     External XML namespace context, or NULL
+ * @param[in]  xpath   String with XPATH syntax
+ * @param[in]  callid  Call id to report state with
+ * @param[in]  arg     Not used
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see clixon_statedata_async_register
+ * @note requires this yang snippet in a module with namespace urn:example:clixon and prefix ex:
+       container astate {
+         config false;
+         leaf value {
+            type uint32;
+         }
+       }
+ */
+int
+example_astate(clixon_handle h,
+               cvec         *nsc,
+               char         *xpath,
+               uint32_t      callid,
+               void         *arg)
+{
+    int                  retval = -1;
+    example_astate_call *ac = NULL;
+    struct timeval       t;
+    struct timeval       t1;
+
+    if ((ac = malloc(sizeof(*ac))) == NULL){
+        clixon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    ac->ac_h = h;
+    ac->ac_callid = callid;
+    gettimeofday(&t, NULL);
+    t1.tv_sec = _astate_delay/1000;
+    t1.tv_usec = (_astate_delay%1000)*1000;
+    timeradd(&t, &t1, &t);
+    if (clixon_event_reg_timeout(t, example_astate_done, ac, "example async state") < 0)
+        goto done;
+    ac = NULL;
+    retval = 0;
+ done:
+    if (ac)
+        free(ac);
+    return retval;
+}
+
 /*! Called to get state data from plugin by reading a file, also pagination
  *
  * The example shows how to read and parse a state XML file, (which is cached in the -i case).
@@ -1473,6 +1652,18 @@ clixon_plugin_init(clixon_handle h)
         case 'i': /* read state file on init not by request (requires -sS <file> */
             _state_file_cached = 1;
             break;
+        case 'p': /* state data provider on /ex:pstate */
+            _pstate_file = optarg;
+            break;
+        case 'c': /* max-age of state cache (requires -p) */
+            _pstate_maxage = atoi(optarg);
+            break;
+        case 'A': /* asynchronous state data provider */
+            _astate_delay = atoi(optarg);
+            break;
+        case 'F': /* asynchronous state data provider fails (requires -A) */
+            _astate_fail = 1;
+            break;
        case 'u': /* module-specific upgrade */
            _module_upgrade = 1;
            break;
@@ -1501,7 +1692,19 @@ clixon_plugin_init(clixon_handle h)
                 goto done;
         }
     }
-
+    if (_pstate_file){
+        /* Only called on requests intersecting the path */
+        if (clixon_statedata_cb_register(h, example_pstate, "/ex:pstate") < 0)
+            goto done;
+        if (_pstate_maxage &&
+            clixon_statedata_cache_set(h, "/ex:pstate", _pstate_maxage) < 0)
+            goto done;
+    }
+    if (_astate_delay >= 0){
+        /* Reply to get is deferred until the provider is done */
+        if (clixon_statedata_async_register(h, example_astate, "/ex:astate", NULL) < 0)
+            goto done;
+    }
     if (_notification_stream){
         /* Example stream initialization:
          * 1) Register EXAMPLE stream 
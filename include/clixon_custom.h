@@ -78,6 +78,15 @@
  */
 #define XML_EXPLICIT_INDEX
 
+/*! Allocate XML nodes from slabs with free lists instead of one malloc per node
+ *
+ * Freed nodes are reused. One empty slab is kept for reuse, other slabs are freed when
+ * all their nodes are freed.
+ * Undefine when debugging memory errors, since reuse of freed nodes hides use-after-free
+ * from valgrind and sanitizers.
+ */
+#define XML_NODE_SLAB
+
 /*! Let state data be ordered-by system
  *
  * RFC 7950 is cryptic about this
@@ -62,6 +62,17 @@ typedef int (clicon_output_cb)(
    const char *templ, ...
 ) __attribute__ ((format (printf, 2, 3)));
 
+/*! Flush callback for incremental encoding to a cbuf
+ *
+ * Called by XML and JSON encoders between elements. The callee may write the
+ * buffer somewhere and reset it, the encoder only appends.
+ * @param[in]  cb   Buffer with encoded output so far
+ * @param[in]  arg  Callback argument
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+typedef int (clixon_cbuf_flush_cb)(cbuf *cb, void *arg);
+
 /*
  * Prototypes
  */
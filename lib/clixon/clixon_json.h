@@ -46,6 +46,10 @@
 int json2xml_decode(cxobj *x, cxobj **xerr);
 int clixon_json2cbuf(cbuf *cb, cxobj *x, int pretty, int skiptop, int autocliext);
 int xml2json_cbuf_vec(cbuf *cb, cxobj **vec, size_t veclen, int pretty, int skiptop);
+int clixon_json2cbuf_flush(cbuf *cb, cxobj *x, int pretty, int skiptop, int autocliext,
+                           clixon_cbuf_flush_cb *fn, void *arg);
+int xml2json_cbuf_vec_flush(cbuf *cb, cxobj **vec, size_t veclen, int pretty, int skiptop,
+                            clixon_cbuf_flush_cb *fn, void *arg);
 int clixon_json2file(FILE *f, cxobj *x, int pretty, clicon_output_cb *fn, int skiptop, int autocliext);
 int json_print(FILE *f, cxobj *x);
 int xml2json_vec(FILE *f, cxobj **vec, size_t veclen, int pretty, clicon_output_cb *fn, int skiptop);
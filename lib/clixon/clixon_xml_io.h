@@ -54,6 +54,9 @@ int   xml_print(FILE *f, cxobj *xn);
 int   xml_dump(FILE  *f, cxobj *x);
 int   clixon_xml2cbuf1(cbuf *cb, cxobj *x, int level, int prettyprint, char *prefix,
                        int32_t depth, int skiptop, withdefaults_type wdef);
+int   clixon_xml2cbuf_flush(cbuf *cb, cxobj *x, int level, int prettyprint, char *prefix,
+                            int32_t depth, int skiptop, withdefaults_type wdef,
+                            clixon_cbuf_flush_cb *fn, void *arg);
 int   clixon_xml2cbuf(cbuf *cb, cxobj *x, int level, int prettyprint, char *prefix, int32_t depth, 
 int skiptop);
 int   xmltree2cbuf(cbuf *cb, cxobj *x, int level);
@@ -134,7 +134,10 @@ int   xpath_tree_eq(xpath_tree *xt1, xpath_tree *xt2, xpath_tree ***vec, size_t
 xpath_tree *xpath_tree_traverse(xpath_tree *xt, ...);
 int   xpath_tree_free(xpath_tree *xs);
 int   xpath_parse(const char *xpath, xpath_tree **xptree);
+int   xpath_tree_ctx(cxobj *xcur, cvec *nsc, xpath_tree *xptree, int localonly, xp_ctx **xrp);
 int   xpath_vec_ctx(cxobj *xcur, cvec *nsc, const char *xpath, int localonly, xp_ctx  **xrp);
+int   xpath_tree_bool(cxobj *xcur, cvec *nsc, xpath_tree *xptree);
+int   xpath_tree_vec(cxobj *xcur, cvec *nsc, xpath_tree *xptree, cxobj ***vec, size_t *veclen);
 
 int    xpath_vec_bool(cxobj *xcur, cvec *nsc, const char *xpformat, ...) __attribute__ ((format (printf, 3, 4)));
 int    xpath_vec_flag(cxobj *xcur, cvec *nsc, const char *xpformat, uint16_t flags,
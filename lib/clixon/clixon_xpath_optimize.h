@@ -40,6 +40,7 @@
 
 
 int  xpath_list_optimize_stats(int *hits);
+int  xpath_list_optimize_index_stats(int *hits);
 int  xpath_list_optimize_set(int enable);
 void xpath_optimize_exit(void);
 int  xpath_optimize_check(xpath_tree *xs, cxobj *xv, cxobj ***xvec0, int *xlen0);
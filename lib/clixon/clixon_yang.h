@@ -60,6 +60,7 @@
 #ifdef XML_EXPLICIT_INDEX
 #define YANG_FLAG_INDEX 0x08  /* This yang node under list is (extra) index. --> you can access
                                * list elements using this index with binary search */
+#define YANG_FLAG_INDEXED 0x20 /* This yang list has at least one YANG_FLAG_INDEX child */
 #endif
 #define YANG_FLAG_STATE_LOCAL  0x10  /* Local inverted value of Y_CONFIG child */
 #define YANG_FLAG_DISABLED     0x40  /* Disabled due to if-feature evaluate to false
@@ -90,6 +91,10 @@
                                       * Set by yang_mount_set 
                                       * Read by ys_free1
                                       */
+#define YANG_FLAG_DEP          0x400 /* (Dynamic) constraints of this node may be affected by
+                                      * changes, see xml_yang_validate_changes
+                                      */
+#define YANG_FLAG_DEP_ANC      0x800 /* (Dynamic) Ancestor of YANG_FLAG_DEP node */
 
 /*
  * Types
@@ -188,6 +193,7 @@ enum yang_class{
 typedef enum yang_class yang_class;
 
 struct xml;
+struct xpath_tree;
 
 /* This is the external handle type exposed in the API.
  * The internal struct is defined in clixon_yang_internal.h */
@@ -249,10 +255,18 @@ int        yang_ref_dec(yang_stmt *ys);
 uint16_t   yang_flag_get(yang_stmt *ys, uint16_t flag);
 int        yang_flag_set(yang_stmt *ys, uint16_t flag);
 int        yang_flag_reset(yang_stmt *ys, uint16_t flag);
+int        yang_json_kind_get(yang_stmt *ys);
+int        yang_json_kind_set(yang_stmt *ys, int kind);
 char      *yang_when_xpath_get(yang_stmt *ys);
 int        yang_when_xpath_set(yang_stmt *ys, char *xpath);
 cvec      *yang_when_nsc_get(yang_stmt *ys);
 int        yang_when_nsc_set(yang_stmt *ys, cvec *nsc);
+int        yang_nsctx_cache_get(yang_stmt *ys, cvec **nsc);
+int        yang_xpath_cache_get(yang_stmt *ys, struct xpath_tree **xpt);
+clicon_hash_t *yang_deps_get(yang_stmt *yspec);
+int        yang_deps_set(yang_stmt *yspec, clicon_hash_t *deps);
+yang_stmt *yang_modidx_get(yang_stmt *yspec, char type, const char *key);
+int        yang_modidx_set(yang_stmt *yspec, char type, const char *key, yang_stmt *ymod);
 const char *yang_filename_get(yang_stmt *ys);
 int        yang_filename_set(yang_stmt *ys, const char *filename);
 int        yang_linenum_get(yang_stmt *ys);
@@ -291,6 +305,8 @@ yang_stmt *yang_myroot(yang_stmt *ys);
 int        yang_choice_case_get(yang_stmt *yc, yang_stmt **ycase, yang_stmt **ychoice);
 yang_stmt *yang_choice(yang_stmt *y);
 int        yang_order(yang_stmt *y);
+void       yang_order_invalidate(void);
+int        yang_ordered_by_user(yang_stmt *y);
 int        yang_print_cb(FILE *f, yang_stmt *yn, clicon_output_cb *fn);
 int        yang_print(FILE *f, yang_stmt *yn);
 int        yang_print_cbuf(cbuf *cb, yang_stmt *yn, int marginal, int pretty);
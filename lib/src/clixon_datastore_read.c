@@ -720,13 +720,12 @@ xmldb_readfile(clixon_handle    h,
             }
         } /* if msdiff */
         /* xml looks like: <top><config><x>... actually YB_MODULE_NEXT 
+         * Bind and sort in one pass
          */
-        if ((ret = xml_bind_yang(h, x0, YB_MODULE, yspec1?yspec1:yspec, xerr)) < 0)
+        if ((ret = xml_bind_yang_sort(h, x0, YB_MODULE, yspec1?yspec1:yspec, xerr)) < 0)
             goto done;
         if (ret == 0)
             goto fail;
-        if (xml_sort_recurse(x0) < 0)
-            goto done;
     }
     if (xp){
         *xp = x0;
@@ -563,7 +563,7 @@ text_modify(clixon_handle       h,
          * See RFC 7950 Sec 7.7.9
          */
         if (yang_keyword_get(y0) == Y_LEAF_LIST &&
-            yang_find(y0, Y_ORDERED_BY, "user") != NULL){
+            yang_ordered_by_user(y0)){
             if ((ret = attr_ns_value(x1,
                                      "insert", YANG_XML_NAMESPACE,
                                      cbret, &instr)) < 0)
@@ -703,8 +703,21 @@ text_modify(clixon_handle       h,
                         if (ret == 0)
                             goto fail;
                     }
+#ifdef XML_EXPLICIT_INDEX
+                    /* Re-sort search index on value change of existing index variable */
+                    if (!changed && xml_search_index_rm(x0) < 0)
+                        goto done;
+#endif
                     if (xml_value_set(x0b, x1bstr) < 0)
                         goto done;
+#ifdef XML_EXPLICIT_INDEX
+                    if (!changed){
+                        if (xml_cv_set(x0, NULL) < 0)
+                            goto done;
+                        if (xml_search_index_insert(x0) < 0)
+                            goto done;
+                    }
+#endif
                     xml_flag_set(x0, XML_FLAG_ADD);
                     /* If a default value ies replaced, then reset default flag */
                     if (xml_flag(x0, XML_FLAG_DEFAULT))
@@ -761,7 +774,7 @@ text_modify(clixon_handle       h,
          * See RFC 7950 Sec 7.8.6
          */
         if (yang_keyword_get(y0) == Y_LIST &&
-            yang_find(y0, Y_ORDERED_BY, "user") != NULL){
+            yang_ordered_by_user(y0)){
             if ((ret = attr_ns_value(x1,
                                      "insert", YANG_XML_NAMESPACE,
                                      cbret, &instr)) < 0)
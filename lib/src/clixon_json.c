@@ -107,6 +107,20 @@ enum childtype{
     ANY_CHILD,    /* eg <a><b/></a> or <a><b/><c/></a> */
 };
 
+/* JSON encoding of a leaf or leaf-list, cached in its yang statement
+ * @see xml2json_encode_kind
+ */
+enum json_kind{
+    JSON_KIND_NONE = 0,    /* Not computed */
+    JSON_KIND_STRING,      /* Quoted and escaped string */
+    JSON_KIND_IDENTITYREF, /* Quoted identityref with module name as prefix */
+    JSON_KIND_NUMSTR,      /* int64, uint64, decimal64 as string, RFC7951 6.1 */
+    JSON_KIND_NUMBER,      /* Unquoted number or boolean */
+    JSON_KIND_EMPTY,       /* YANG empty type as [null] */
+    JSON_KIND_VOID,        /* Other void type as "" */
+    JSON_KIND_OTHER,       /* Quoted value or {} */
+};
+
 /*! x is element and has exactly one child which in turn has none 
  *
  * remove attributes from x
@@ -242,11 +256,16 @@ array_eval(cxobj *xprev,
     return arraytype;
 }
 
+/* Characters escaped in JSON strings */
+#define JSON_ESCAPE_CHARS "\"\\\b\f\n\r\t"
+
 /*! Escape a json string as well as decode xml cdata
  *
+ * Runs of characters not needing escape are found with strcspn and appended in bulk
  * @param[out] cb   cbuf   (encoded)
  * @param[in]  str  string (unencoded)
  * @retval     0    OK
+ * @retval    -1    Error
  */
 static int
 json_str_escape_cdata(cbuf *cb,
@@ -254,38 +273,46 @@ json_str_escape_cdata(cbuf *cb,
 {
     int    retval = -1;
     size_t len;
-    int    i;
+    char   esc[2] = {'\\', '\0'};
 
-    len = strlen(str);
-    for (i=0; i<len; i++)
-        switch (str[i]){
-        case '\"':
-            cprintf(cb, "\\\"");
-            break;
-        case '\\':
-            cprintf(cb, "\\\\");
-            break;
+    while (*str != '\0'){
+        if ((len = strcspn(str, JSON_ESCAPE_CHARS)) > 0){
+            if (cbuf_append_buf(cb, str, len) < 0){
+                clixon_err(OE_UNIX, errno, "cbuf_append_buf");
+                goto done;
+            }
+            str += len;
+            if (*str == '\0')
+                break;
+        }
+        switch (*str){
         case '\b':
-            cprintf(cb, "\\b");
+            esc[1] = 'b';
             break;
         case '\f':
-            cprintf(cb, "\\f");
+            esc[1] = 'f';
             break;
         case '\n':
-            cprintf(cb, "\\n");
+            esc[1] = 'n';
             break;
         case '\r':
-            cprintf(cb, "\\r");
+            esc[1] = 'r';
             break;
         case '\t':
-            cprintf(cb, "\\t");
+            esc[1] = 't';
             break;
-        default: /* fall thru */
-            cprintf(cb, "%c", str[i]);
+        default: /* quote and backslash */
+            esc[1] = *str;
             break;
         }
+        if (cbuf_append_buf(cb, esc, 2) < 0){
+            clixon_err(OE_UNIX, errno, "cbuf_append_buf");
+            goto done;
+        }
+        str++;
+    }
     retval = 0;
-    // done:
+ done:
     return retval;
 }
 
@@ -515,77 +542,41 @@ xml2json_encode_identityref(cxobj     *xb,
     return retval;
 }
 
-/*! Encode leaf/leaf_list types from XML to JSON
+/*! Get JSON encoding kind of a leaf/leaf_list, computed once and cached in yang
  *
- * @param[in]   xb   XML body
- * @param[in]   xp   XML parent
- * @param[in]   yp   Yang spec of parent
- * @param[out]  cb0  Encoded string
- * @retval      0    OK
- * @retval     -1    Error
+ * Resolving the type of every leaf is expensive, but the result only depends on yang
+ * @param[in]   yp    Yang leaf or leaf-list
+ * @param[out]  kind  JSON encoding kind
+ * @retval      0     OK
+ * @retval     -1     Error
+ * @see yang_json_kind_get
  */
 static int
-xml2json_encode_leafs(cxobj     *xb,
-                      cxobj     *xp,
-                      yang_stmt *yp,
-                      cbuf      *cb0)
+xml2json_encode_kind(yang_stmt      *yp,
+                     enum json_kind *kind)
 {
-    int           retval = -1;
-    enum rfc_6020 keyword;
-    yang_stmt    *ytype;
-    char         *restype;  /* resolved type */
-    char         *origtype=NULL;   /* original type */
-    char         *body;
-    enum cv_type  cvtype;
-    int           quote = 1; /* Quote value w string: "val" */
-    cbuf         *cb = NULL; /* the variable itself */
+    int        retval = -1;
+    enum json_kind k;
+    yang_stmt *ytype;
+    char      *restype;  /* resolved type */
+    char      *origtype = NULL;   /* original type */
 
-    if ((cb = cbuf_new()) ==NULL){
-        clixon_err(OE_XML, errno, "cbuf_new");
-        goto done;
-    }
-    body = xb?xml_value(xb):NULL;
-    if (yp == NULL){
-        cprintf(cb, "%s", body?body:"null");
-        goto ok; /* unknown */
-    }
-    keyword = yang_keyword_get(yp);
-    switch (keyword){
-    case Y_LEAF:
-    case Y_LEAF_LIST:
+    if ((k = yang_json_kind_get(yp)) == JSON_KIND_NONE){
         if (yang_type_get(yp, &origtype, &ytype, NULL, NULL, NULL, NULL, NULL) < 0)
             goto done;
         restype = ytype?yang_argument_get(ytype):NULL;
-        cvtype = yang_type2cv(yp);
-        switch (cvtype){
+        switch (yang_type2cv(yp)){
         case CGV_STRING:
         case CGV_REST:
-            if (body==NULL)
-                ; /* empty: "" */
-            else if (ytype){
-                if (strcmp(restype, "identityref")==0){
-                    if (xml2json_encode_identityref(xb, body, yp, cb) < 0)
-                        goto done;
-                }
-                else{
-                    cprintf(cb, "%s", body);
-                }
-            }
+            if (restype && strcmp(restype, "identityref")==0)
+                k = JSON_KIND_IDENTITYREF;
             else
-                cprintf(cb, "%s", body);
+                k = JSON_KIND_STRING;
             break;
         case CGV_INT64:
         case CGV_UINT64:
         case CGV_DEC64:
-            // [RFC7951] JSON Encoding of YANG Data
-            // 6.1 Numeric Types - A value of the "int64", "uint64", or "decimal64" type is represented as a JSON string
-            if (yang_keyword_get(yp) == Y_LEAF_LIST && xml_child_nr_type(xml_parent(xp), CX_ELMNT) == 1) {
-                cprintf(cb, "[%s]", body);
-            }
-            else {
-                cprintf(cb, "%s", body);
-            }
-            quote = 1;
+            k = JSON_KIND_NUMSTR;
             break;
         case CGV_INT8:
         case CGV_INT16:
@@ -594,50 +585,116 @@ xml2json_encode_leafs(cxobj     *xb,
         case CGV_UINT16:
         case CGV_UINT32:
         case CGV_BOOL:
-            cprintf(cb, "%s", body);
-            quote = 0;
+            k = JSON_KIND_NUMBER;
             break;
         case CGV_VOID:
-            /* special case YANG empty type */
-            if (body == NULL && strcmp(restype, "empty")==0){
-                quote = 0;
-                if (keyword == Y_LEAF)
-                    cprintf(cb, "[null]");
-                else if (keyword == Y_LEAF_LIST && strcmp(restype, "empty") == 0)
-                    cprintf(cb, "[null]");
-                else
-                    cprintf(cb, "null");
-            }
+            if (restype && strcmp(restype, "empty")==0)
+                k = JSON_KIND_EMPTY;
+            else
+                k = JSON_KIND_VOID;
             break;
         default:
-            if (body)
-                cprintf(cb, "%s", body);
-            else
-                cprintf(cb, "{}"); /* dont know */
+            k = JSON_KIND_OTHER;
+            break;
+        }
+        yang_json_kind_set(yp, k);
+    }
+    *kind = k;
+    retval = 0;
+ done:
+    if (origtype)
+        free(origtype);
+    return retval;
+}
+
+/*! Encode leaf/leaf_list types from XML to JSON
+ *
+ * Values are written directly to cb0, only identityrefs use an intermediate buffer
+ * @param[in]   xb   XML body
+ * @param[in]   xp   XML parent
+ * @param[in]   yp   Yang spec of parent
+ * @param[out]  cb0  Encoded string
+ * @retval      0    OK
+ * @retval     -1    Error
+ */
+static int
+xml2json_encode_leafs(cxobj     *xb,
+                      cxobj     *xp,
+                      yang_stmt *yp,
+                      cbuf      *cb0)
+{
+    int            retval = -1;
+    enum rfc_6020  keyword;
+    enum json_kind kind;
+    char          *body;
+    cbuf          *cb = NULL; /* identityref */
+
+    body = xb?xml_value(xb):NULL;
+    if (yp == NULL){ /* unknown */
+        kind = JSON_KIND_STRING;
+        if (body == NULL)
+            body = "null";
+    }
+    else if ((keyword = yang_keyword_get(yp)) != Y_LEAF && keyword != Y_LEAF_LIST)
+        kind = JSON_KIND_STRING;
+    else if (xml2json_encode_kind(yp, &kind) < 0)
+        goto done;
+    switch (kind){
+    case JSON_KIND_IDENTITYREF:
+        if (body){
+            if ((cb = cbuf_new()) == NULL){
+                clixon_err(OE_XML, errno, "cbuf_new");
+                goto done;
+            }
+            if (xml2json_encode_identityref(xb, body, yp, cb) < 0)
+                goto done;
+            body = cbuf_get(cb);
         }
+        /* fall thru */
+    case JSON_KIND_STRING:
+        cbuf_append(cb0, '"');
+        if (body && json_str_escape_cdata(cb0, body) < 0)
+            goto done;
+        cbuf_append(cb0, '"');
+        break;
+    case JSON_KIND_NUMSTR:
+        // [RFC7951] JSON Encoding of YANG Data
+        // 6.1 Numeric Types - A value of the "int64", "uint64", or "decimal64" type is represented as a JSON string
+        cbuf_append(cb0, '"');
+        if (yang_keyword_get(yp) == Y_LEAF_LIST && xml_child_nr_type(xml_parent(xp), CX_ELMNT) == 1)
+            cprintf(cb0, "[%s]", body);
+        else if (body && json_str_escape_cdata(cb0, body) < 0)
+            goto done;
+        cbuf_append(cb0, '"');
+        break;
+    case JSON_KIND_NUMBER:
+        if (body)
+            cbuf_append_str(cb0, body);
         break;
+    case JSON_KIND_EMPTY:
+        /* special case YANG empty type */
+        if (body == NULL)
+            cbuf_append_str(cb0, "[null]");
+        else
+            cbuf_append_str(cb0, "\"\"");
+        break;
+    case JSON_KIND_VOID:
+        cbuf_append_str(cb0, "\"\"");
+        break;
+    case JSON_KIND_OTHER:
     default:
-        cprintf(cb, "%s", body);
+        cbuf_append(cb0, '"');
+        if (body == NULL)
+            cbuf_append_str(cb0, "{}"); /* dont know */
+        else if (json_str_escape_cdata(cb0, body) < 0)
+            goto done;
+        cbuf_append(cb0, '"');
         break;
     }
- ok:
-    /* write into original cb0
-     * includign quoting and encoding 
-     */
-    if (quote){
-        cprintf(cb0, "\"");
-        json_str_escape_cdata(cb0, cbuf_get(cb));
-    }
-    else
-        cprintf(cb0, "%s", cbuf_get(cb));
-    if (quote)
-        cprintf(cb0, "\"");
     retval = 0;
  done:
     if (cb)
         cbuf_free(cb);
-    if (origtype)
-        free(origtype);
     return retval;
 }
 
@@ -807,6 +864,8 @@ xml2json_encode_attr(cxobj     *xa,
  * @param[in]   flat      Dont print NO_ARRAY object name (for _vec call)
  * @param[in]   modname0
  * @param[out]  metacbp   Meta encoding of attribute
+ * @param[in]   fn        Flush callback called after each child element, or NULL
+ * @param[in]   arg       Argument to flush callback
  * @retval      0         OK
  * @retval     -1         Error
  *
@@ -846,7 +905,9 @@ xml2json1_cbuf(cbuf                   *cb,
                int                     pretty,
                int                     flat,
                char                   *modname0,
-               cbuf                   *metacbp)
+               cbuf                   *metacbp,
+               clixon_cbuf_flush_cb   *fn,
+               void                   *arg)
 {
     int              retval = -1;
     int              i;
@@ -953,7 +1014,9 @@ xml2json1_cbuf(cbuf                   *cb,
     default:
         break;
     }
-    if ((metacbc = cbuf_new()) == NULL){
+    /* Metadata of element children, other children have no attributes */
+    if (childt == ANY_CHILD &&
+        (metacbc = cbuf_new()) == NULL){
         clixon_err(OE_UNIX, errno, "cbuf_new");
         goto done;
     }
@@ -977,14 +1040,16 @@ xml2json1_cbuf(cbuf                   *cb,
                            xc,
                            xc_arraytype,
                            level+1, pretty, 0, modname0,
-                           metacbc) < 0)
+                           metacbc, fn, arg) < 0)
             goto done;
         if (commas > 0) {
             cprintf(cb, ",%s", pretty?"\n":"");
             --commas;
         }
+        if (fn && xml_type(xc) == CX_ELMNT && (*fn)(cb, arg) < 0)
+            goto done;
     }
-    if (cbuf_len(metacbc)){
+    if (metacbc && cbuf_len(metacbc)){
         cprintf(cb, "%s", cbuf_get(metacbc));
     }
 
@@ -1061,6 +1126,8 @@ xml2json1_cbuf(cbuf                   *cb,
  * @param[in]     x      XML tree to translate from
  * @param[in]     pretty Set if output is pretty-printed
  * @param[in]     autocliext How to handle autocli extensions: 0: ignore 1: follow
+ * @param[in]     fn     Flush callback, or NULL
+ * @param[in]     arg    Argument to flush callback
  * @retval        0      OK
  * @retval       -1      Error
  *
@@ -1068,10 +1135,12 @@ xml2json1_cbuf(cbuf                   *cb,
  * @see xml2json_cbuf_vec   Top symbol is list
  */
 static int
-xml2json_cbuf1(cbuf   *cb,
-               cxobj  *x,
-               int     pretty,
-               int     autocliext)
+xml2json_cbuf1(cbuf                 *cb,
+               cxobj                *x,
+               int                   pretty,
+               int                   autocliext,
+               clixon_cbuf_flush_cb *fn,
+               void                 *arg)
 {
     int                     retval = 1;
     int                     level = 0;
@@ -1107,7 +1176,8 @@ xml2json_cbuf1(cbuf   *cb,
                        pretty,
                        0,
                        NULL, /* ancestor modname / namespace */
-                       NULL) < 0)
+                       NULL,
+                       fn, arg) < 0)
         goto done;
     cprintf(cb, "%s%*s}%s",
             pretty?"\n":"",
@@ -1145,6 +1215,33 @@ clixon_json2cbuf(cbuf  *cb,
                  int    pretty,
                  int    skiptop,
                  int    autocliext)
+{
+    return clixon_json2cbuf_flush(cb, xt, pretty, skiptop, autocliext, NULL, NULL);
+}
+
+/*! Translate an XML tree to JSON in a CLIgen buffer incrementally using a flush callback
+ *
+ * Same as clixon_json2cbuf but calls fn after every encoded element so that the caller
+ * can drain the buffer, eg write it to a socket, instead of holding the whole output.
+ * @param[in,out] cb      Cligen buffer to write to
+ * @param[in]     xt      Top-level xml object
+ * @param[in]     pretty  Set if output is pretty-printed
+ * @param[in]     skiptop 0: Include top object 1: Skip top-object, only children, 
+ * @param[in]     autocliext How to handle autocli extensions: 0: ignore 1: follow
+ * @param[in]     fn      Flush callback, or NULL
+ * @param[in]     arg     Argument to flush callback
+ * @retval        0       OK
+ * @retval       -1       Error
+ * @note The remainder of the output is left in cb on return, caller must handle it
+ */
+int
+clixon_json2cbuf_flush(cbuf                 *cb,
+                       cxobj                *xt,
+                       int                   pretty,
+                       int                   skiptop,
+                       int                   autocliext,
+                       clixon_cbuf_flush_cb *fn,
+                       void                 *arg)
 {
     int    retval = -1;
     cxobj *xc;
@@ -1155,12 +1252,12 @@ clixon_json2cbuf(cbuf  *cb,
         while ((xc = xml_child_each(xt, xc, CX_ELMNT)) != NULL){
             if (i++)
                 cprintf(cb, ",");
-            if (xml2json_cbuf1(cb, xc, pretty, autocliext) < 0)
+            if (xml2json_cbuf1(cb, xc, pretty, autocliext, fn, arg) < 0)
                 goto done;
         }
     }
     else {
-        if (xml2json_cbuf1(cb, xt, pretty, autocliext) < 0)
+        if (xml2json_cbuf1(cb, xt, pretty, autocliext, fn, arg) < 0)
             goto done;
     }
     retval = 0;
@@ -1189,6 +1286,31 @@ xml2json_cbuf_vec(cbuf      *cb,
                   size_t     veclen,
                   int        pretty,
                   int        skiptop)
+{
+    return xml2json_cbuf_vec_flush(cb, vec, veclen, pretty, skiptop, NULL, NULL);
+}
+
+/*! Translate a vector of xml objects to JSON incrementally using a flush callback
+ *
+ * @param[out] cb     Cligen buffer to write to
+ * @param[in]  vec    Vector of xml objecst
+ * @param[in]  veclen Length of vector
+ * @param[in]  pretty Set if output is pretty-printed (2 for debug)
+ * @param[in]  skiptop 0: Include top object 1: Skip top-object, only children, 
+ * @param[in]  fn     Flush callback, or NULL
+ * @param[in]  arg    Argument to flush callback
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see xml2json_cbuf_vec
+ */
+int
+xml2json_cbuf_vec_flush(cbuf                 *cb,
+                        cxobj               **vec,
+                        size_t                veclen,
+                        int                   pretty,
+                        int                   skiptop,
+                        clixon_cbuf_flush_cb *fn,
+                        void                 *arg)
 {
     int    retval = -1;
     int    level = 0;
@@ -1233,7 +1355,7 @@ xml2json_cbuf_vec(cbuf      *cb,
                        NO_ARRAY,
                        level,
                        pretty,
-                       1, NULL, NULL) < 0)
+                       1, NULL, NULL, fn, arg) < 0)
         goto done;
 
     if (0){
@@ -1444,7 +1566,7 @@ _json_parse(char      *str,
             cxobj    **xerr)
 {
     int              retval = -1;
-    clixon_json_yacc jy = {0,};
+    clixon_json_parser jp = {0,};
     int              ret;
     cxobj           *x;
     cbuf            *cberr = NULL;
@@ -1452,23 +1574,17 @@ _json_parse(char      *str,
     int              failed = 0; /* yang assignment */
 
     clixon_debug(CLIXON_DBG_DEFAULT, "%d %s", yb, str);
-    jy.jy_parse_string = str;
-    jy.jy_linenum = 1;
-    jy.jy_current = xt;
-    jy.jy_xtop = xt;
-    if (json_scan_init(&jy) < 0)
-        goto done;
-    if (json_parse_init(&jy) < 0)
+    if (json_parse_init(&jp, str, xt) < 0)
         goto done;
-    if (clixon_json_parseparse(&jy) != 0) { /* yacc returns 1 on error */
-        clixon_log(NULL, LOG_NOTICE, "JSON error: line %d", jy.jy_linenum);
+    if (json_parse(&jp) < 0) {
+        clixon_log(NULL, LOG_NOTICE, "JSON error: line %d", jp.jp_linenum);
         if (clixon_err_category() == 0)
             clixon_err(OE_JSON, 0, "JSON parser error with no error code (should not happen)");
         goto done;
     }
     /* Traverse new objects */
-    for (i = 0; i < jy.jy_xlen; i++) {
-        x = jy.jy_xvec[i];
+    for (i = 0; i < jp.jp_xlen; i++) {
+        x = jp.jp_xvec[i];
         /* RFC 7951 Section 4: A namespace-qualified member name MUST be used for all 
          * members of a top-level JSON object 
          */
@@ -1540,10 +1656,7 @@ _json_parse(char      *str,
     clixon_debug(CLIXON_DBG_DEFAULT, "retval:%d", retval);
     if (cberr)
         cbuf_free(cberr);
-    json_parse_exit(&jy);
-    json_scan_exit(&jy);
-    if (jy.jy_xvec)
-        free(jy.jy_xvec);
+    json_parse_exit(&jp);
     return retval;
  fail: /* invalid */
     retval = 0;
@@ -1637,11 +1750,9 @@ clixon_json_parse_file(FILE      *fp,
     int       retval = -1;
     int       ret;
     char     *jsonbuf = NULL;
-    int       jsonbuflen = BUFLEN; /* start size */
-    int       oldjsonbuflen;
-    char     *ptr;
-    char      ch;
-    int       len = 0;
+    size_t    jsonbuflen = BUFLEN; /* start size */
+    size_t    len = 0;
+    size_t    n;
 
     if (xt==NULL){
         clixon_err(OE_JSON, EINVAL, "xt is NULL");
@@ -1651,42 +1762,38 @@ clixon_json_parse_file(FILE      *fp,
         clixon_err(OE_JSON, errno, "malloc");
         goto done;
     }
-    memset(jsonbuf, 0, jsonbuflen);
-    ptr = jsonbuf;
+    /* Read whole file in blocks, doubling buffer as needed */
     while (1){
-        if ((ret = fread(&ch, 1, 1, fp)) < 0){
-            clixon_err(OE_JSON, errno, "read");
-            break;
-        }
-        if (ret != 0)
-            jsonbuf[len++] = ch;
-        if (ret == 0){
-            if (*xt == NULL)
-                if ((*xt = xml_new(JSON_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
-                    goto done;
-            if (len){
-                if ((ret = _json_parse(ptr, rfc7951, yb, yspec, *xt, xerr)) < 0)
-                    goto done;
-                if (ret == 0)
-                    goto fail;
-            }
-            break;
-        }
         if (len >= jsonbuflen-1){ /* Space: one for the null character */
-            oldjsonbuflen = jsonbuflen;
             jsonbuflen *= 2;
             if ((jsonbuf = realloc(jsonbuf, jsonbuflen)) == NULL){
                 clixon_err(OE_JSON, errno, "realloc");
                 goto done;
             }
-            memset(jsonbuf+oldjsonbuflen, 0, jsonbuflen-oldjsonbuflen);
-            ptr = jsonbuf;
         }
+        if ((n = fread(jsonbuf+len, 1, jsonbuflen-1-len, fp)) == 0){
+            if (ferror(fp)){
+                clixon_err(OE_JSON, errno, "read");
+                goto done;
+            }
+            break;
+        }
+        len += n;
+    }
+    jsonbuf[len] = '\0';
+    if (*xt == NULL)
+        if ((*xt = xml_new(JSON_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+            goto done;
+    if (len){
+        if ((ret = _json_parse(jsonbuf, rfc7951, yb, yspec, *xt, xerr)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
     }
     retval = 1;
  done:
     if (retval < 0 && *xt){
-        free(*xt);
+        xml_free(*xt);
         *xt = NULL;
     }
     if (jsonbuf)
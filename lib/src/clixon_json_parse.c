@@ -0,0 +1,620 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * JSON Parser
+ * @see http://www.ecma-international.org/publications/files/ECMA-ST/ECMA-404.pdf
+ *  and RFC 7951 JSON Encoding of Data Modeled with YANG
+ *  and RFC 8259 The JavaScript Object Notation (JSON) Data Interchange Format
+ *
+ * Hand-written recursive-descent parser building a cxobj tree in one pass over the
+ * input, replacing an earlier flex/bison parser.
+ * Runs of whitespace and unescaped string characters are found with strspn/strcspn and
+ * copied in bulk, which are vectorized in most libc:s.
+ *
+ * Grammar:
+ *  value    ::= object | array | number | string | 'true' | 'false' | 'null' ;
+ *  object   ::= '{' [objlist] '}';
+ *  objlist  ::= pair [',' objlist];
+ *  pair     ::= string ':' value;
+ *  array    ::= '[' [vallist] ']';
+ *  vallist  ::= value [',' vallist];
+ *
+ * XML translation:
+ *  { "a": "34" }       -->  <a>34</a>
+ *  { "a": [1, 2] }     -->  <a>1</a><a>2</a>
+ *  { "m:a": null }     -->  <m:a/>   where m is a module name, translated later
+ */
+
+#include "clixon_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <cligen/cligen.h>
+
+/* clixon */
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_debug.h"
+#include "clixon_string.h"
+
+#include "clixon_json_parse.h"
+
+/* Max nesting of objects and arrays, same as default max depth of bison stack */
+#define JSON_PARSE_DEPTH_MAX 10000
+
+/* Whitespace, newline is handled separately for line numbering */
+#define JSON_WS_CHARS " \t\r"
+
+/* Characters ending a run of plain characters in a string */
+#define JSON_STR_STOP_CHARS "\"\\\b\f\n\r\t"
+
+static int json_parse_value(clixon_json_parser *jp);
+
+/*! Register a syntax error at current position
+ *
+ * @param[in]  jp   JSON parser
+ * @param[in]  msg  Error message
+ * @retval    -1    Always, for use in return statements
+ */
+static int
+json_parse_error(clixon_json_parser *jp,
+                 char               *msg)
+{
+    clixon_err(OE_JSON, 0, "json_parse: line %d: %s at or before: '%.1s'",
+               jp->jp_linenum,
+               msg,
+               jp->jp_ptr);
+    return -1;
+}
+
+/*! Skip whitespace and count newlines
+ *
+ * @param[in]  jp   JSON parser
+ */
+static void
+json_parse_ws(clixon_json_parser *jp)
+{
+    char *p = jp->jp_ptr;
+
+    while (1){
+        p += strspn(p, JSON_WS_CHARS);
+        if (*p != '\n')
+            break;
+        jp->jp_linenum++;
+        p++;
+    }
+    jp->jp_ptr = p;
+}
+
+/*! Create xml object from json object name (eg "string") 
+ *
+ * Split name into prefix:name (extended JSON RFC7951)
+ * @param[in]  jp    JSON parser
+ * @param[in]  name  Name, on the form [prefix:]id, colon is overwritten
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+json_current_new(clixon_json_parser *jp,
+                 char               *name)
+{
+    int    retval = -1;
+    cxobj *x;
+    char  *id;
+
+    /* Find colon separator and if found split into prefix:name */
+    if ((id = strchr(name, ':')) != NULL)
+        *id++ = '\0';
+    else
+        id = name;
+    if ((x = xml_new(id, jp->jp_current, CX_ELMNT)) == NULL)
+        goto done;
+    if (id != name && xml_prefix_set(x, name) < 0)
+        goto done;
+    /* If topmost, add to top-list created list */
+    if (jp->jp_current == jp->jp_xtop){
+        if (cxvec_append(x, &jp->jp_xvec, &jp->jp_xlen) < 0)
+            goto done;
+    }
+    jp->jp_current = x;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Go back to parent of current object
+ */
+static int
+json_current_pop(clixon_json_parser *jp)
+{
+    if (jp->jp_current)
+        jp->jp_current = xml_parent(jp->jp_current);
+    return 0;
+}
+
+/*! Replace current object with a new sibling with the same name, for JSON arrays
+ */
+static int
+json_current_clone(clixon_json_parser *jp)
+{
+    int    retval = -1;
+    cxobj *xn;
+    cxobj *x;
+
+    if ((xn = jp->jp_current) == NULL){
+        clixon_err(OE_JSON, 0, "json_parse: line %d: no current object", jp->jp_linenum);
+        goto done;
+    }
+    json_current_pop(jp);
+    if (jp->jp_current) {
+        if ((x = xml_new(xml_name(xn), jp->jp_current, CX_ELMNT)) == NULL)
+            goto done;
+        if (xml_prefix(xn) && xml_prefix_set(x, xml_prefix(xn)) < 0)
+            goto done;
+        if (jp->jp_current == jp->jp_xtop){
+            if (cxvec_append(x, &jp->jp_xvec, &jp->jp_xlen) < 0)
+                goto done;
+        }
+        jp->jp_current = x;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Add body to current object
+ *
+ * @param[in]  jp     JSON parser
+ * @param[in]  value  Body value, or NULL for JSON null
+ */
+static int
+json_current_body(clixon_json_parser *jp,
+                  char               *value)
+{
+    int    retval = -1;
+    cxobj *xn;
+
+    if ((xn = xml_new("body", jp->jp_current, CX_BODY)) == NULL)
+        goto done;
+    if (value && xml_value_append(xn, value) < 0)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Parse four hex digits of a \u escape
+ *
+ * @param[in]  p     First hex digit
+ * @param[out] code  UTF-16 code unit
+ * @retval     1     OK
+ * @retval     0     Not four hex digits
+ */
+static int
+json_parse_hex4(char     *p,
+                uint32_t *code)
+{
+    int  i;
+    char c;
+
+    *code = 0;
+    for (i=0; i<4; i++){
+        c = p[i];
+        if ('0' <= c && c <= '9')
+            *code = (*code << 4) | (c - '0');
+        else if ('a' <= c && c <= 'f')
+            *code = (*code << 4) | (c - 'a' + 10);
+        else if ('A' <= c && c <= 'F')
+            *code = (*code << 4) | (c - 'A' + 10);
+        else
+            return 0;
+    }
+    return 1;
+}
+
+/*! Append unicode code point as UTF-8 to buffer
+ *
+ * @param[in]  cb    Buffer
+ * @param[in]  code  Unicode code point, not a surrogate. NUL is skipped
+ */
+static void
+json_utf8_append(cbuf    *cb,
+                 uint32_t code)
+{
+    if (code == 0) /* Not representable in XML */
+        return;
+    if (code < 0x80)
+        cbuf_append(cb, code);
+    else if (code < 0x800){
+        cbuf_append(cb, 0xC0 | (code >> 6));
+        cbuf_append(cb, 0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000){
+        cbuf_append(cb, 0xE0 | (code >> 12));
+        cbuf_append(cb, 0x80 | ((code >> 6) & 0x3F));
+        cbuf_append(cb, 0x80 | (code & 0x3F));
+    }
+    else {
+        cbuf_append(cb, 0xF0 | (code >> 18));
+        cbuf_append(cb, 0x80 | ((code >> 12) & 0x3F));
+        cbuf_append(cb, 0x80 | ((code >> 6) & 0x3F));
+        cbuf_append(cb, 0x80 | (code & 0x3F));
+    }
+}
+
+/*! Parse a quoted string into the string buffer of the parser
+ *
+ * Current position is at the starting quote
+ * Characters outside the BMP are escaped as UTF-16 surrogate pairs: \uD83D\uDE00
+ * @param[in]  jp   JSON parser
+ * @retval     0    OK, string in jp_cb
+ * @retval    -1    Error
+ */
+static int
+json_parse_string(clixon_json_parser *jp)
+{
+    int    retval = -1;
+    cbuf  *cb = jp->jp_cb;
+    char  *p;
+    size_t   len;
+    uint32_t code;
+    uint32_t low;
+
+    cbuf_reset(cb);
+    p = jp->jp_ptr + 1;
+    while (1){
+        if ((len = strcspn(p, JSON_STR_STOP_CHARS)) > 0){
+            if (cbuf_append_buf(cb, p, len) < 0){
+                clixon_err(OE_UNIX, errno, "cbuf_append_buf");
+                goto done;
+            }
+            p += len;
+        }
+        if (*p == '"')
+            break;
+        jp->jp_ptr = p;
+        if (*p != '\\')  /* Control characters and end of input */
+            goto err;
+        p++;
+        switch (*p){
+        case '"':
+        case '\\':
+        case '/':
+            cbuf_append(cb, *p);
+            break;
+        case 'b':
+            cbuf_append(cb, '\b');
+            break;
+        case 'f':
+            cbuf_append(cb, '\f');
+            break;
+        case 'n':
+            cbuf_append(cb, '\n');
+            break;
+        case 'r':
+            cbuf_append(cb, '\r');
+            break;
+        case 't':
+            cbuf_append(cb, '\t');
+            break;
+        case 'u':
+            if (json_parse_hex4(p+1, &code) == 0){
+                jp->jp_ptr = p;
+                goto err;
+            }
+            if (code >= 0xDC00 && code < 0xE000){ /* Low surrogate without high */
+                jp->jp_ptr = p;
+                goto err;
+            }
+            p += 4;
+            if (code >= 0xD800 && code < 0xDC00){ /* High surrogate, low must follow */
+                if (p[1] != '\\' || p[2] != 'u' ||
+                    json_parse_hex4(p+3, &low) == 0 ||
+                    low < 0xDC00 || low >= 0xE000){
+                    jp->jp_ptr = p+1;
+                    goto err;
+                }
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                p += 6;
+            }
+            json_utf8_append(cb, code);
+            break;
+        default:
+            jp->jp_ptr = p;
+            goto err;
+        }
+        p++;
+    }
+    jp->jp_ptr = p + 1;
+    retval = 0;
+ done:
+    return retval;
+ err:
+    return json_parse_error(jp, "syntax error");
+}
+
+/*! Parse a number into the string buffer of the parser
+ *
+ * Accepted: -?(digits|digits.digits*|digits*.digits)([eE][+-]?digits)?
+ * @param[in]  jp   JSON parser
+ * @retval     0    OK, number string in jp_cb
+ * @retval    -1    Error
+ */
+static int
+json_parse_number(clixon_json_parser *jp)
+{
+    char  *p = jp->jp_ptr;
+    size_t ndig;
+
+    if (*p == '-')
+        p++;
+    ndig = strspn(p, "0123456789");
+    p += ndig;
+    if (*p == '.'){
+        p++;
+        ndig += strspn(p, "0123456789");
+        p += strspn(p, "0123456789");
+    }
+    if (ndig == 0)
+        return json_parse_error(jp, "syntax error");
+    if (*p == 'e' || *p == 'E'){
+        p++;
+        if (*p == '+' || *p == '-')
+            p++;
+        if (*p < '0' || *p > '9'){
+            jp->jp_ptr = p;
+            return json_parse_error(jp, "syntax error");
+        }
+        p += strspn(p, "0123456789");
+    }
+    cbuf_reset(jp->jp_cb);
+    if (cbuf_append_buf(jp->jp_cb, jp->jp_ptr, p - jp->jp_ptr) < 0){
+        clixon_err(OE_UNIX, errno, "cbuf_append_buf");
+        return -1;
+    }
+    jp->jp_ptr = p;
+    return 0;
+}
+
+/*! Parse a JSON object: '{' [pair [',' pair]*] '}'
+ *
+ * Current position is at the left curly bracket
+ */
+static int
+json_parse_object(clixon_json_parser *jp)
+{
+    jp->jp_ptr++;
+    json_parse_ws(jp);
+    if (*jp->jp_ptr == '}'){
+        jp->jp_ptr++;
+        return 0;
+    }
+    while (1){
+        if (*jp->jp_ptr != '"')
+            return json_parse_error(jp, "syntax error");
+        if (json_parse_string(jp) < 0)
+            return -1;
+        if (json_current_new(jp, cbuf_get(jp->jp_cb)) < 0)
+            return -1;
+        json_parse_ws(jp);
+        if (*jp->jp_ptr != ':')
+            return json_parse_error(jp, "syntax error");
+        jp->jp_ptr++;
+        if (json_parse_value(jp) < 0)
+            return -1;
+        json_current_pop(jp);
+        json_parse_ws(jp);
+        if (*jp->jp_ptr == '}')
+            break;
+        if (*jp->jp_ptr != ',')
+            return json_parse_error(jp, "syntax error");
+        jp->jp_ptr++;
+        json_parse_ws(jp);
+    }
+    jp->jp_ptr++;
+    return 0;
+}
+
+/*! Parse a JSON array: '[' [value [',' value]*] ']'
+ *
+ * Each value after the first is added to a new sibling of the current object
+ * Current position is at the left square bracket
+ */
+static int
+json_parse_array(clixon_json_parser *jp)
+{
+    jp->jp_ptr++;
+    json_parse_ws(jp);
+    if (*jp->jp_ptr == ']'){
+        jp->jp_ptr++;
+        return 0;
+    }
+    while (1){
+        if (json_parse_value(jp) < 0)
+            return -1;
+        json_parse_ws(jp);
+        if (*jp->jp_ptr == ']')
+            break;
+        if (*jp->jp_ptr != ',')
+            return json_parse_error(jp, "syntax error");
+        jp->jp_ptr++;
+        if (json_current_clone(jp) < 0)
+            return -1;
+    }
+    jp->jp_ptr++;
+    return 0;
+}
+
+/*! Parse a JSON value
+ *
+ * @param[in]  jp   JSON parser
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+json_parse_value(clixon_json_parser *jp)
+{
+    int retval = -1;
+
+    json_parse_ws(jp);
+    switch (*jp->jp_ptr){
+    case '{':
+    case '[':
+        if (++jp->jp_depth > JSON_PARSE_DEPTH_MAX){
+            json_parse_error(jp, "memory exhausted");
+            goto done;
+        }
+        if (*jp->jp_ptr == '{'){
+            if (json_parse_object(jp) < 0)
+                goto done;
+        }
+        else if (json_parse_array(jp) < 0)
+            goto done;
+        jp->jp_depth--;
+        break;
+    case '"':
+        if (json_parse_string(jp) < 0)
+            goto done;
+        if (json_current_body(jp, cbuf_get(jp->jp_cb)) < 0)
+            goto done;
+        break;
+    case 't':
+        if (strncmp(jp->jp_ptr, "true", 4) != 0)
+            goto err;
+        jp->jp_ptr += 4;
+        if (json_current_body(jp, "true") < 0)
+            goto done;
+        break;
+    case 'f':
+        if (strncmp(jp->jp_ptr, "false", 5) != 0)
+            goto err;
+        jp->jp_ptr += 5;
+        if (json_current_body(jp, "false") < 0)
+            goto done;
+        break;
+    case 'n':
+        if (strncmp(jp->jp_ptr, "null", 4) != 0)
+            goto err;
+        jp->jp_ptr += 4;
+        if (json_current_body(jp, NULL) < 0)
+            goto done;
+        break;
+    case '-': case '.':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        if (json_parse_number(jp) < 0)
+            goto done;
+        if (json_current_body(jp, cbuf_get(jp->jp_cb)) < 0)
+            goto done;
+        break;
+    default:
+        goto err;
+    }
+    retval = 0;
+ done:
+    return retval;
+ err:
+    json_parse_error(jp, "syntax error");
+    goto done;
+}
+
+/*! Initialize JSON parser
+ *
+ * @param[in]  jp   JSON parser
+ * @param[in]  str  String to parse, not modified
+ * @param[in]  xt   Top-level XML object, parsed objects are added as children
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+int
+json_parse_init(clixon_json_parser *jp,
+                char               *str,
+                cxobj              *xt)
+{
+    int retval = -1;
+
+    memset(jp, 0, sizeof(*jp));
+    jp->jp_parse_string = str;
+    jp->jp_ptr = str;
+    jp->jp_linenum = 1;
+    jp->jp_current = xt;
+    jp->jp_xtop = xt;
+    if ((jp->jp_cb = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Parse JSON: a single value followed by end of input
+ *
+ * @param[in]  jp   JSON parser
+ * @retval     0    OK, created top-level objects in jp_xvec
+ * @retval    -1    Error
+ */
+int
+json_parse(clixon_json_parser *jp)
+{
+    if (json_parse_value(jp) < 0)
+        return -1;
+    json_parse_ws(jp);
+    if (*jp->jp_ptr != '\0')
+        return json_parse_error(jp, "syntax error");
+    return 0;
+}
+
+/*! Free JSON parser resources, not created XML
+ *
+ * @param[in]  jp   JSON parser
+ */
+int
+json_parse_exit(clixon_json_parser *jp)
+{
+    if (jp->jp_cb)
+        cbuf_free(jp->jp_cb);
+    if (jp->jp_xvec)
+        free(jp->jp_xvec);
+    return 0;
+}
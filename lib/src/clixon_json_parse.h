@@ -40,34 +40,24 @@
  * Types
  */
 
-struct clixon_json_yacc {
-    int        jy_linenum;      /* Number of \n in parsed buffer */
-    char      *jy_parse_string; /* original (copy of) parse string */
-    void      *jy_lexbuf;       /* internal parse buffer from lex */
-    cxobj     *jy_xtop;         /* cxobj top element (fixed) */
-    cxobj     *jy_current;      /* cxobj active element (changes with parse context) */
-    cxobj    **jy_xvec;         /* Vector of created top-level nodes (to know which are created) */
-    int        jy_xlen;         /* Length of jy_xvec */
-    cbuf      *jy_cbuf_str;     /* cbuf used for strings, if error needs to be deallocated */
+struct clixon_json_parser {
+    int        jp_linenum;      /* Number of \n in parsed buffer */
+    char      *jp_parse_string; /* original parse string */
+    char      *jp_ptr;          /* Current position in parse string */
+    int        jp_depth;        /* Nesting of objects and arrays */
+    cbuf      *jp_cb;           /* Buffer for current string or number */
+    cxobj     *jp_xtop;         /* cxobj top element (fixed) */
+    cxobj     *jp_current;      /* cxobj active element (changes with parse context) */
+    cxobj    **jp_xvec;         /* Vector of created top-level nodes (to know which are created) */
+    int        jp_xlen;         /* Length of jp_xvec */
 };
-typedef struct clixon_json_yacc clixon_json_yacc;
-
-/*
- * Variables
- */
-extern char *clixon_json_parsetext;
+typedef struct clixon_json_parser clixon_json_parser;
 
 /*
  * Prototypes
  */
-int json_scan_init(clixon_json_yacc *jy);
-int json_scan_exit(clixon_json_yacc *jy);
-
-int json_parse_init(clixon_json_yacc *jy);
-int json_parse_exit(clixon_json_yacc *jy);
-
-int clixon_json_parselex(void *);
-int clixon_json_parseparse(void *);
-void clixon_json_parseerror(void *, char*);
+int json_parse_init(clixon_json_parser *jp, char *str, cxobj *xt);
+int json_parse(clixon_json_parser *jp);
+int json_parse_exit(clixon_json_parser *jp);
 
 #endif  /* _CLIXON_JSON_PARSE_H_ */
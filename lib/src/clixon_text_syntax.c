@@ -751,7 +751,7 @@ text_diff2cbuf(cbuf  *cb,
         eq = xml_cmp(x0c, x1c, 0, 0, NULL);
         b0 = xml_body(x0c);
         b1 = xml_body(x1c);
-        if (eq && y0c && y1c && y0c == y1c && yang_find(y0c, Y_ORDERED_BY, "user")){
+        if (eq && y0c && y1c && y0c == y1c && yang_ordered_by_user(y0c)){
             if (text_diff2cbuf_ordered_by_user(cb, x0, x1, x0c, x1c, y0c,
                                                level, skiptop) < 0)
                 goto done;
@@ -1203,7 +1203,7 @@ clixon_text_syntax_parse_file(FILE      *fp,
     retval = 1;
  done:
     if (retval < 0 && *xt){
-        free(*xt);
+        xml_free(*xt);
         *xt = NULL;
     }
     if (textbuf)
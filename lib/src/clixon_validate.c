@@ -79,6 +79,9 @@
 #include "clixon_xml_default.h"
 #include "clixon_xml_map.h"
 #include "clixon_xml_bind.h"
+#include "clixon_xml_sort.h"
+#include "clixon_xml_vec.h"
+#include "clixon_xpath_function.h"
 #include "clixon_validate_minmax.h"
 #include "clixon_validate.h"
 
@@ -131,6 +134,7 @@ validate_leafref(cxobj     *xt,
     char        *leafrefbody;
     char        *leafbody;
     cvec        *nsc = NULL;
+    xpath_tree  *xpt = NULL;
     cbuf        *cberr = NULL;
     char        *path_arg;
     yang_stmt   *ymod;
@@ -163,9 +167,11 @@ validate_leafref(cxobj     *xt,
     }
     if ((leafrefbody = xml_body(xt)) == NULL)
         goto ok;
-    if (xml_nsctx_yang(ys, &nsc) < 0)
+    if (yang_nsctx_cache_get(ys, &nsc) < 0)
         goto done;
-    if (xpath_vec(xt, nsc, "%s", &xvec, &xlen, path_arg) < 0)
+    if (yang_xpath_cache_get(ypath, &xpt) < 0)
+        goto done;
+    if (xpath_tree_vec(xt, nsc, xpt, &xvec, &xlen) < 0)
         goto done;
     for (i = 0; i < xlen; i++) {
         x = xvec[i];
@@ -194,8 +200,6 @@ validate_leafref(cxobj     *xt,
  done:
     if (cberr)
         cbuf_free(cberr);
-    if (nsc)
-        xml_nsctx_free(nsc);
     if (xvec)
         free(xvec);
     return retval;
@@ -980,31 +984,21 @@ check_mandatory(cxobj     *xt,
     goto done;
 }
 
-/*! Validate a single XML node with yang specification for added entry
+/*! Validate a single XML node recursively, see xml_yang_validate_add
  *
- * 1. Check if mandatory leafs present as subs.
- * 2. Check leaf values, eg int ranges and string regexps.
+ * @param[in]  h     Clixon handle
  * @param[in]  xt    XML node to be validated
- * @param[out] xret  Error XML tree, as rpc-reply/rpc-error. Free with xml_free after use
+ * @param[in]  mount CLICON_YANG_SCHEMA_MOUNT option, looked up once by caller
+ * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
  * @retval     1     Validation OK
  * @retval     0     Validation failed (cbret set)
  * @retval    -1     Error
- * @code
- *   cxobj *x;
- *   cbuf *xret = NULL;
- *   if ((ret = xml_yang_validate_add(h, x, &xret)) < 0)
- *      err;
- *   if (ret == 0)
- *      fail;
- * @endcode
- * @see xml_yang_validate_all
- * @see xml_yang_validate_rpc
- * @note Should need a variant accepting cxobj **xret
  */
-int
-xml_yang_validate_add(clixon_handle h,
-                      cxobj        *xt,
-                      cxobj       **xret)
+static int
+xml_yang_validate_add1(clixon_handle h,
+                       cxobj        *xt,
+                       int           mount,
+                       cxobj       **xret)
 {
     int          retval = -1;
     cg_var      *cv = NULL;
@@ -1017,7 +1011,7 @@ xml_yang_validate_add(clixon_handle h,
     enum cv_type cvtype;
     validate_level vl = VL_NONE;
 
-    if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT")){
+    if (mount){
         if ((ret = xml_yang_mount_get(h, xt, &vl, NULL)) < 0)
             goto done;
         /* Check if validate beyond mountpoints */
@@ -1078,7 +1072,7 @@ xml_yang_validate_add(clixon_handle h,
     }
     x = NULL;
     while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
-        if ((ret = xml_yang_validate_add(h, x, xret)) < 0)
+        if ((ret = xml_yang_validate_add1(h, x, mount, xret)) < 0)
             goto done;
         if (ret == 0)
             goto fail;
@@ -1096,6 +1090,37 @@ xml_yang_validate_add(clixon_handle h,
     goto done;
 }
 
+/*! Validate a single XML node with yang specification for added entry
+ *
+ * 1. Check if mandatory leafs present as subs.
+ * 2. Check leaf values, eg int ranges and string regexps.
+ * @param[in]  xt    XML node to be validated
+ * @param[out] xret  Error XML tree, as rpc-reply/rpc-error. Free with xml_free after use
+ * @retval     1     Validation OK
+ * @retval     0     Validation failed (cbret set)
+ * @retval    -1     Error
+ * @code
+ *   cxobj *x;
+ *   cbuf *xret = NULL;
+ *   if ((ret = xml_yang_validate_add(h, x, &xret)) < 0)
+ *      err;
+ *   if (ret == 0)
+ *      fail;
+ * @endcode
+ * @see xml_yang_validate_all
+ * @see xml_yang_validate_rpc
+ * @note Should need a variant accepting cxobj **xret
+ */
+int
+xml_yang_validate_add(clixon_handle h,
+                      cxobj        *xt,
+                      cxobj       **xret)
+{
+    return xml_yang_validate_add1(h, xt,
+                                  clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"),
+                                  xret);
+}
+
 /*! Some checks done only at edit_config, eg keys in lists
  *
  * @param[in]  xt     XML tree
@@ -1198,48 +1223,172 @@ xml_yang_validate_leaf_union(clixon_handle h,
     goto done;
 }
 
-/*! Validate a single XML node with yang specification for all (not only added) entries
+/*! Validate constraints of a single XML node, not its children
  *
- * 1. Check leafrefs. Eg you delete a leaf and a leafref references it.
- * @param[in]  xt  XML node to be validated
+ * Checks when, mandatory children, leafref/identityref/union types and must of a config node
+ * @param[in]  h     Clixon handle
+ * @param[in]  xt    XML node to be validated
+ * @param[in]  yt    Yang spec of xt
  * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
  * @retval     1     Validation OK
- * @retval     0     Validation failed (cbret set)
+ * @retval     0     Validation failed (xret set)
  * @retval    -1     Error
- * @code
- *   cxobj *x;
- *   cbuf *xret = NULL;
- *   if ((ret = xml_yang_validate_all(h, x, &xret)) < 0)
- *      err;
- *   if (ret == 0)
- *      fail;
- *   xml_free(xret);
- * @endcode
- * @see xml_yang_validate_add
- * @see xml_yang_validate_rpc
+ * @see xml_yang_validate_all1  which also recurses and checks unique and min/max-elements
  */
-int
-xml_yang_validate_all(clixon_handle h,
-                      cxobj        *xt,
-                      cxobj       **xret)
+static int
+xml_yang_validate_node(clixon_handle h,
+                       cxobj        *xt,
+                       yang_stmt    *yt,
+                       cxobj       **xret)
 {
     int        retval = -1;
-    yang_stmt *yt;  /* yang node associated with xt */
     yang_stmt *yc;  /* yang child */
     yang_stmt *ye;  /* yang must error-message */
     char      *xpath;
     int        nr;
     int        ret;
+    cbuf      *cb = NULL;
+    cvec      *nsc = NULL;
+    xpath_tree *xpt = NULL;
+    int        hit = 0;
+    int        saw_node = 0;
+
+    ret = yang_check_when_xpath(xt, xml_parent(xt), yt, &hit, &nr, &xpath);
+    clixon_debug(CLIXON_DBG_XPATH, "nr:%d xpath:%s return:%d", nr, xpath, ret);
+    if (ret < 0)
+        goto done;
+
+    if (hit && nr == 0){
+        if ((cb = cbuf_new()) == NULL){
+            clixon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        cprintf(cb, "Failed WHEN condition of %s in module %s (WHEN xpath is %s)",
+                xml_name(xt),
+                yang_argument_get(ys_module(yt)),
+                xpath);
+        if (xret && netconf_operation_failed_xml(xret, "application",
+                                                 cbuf_get(cb)) < 0)
+            goto done;
+        goto fail;
+    }
+    if ((ret = check_mandatory(xt, yt, xret)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    /* Node-specific validation */
+    switch (yang_keyword_get(yt)){
+    case Y_ANYXML:
+    case Y_ANYDATA:
+        goto ok; /* No must check */
+        break;
+    case Y_LEAF:
+        /* fall thru */
+    case Y_LEAF_LIST:
+        /* Special case if leaf is leafref, then first check against
+           current xml tree
+        */
+        /* Get base type yc */
+        if (yang_type_get(yt, NULL, &yc, NULL, NULL, NULL, NULL, NULL) < 0)
+            goto done;
+        if (strcmp(yang_argument_get(yc), "leafref") == 0){
+            if ((ret = validate_leafref(xt, yt, yc, xret)) < 0)
+                goto done;
+            if (ret == 0)
+                goto fail;
+            }
+        else if (strcmp(yang_argument_get(yc), "identityref") == 0){
+            if ((ret = validate_identityref(xt, yt, yc, xret)) < 0)
+                goto done;
+            if (ret == 0)
+                goto fail;
+        }
+        else if (strcmp("union", yang_argument_get(yc)) == 0){
+            if ((ret = xml_yang_validate_leaf_union(h, xt, yt, yc, xret)) < 0)
+                goto done;
+            if (ret == 0)
+                goto fail;
+        }
+        break;
+    default:
+        break;
+    }
+    /* must sub-node RFC 7950 Sec 7.5.3. Can be several. 
+     * XXX. use yang path instead? */
+    yc = NULL;
+    while ((yc = yn_each(yt, yc)) != NULL) {
+        if (yang_keyword_get(yc) != Y_MUST)
+            continue;
+        if (!saw_node)
+            clixon_debug_xml(CLIXON_DBG_XPATH, xt, "");
+        saw_node = 1;
+
+        xpath = yang_argument_get(yc); /* "must" has xpath argument */
+        clixon_debug(CLIXON_DBG_XPATH, "xpath '%s'", xpath);
+        /* the context node is the node in the accessible tree for
+         * which the "must" statement is defined. 
+         * The set of namespace declarations is the set of all "import" statements' 
+         */
+        if (yang_nsctx_cache_get(yc, &nsc) < 0)
+            goto done;
+        if (yang_xpath_cache_get(yc, &xpt) < 0)
+            goto done;
+        clixon_debug(CLIXON_DBG_XPATH, "namespace '%s'", xml_nsctx_get(nsc, NULL));
+        nr = xpath_tree_bool(xt, nsc, xpt);
+        clixon_debug(CLIXON_DBG_XPATH, "result %s", (nr < 0 ? "error" : (nr != 0 ? "true" : "false")));
+        if (nr < 0)
+            goto done;
+        if (!nr){
+            ye = yang_find(yc, Y_ERROR_MESSAGE, NULL);
+            if ((cb = cbuf_new()) == NULL){
+                clixon_err(OE_UNIX, errno, "cbuf_new");
+                goto done;
+            }
+            cprintf(cb, "Failed MUST xpath '%s' of '%s' in module %s",
+                    xpath, xml_name(xt),  yang_argument_get(ys_module(yt)));
+            if (xret && netconf_operation_failed_xml(xret, "application",
+                                             ye?yang_argument_get(ye):cbuf_get(cb)) < 0)
+                goto done;
+            goto fail;
+        }
+    }
+ ok:
+    retval = 1;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Validate a single XML node recursively, see xml_yang_validate_all
+ *
+ * @param[in]  h     Clixon handle
+ * @param[in]  xt    XML node to be validated
+ * @param[in]  mount CLICON_YANG_SCHEMA_MOUNT option, looked up once by caller
+ * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
+ * @retval     1     Validation OK
+ * @retval     0     Validation failed (cbret set)
+ * @retval    -1     Error
+ */
+static int
+xml_yang_validate_all1(clixon_handle h,
+                       cxobj        *xt,
+                       int           mount,
+                       cxobj       **xret)
+{
+    int        retval = -1;
+    yang_stmt *yt;  /* yang node associated with xt */
+    int        ret;
     cxobj     *x;
     cxobj     *xp;
     char      *ns = NULL;
     cbuf      *cb = NULL;
-    cvec      *nsc = NULL;
-    int        hit = 0;
     validate_level vl = VL_NONE;
-    int        saw_node = 0;
 
-    if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT")){
+    if (mount){
         if ((ret = xml_yang_mount_get(h, xt, &vl, NULL)) < 0)
             goto done;
         /* Check if validate beyond mountpoints */
@@ -1271,111 +1420,16 @@ xml_yang_validate_all(clixon_handle h,
         goto fail;
     }
     if (yang_config(yt) != 0){
-        ret = yang_check_when_xpath(xt, xml_parent(xt), yt, &hit, &nr, &xpath);
-        clixon_debug(CLIXON_DBG_XPATH, "nr:%d xpath:%s return:%d", nr, xpath, ret);
-        if (ret < 0)
-            goto done;
-
-        if (hit && nr == 0){
-            if ((cb = cbuf_new()) == NULL){
-                clixon_err(OE_UNIX, errno, "cbuf_new");
-                goto done;
-            }
-            cprintf(cb, "Failed WHEN condition of %s in module %s (WHEN xpath is %s)",
-                    xml_name(xt),
-                    yang_argument_get(ys_module(yt)),
-                    xpath);
-            if (xret && netconf_operation_failed_xml(xret, "application",
-                                                     cbuf_get(cb)) < 0)
-                goto done;
-            goto fail;
-        }
-        if ((ret = check_mandatory(xt, yt, xret)) < 0)
+        if ((ret = xml_yang_validate_node(h, xt, yt, xret)) < 0)
             goto done;
         if (ret == 0)
             goto fail;
-        /* Node-specific validation */
-        switch (yang_keyword_get(yt)){
-        case Y_ANYXML:
-        case Y_ANYDATA:
+        if (yang_keyword_get(yt) == Y_ANYXML || yang_keyword_get(yt) == Y_ANYDATA)
             goto ok;
-            break;
-        case Y_LEAF:
-            /* fall thru */
-        case Y_LEAF_LIST:
-            /* Special case if leaf is leafref, then first check against
-               current xml tree
-            */
-            /* Get base type yc */
-            if (yang_type_get(yt, NULL, &yc, NULL, NULL, NULL, NULL, NULL) < 0)
-                goto done;
-            if (strcmp(yang_argument_get(yc), "leafref") == 0){
-                if ((ret = validate_leafref(xt, yt, yc, xret)) < 0)
-                    goto done;
-                if (ret == 0)
-                    goto fail;
-                }
-            else if (strcmp(yang_argument_get(yc), "identityref") == 0){
-                if ((ret = validate_identityref(xt, yt, yc, xret)) < 0)
-                    goto done;
-                if (ret == 0)
-                    goto fail;
-            }
-            else if (strcmp("union", yang_argument_get(yc)) == 0){
-                if ((ret = xml_yang_validate_leaf_union(h, xt, yt, yc, xret)) < 0)
-                    goto done;
-                if (ret == 0)
-                    goto fail;
-            }
-            break;
-        default:
-            break;
-        }
-        /* must sub-node RFC 7950 Sec 7.5.3. Can be several. 
-         * XXX. use yang path instead? */
-        yc = NULL;
-        while ((yc = yn_each(yt, yc)) != NULL) {
-            if (yang_keyword_get(yc) != Y_MUST)
-                continue;
-            if (!saw_node)
-                clixon_debug_xml(CLIXON_DBG_XPATH, xt, "");
-            saw_node = 1;
-
-            xpath = yang_argument_get(yc); /* "must" has xpath argument */
-            clixon_debug(CLIXON_DBG_XPATH, "xpath '%s'", xpath);
-            /* the context node is the node in the accessible tree for
-             * which the "must" statement is defined. 
-             * The set of namespace declarations is the set of all "import" statements' 
-             */
-            if (xml_nsctx_yang(yc, &nsc) < 0)
-                goto done;
-            clixon_debug(CLIXON_DBG_XPATH, "namespace '%s'", xml_nsctx_get(nsc, NULL));
-            nr = xpath_vec_bool(xt, nsc, "%s", xpath);
-            clixon_debug(CLIXON_DBG_XPATH, "result %s", (nr < 0 ? "error" : (nr != 0 ? "true" : "false")));
-            if (nr < 0)
-                goto done;
-            if (!nr){
-                ye = yang_find(yc, Y_ERROR_MESSAGE, NULL);
-                if ((cb = cbuf_new()) == NULL){
-                    clixon_err(OE_UNIX, errno, "cbuf_new");
-                    goto done;
-                }
-                cprintf(cb, "Failed MUST xpath '%s' of '%s' in module %s",
-                        xpath, xml_name(xt),  yang_argument_get(ys_module(yt)));
-                if (xret && netconf_operation_failed_xml(xret, "application",
-                                                 ye?yang_argument_get(ye):cbuf_get(cb)) < 0)
-                    goto done;
-                goto fail;
-            }
-            if (nsc){
-                xml_nsctx_free(nsc);
-                nsc = NULL;
-            }
-        }
     }
     x = NULL;
     while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
-        if ((ret = xml_yang_validate_all(h, x, xret)) < 0)
+        if ((ret = xml_yang_validate_all1(h, x, mount, xret)) < 0)
             goto done;
         if (ret == 0)
             goto fail;
@@ -1393,14 +1447,43 @@ xml_yang_validate_all(clixon_handle h,
  done:
     if (cb)
         cbuf_free(cb);
-    if (nsc)
-        xml_nsctx_free(nsc);
     return retval;
  fail:
     retval = 0;
     goto done;
 }
 
+/*! Validate a single XML node with yang specification for all (not only added) entries
+ *
+ * 1. Check leafrefs. Eg you delete a leaf and a leafref references it.
+ * @param[in]  h     Clixon handle
+ * @param[in]  xt    XML node to be validated
+ * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
+ * @retval     1     Validation OK
+ * @retval     0     Validation failed (cbret set)
+ * @retval    -1     Error
+ * @code
+ *   cxobj *x;
+ *   cbuf *xret = NULL;
+ *   if ((ret = xml_yang_validate_all(h, x, &xret)) < 0)
+ *      err;
+ *   if (ret == 0)
+ *      fail;
+ *   xml_free(xret);
+ * @endcode
+ * @see xml_yang_validate_add
+ * @see xml_yang_validate_rpc
+ */
+int
+xml_yang_validate_all(clixon_handle h,
+                      cxobj        *xt,
+                      cxobj       **xret)
+{
+    return xml_yang_validate_all1(h, xt,
+                                  clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"),
+                                  xret);
+}
+
 /*! Validate a single XML node with yang specification
  *
  * @param[in]  h     Clixon handle
@@ -1416,10 +1499,12 @@ xml_yang_validate_all_top(clixon_handle h,
 {
     int    ret;
     cxobj *x;
+    int    mount;
 
+    mount = clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT");
     x = NULL;
     while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
-        if ((ret = xml_yang_validate_all(h, x, xret)) < 1)
+        if ((ret = xml_yang_validate_all1(h, x, mount, xret)) < 1)
             return ret;
     }
     if ((ret = xml_yang_validate_minmax(xt, 0, xret)) < 1)
@@ -1427,6 +1512,585 @@ xml_yang_validate_all_top(clixon_handle h,
     return 1;
 }
 
+/*! Vector of yang nodes marked with YANG_FLAG_DEP or YANG_FLAG_DEP_ANC, for reset
+ */
+struct validate_marks {
+    yang_stmt **vm_vec;
+    int         vm_len;
+    int         vm_max;
+};
+
+/*! Add yang node to dependency index entry of a node name
+ *
+ * @param[in]  deps  Dependency index
+ * @param[in]  name  Node name (without prefix) or "*" for any change
+ * @param[in]  ys    Yang node whose constraints depend on nodes with this name
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+validate_deps_add(clicon_hash_t *deps,
+                  const char    *name,
+                  yang_stmt     *ys)
+{
+    int         retval = -1;
+    yang_stmt **vec;
+    yang_stmt **nvec = NULL;
+    size_t      vlen = 0;
+    int         n = 0;
+    int         i;
+
+    if ((vec = clicon_hash_value(deps, name, &vlen)) != NULL){
+        n = vlen/sizeof(yang_stmt *);
+        for (i=0; i<n; i++)
+            if (vec[i] == ys)
+                goto ok;
+    }
+    if ((nvec = malloc((n+1)*sizeof(yang_stmt *))) == NULL){
+        clixon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    if (n)
+        memcpy(nvec, vec, n*sizeof(yang_stmt *));
+    nvec[n] = ys;
+    if (clicon_hash_add(deps, name, nvec, (n+1)*sizeof(yang_stmt *)) == NULL)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    if (nvec)
+        free(nvec);
+    return retval;
+}
+
+/*! Add all node names referenced by a parsed xpath to dependency index
+ *
+ * Wildcards, descendant axes, nodetest functions and deref() may reference any node and are
+ * registered under "*".
+ * @param[in]  xs    Parsed xpath
+ * @param[in]  ys    Yang node whose constraints use xs
+ * @param[in]  deps  Dependency index
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+validate_deps_xpath(xpath_tree    *xs,
+                    yang_stmt     *ys,
+                    clicon_hash_t *deps)
+{
+    char *name = NULL;
+
+    if (xs == NULL)
+        return 0;
+    switch (xs->xs_type){
+    case XP_NODE:
+        name = xs->xs_s1;
+        break;
+    case XP_NODE_FN:
+        name = "*";
+        break;
+    case XP_PRIME_FN:
+        if (xs->xs_int == XPATHFN_DEREF)
+            name = "*";
+        break;
+    case XP_ABSPATH:
+    case XP_RELLOCPATH:
+    case XP_STEP:
+        if (xs->xs_int == A_DESCENDANT || xs->xs_int == A_DESCENDANT_OR_SELF)
+            name = "*";
+        break;
+    default:
+        break;
+    }
+    if (name && validate_deps_add(deps, name, ys) < 0)
+        return -1;
+    if (validate_deps_xpath(xs->xs_c0, ys, deps) < 0)
+        return -1;
+    if (validate_deps_xpath(xs->xs_c1, ys, deps) < 0)
+        return -1;
+    return 0;
+}
+
+/*! Get the node where constraints of a yang node are validated, skipping choice and case
+ */
+static yang_stmt *
+validate_deps_node(yang_stmt *ys)
+{
+    while (ys && (yang_keyword_get(ys) == Y_CHOICE || yang_keyword_get(ys) == Y_CASE))
+        ys = yang_parent_get(ys);
+    return ys;
+}
+
+/*! Add leafref paths of a resolved type, including union members, to dependency index
+ *
+ * @param[in]  ys       Leaf or leaf-list
+ * @param[in]  yrestype Resolved type
+ * @param[in]  deps     Dependency index
+ * @retval     0        OK
+ * @retval    -1        Error
+ */
+static int
+validate_deps_type(yang_stmt     *ys,
+                   yang_stmt     *yrestype,
+                   clicon_hash_t *deps)
+{
+    yang_stmt  *ypath;
+    yang_stmt  *ytsub = NULL;
+    yang_stmt  *ytype;
+    xpath_tree *xpt;
+    char       *restype;
+
+    if (yrestype == NULL || (restype = yang_argument_get(yrestype)) == NULL)
+        return 0;
+    if (strcmp(restype, "leafref") == 0){
+        if ((ypath = yang_find(yrestype, Y_PATH, NULL)) == NULL)
+            return 0;
+        if (yang_xpath_cache_get(ypath, &xpt) < 0)
+            return -1;
+        if (validate_deps_xpath(xpt, ys, deps) < 0)
+            return -1;
+    }
+    else if (strcmp(restype, "union") == 0){
+        while ((ytsub = yn_each(yrestype, ytsub)) != NULL){
+            if (yang_keyword_get(ytsub) != Y_TYPE)
+                continue;
+            if (yang_type_resolve(ys, ys, ytsub, &ytype, NULL, NULL, NULL, NULL, NULL) < 0)
+                return -1;
+            if (validate_deps_type(ys, ytype, deps) < 0)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+/*! Build validation dependency index of a yang node and its data node descendants
+ *
+ * Maps node names referenced by must, when, leafref path and unique statements to the yang
+ * nodes whose instances need to be validated if a node with that name is changed.
+ * A when also registers the parent since mandatory checks of the parent depend on it,
+ * unique registers the parent of the list since min/max and unique of a list are checked there.
+ * @param[in]  yn    Yang node (module, data node, choice or case)
+ * @param[in]  deps  Dependency index
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+validate_deps_build(yang_stmt     *yn,
+                    clicon_hash_t *deps)
+{
+    int           retval = -1;
+    yang_stmt    *yc = NULL;
+    yang_stmt    *yp;
+    yang_stmt    *yrestype;
+    xpath_tree   *xpt = NULL;
+    xpath_tree   *xptw = NULL;
+    char         *xpath;
+    cg_var       *cv;
+    char         *str;
+    char        **vec = NULL;
+    int           nvec;
+    int           i;
+    char         *name;
+    enum rfc_6020 keyw;
+
+    yp = validate_deps_node(yang_parent_get(yn));
+    /* When of augment or uses */
+    if ((xpath = yang_when_xpath_get(yn)) != NULL){
+        if (xpath_parse(xpath, &xptw) < 0)
+            goto done;
+        if (validate_deps_xpath(xptw, validate_deps_node(yn), deps) < 0)
+            goto done;
+        if (yp && validate_deps_xpath(xptw, yp, deps) < 0)
+            goto done;
+    }
+    while ((yc = yn_each(yn, yc)) != NULL){
+        switch (keyw = yang_keyword_get(yc)){
+        case Y_MUST:
+            if (yang_xpath_cache_get(yc, &xpt) < 0)
+                goto done;
+            if (validate_deps_xpath(xpt, yn, deps) < 0)
+                goto done;
+            break;
+        case Y_WHEN:
+            if (yang_xpath_cache_get(yc, &xpt) < 0)
+                goto done;
+            if (validate_deps_xpath(xpt, validate_deps_node(yn), deps) < 0)
+                goto done;
+            if (yp && validate_deps_xpath(xpt, yp, deps) < 0)
+                goto done;
+            break;
+        case Y_TYPE:
+            if (yang_keyword_get(yn) != Y_LEAF && yang_keyword_get(yn) != Y_LEAF_LIST)
+                break;
+            if (yang_type_get(yn, NULL, &yrestype, NULL, NULL, NULL, NULL, NULL) < 0)
+                goto done;
+            if (validate_deps_type(yn, yrestype, deps) < 0)
+                goto done;
+            break;
+        case Y_UNIQUE:
+            if (yp == NULL)
+                break;
+            cv = NULL;
+            while ((cv = cvec_each(yang_cvec_get(yc), cv)) != NULL){
+                if ((str = cv_string_get(cv)) == NULL)
+                    continue;
+                if ((vec = clicon_strsep(str, "/", &nvec)) == NULL)
+                    goto done;
+                for (i=0; i<nvec; i++){
+                    if ((name = index(vec[i], ':')) != NULL)
+                        name++;
+                    else
+                        name = vec[i];
+                    if (*name && validate_deps_add(deps, name, yp) < 0)
+                        goto done;
+                }
+                free(vec);
+                vec = NULL;
+            }
+            break;
+        case Y_CONTAINER:
+        case Y_LIST:
+        case Y_LEAF:
+        case Y_LEAF_LIST:
+        case Y_ANYDATA:
+        case Y_ANYXML:
+        case Y_CHOICE:
+        case Y_CASE:
+            if (validate_deps_build(yc, deps) < 0)
+                goto done;
+            break;
+        default:
+            break;
+        }
+    }
+    retval = 0;
+ done:
+    if (vec)
+        free(vec);
+    if (xptw)
+        xpath_tree_free(xptw);
+    return retval;
+}
+
+/*! Get validation dependency index of yang spec, build it on first use
+ *
+ * @param[in]  yspec  Yang spec
+ * @param[out] depsp  Dependency index, belongs to yspec
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+validate_deps_get(yang_stmt      *yspec,
+                  clicon_hash_t **depsp)
+{
+    int            retval = -1;
+    clicon_hash_t *deps = NULL;
+    yang_stmt     *ym = NULL;
+
+    if ((deps = yang_deps_get(yspec)) == NULL){
+        if ((deps = clicon_hash_init()) == NULL)
+            goto done;
+        while ((ym = yn_each(yspec, ym)) != NULL){
+            if (yang_keyword_get(ym) != Y_MODULE &&
+                yang_keyword_get(ym) != Y_SUBMODULE)
+                continue;
+            if (validate_deps_build(ym, deps) < 0){
+                clicon_hash_free(deps);
+                goto done;
+            }
+        }
+        yang_deps_set(yspec, deps);
+    }
+    *depsp = deps;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Mark yang nodes depending on a changed node name, and their ancestors
+ *
+ * @param[in]  deps  Dependency index
+ * @param[in]  name  Name of changed node
+ * @param[in]  vm    Marked yang nodes, for reset
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+validate_deps_mark(clicon_hash_t         *deps,
+                   const char            *name,
+                   struct validate_marks *vm)
+{
+    yang_stmt **vec;
+    size_t      vlen = 0;
+    int         i;
+    yang_stmt  *ys;
+    uint16_t    flag;
+
+    if ((vec = clicon_hash_value(deps, name, &vlen)) == NULL)
+        return 0;
+    for (i=0; i<vlen/sizeof(yang_stmt *); i++){
+        flag = YANG_FLAG_DEP;
+        for (ys = vec[i]; ys != NULL; ys = yang_parent_get(ys)){
+            if (yang_flag_get(ys, flag))
+                break;
+            if (vm->vm_len == vm->vm_max){
+                vm->vm_max = vm->vm_max ? 2*vm->vm_max : 16;
+                if ((vm->vm_vec = realloc(vm->vm_vec, vm->vm_max*sizeof(yang_stmt *))) == NULL){
+                    clixon_err(OE_UNIX, errno, "realloc");
+                    return -1;
+                }
+            }
+            vm->vm_vec[vm->vm_len++] = ys;
+            yang_flag_set(ys, flag);
+            flag = YANG_FLAG_DEP_ANC;
+        }
+    }
+    return 0;
+}
+
+/*! Mark yang nodes depending on names of a changed XML node and optionally its descendants
+ */
+static int
+validate_deps_mark_xml(clicon_hash_t         *deps,
+                       cxobj                 *x,
+                       int                    recurse,
+                       struct validate_marks *vm)
+{
+    cxobj *xc = NULL;
+
+    if (validate_deps_mark(deps, xml_name(x), vm) < 0)
+        return -1;
+    if (recurse)
+        while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+            if (validate_deps_mark_xml(deps, xc, recurse, vm) < 0)
+                return -1;
+    return 0;
+}
+
+/*! Validate constraints of a single XML node and unique/min/max-elements of its children
+ *
+ * @param[in]  h     Clixon handle
+ * @param[in]  xt    XML node
+ * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
+ * @retval     1     Validation OK
+ * @retval     0     Validation failed (xret set)
+ * @retval    -1     Error
+ */
+static int
+validate_deps_check(clixon_handle h,
+                    cxobj        *xt,
+                    cxobj       **xret)
+{
+    int        ret;
+    yang_stmt *yt;
+
+    if ((yt = xml_spec(xt)) == NULL || yang_config(yt) == 0)
+        return 1;
+    if ((ret = xml_yang_validate_node(h, xt, yt, xret)) < 1)
+        return ret;
+    if (yang_keyword_get(yt) == Y_ANYXML || yang_keyword_get(yt) == Y_ANYDATA)
+        return 1;
+    return xml_yang_validate_minmax(xt, 1, xret);
+}
+
+/*! Validate all instances of marked yang nodes, only descend into marked ancestors
+ *
+ * @param[in]  h     Clixon handle
+ * @param[in]  xt    XML tree
+ * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
+ * @retval     1     Validation OK
+ * @retval     0     Validation failed (xret set)
+ * @retval    -1     Error
+ */
+static int
+validate_deps_walk(clixon_handle h,
+                   cxobj        *xt,
+                   cxobj       **xret)
+{
+    int        ret;
+    cxobj     *x = NULL;
+    yang_stmt *y;
+
+    while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
+        if ((y = xml_spec(x)) == NULL)
+            continue;
+        if (yang_flag_get(y, YANG_FLAG_DEP) &&
+            (ret = validate_deps_check(h, x, xret)) < 1)
+            return ret;
+        if (yang_flag_get(y, YANG_FLAG_DEP_ANC) &&
+            (ret = validate_deps_walk(h, x, xret)) < 1)
+            return ret;
+    }
+    return 1;
+}
+
+/*! Find node in target tree corresponding to a node in source tree
+ *
+ * @param[in]  xt    Target tree (top)
+ * @param[in]  xs    Node in source tree
+ * @param[out] xtp   Corresponding node in target tree, or NULL if not found
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+validate_target_node(cxobj  *xt,
+                     cxobj  *xs,
+                     cxobj **xtp)
+{
+    cxobj *xp = NULL;
+
+    *xtp = NULL;
+    if (xml_parent(xs) == NULL){
+        *xtp = xt;
+        return 0;
+    }
+    if (validate_target_node(xt, xml_parent(xs), &xp) < 0)
+        return -1;
+    if (xp == NULL)
+        return 0;
+    return match_base_child(xp, xs, xml_spec(xs), xtp);
+}
+
+/*! Validate a changed XML tree, only constraints that may be affected by the changes
+ *
+ * Added subtrees and changed nodes are validated as xml_yang_validate_all, and the parents of
+ * all changes are checked for mandatory, min/max-elements and unique.
+ * Must, when, leafref and unique constraints elsewhere are validated only if they reference a
+ * node name of a changed node, given by a dependency index built once per YANG spec.
+ * The unchanged part of the tree is assumed to be valid.
+ * @param[in]  h      Clixon handle
+ * @param[in]  xt     Target XML tree (top)
+ * @param[in]  dvec   Deleted nodes (in source tree)
+ * @param[in]  dlen   Length of dvec
+ * @param[in]  avec   Added nodes (in target tree)
+ * @param[in]  alen   Length of avec
+ * @param[in]  tcvec  Changed nodes (in target tree)
+ * @param[in]  clen   Length of tcvec
+ * @param[out] xret   Error XML tree (if retval=0). Free with xml_free after use
+ * @retval     1      Validation OK
+ * @retval     0      Validation failed (xret set)
+ * @retval    -1      Error
+ * @note Falls back to xml_yang_validate_all_top if schema mount is enabled
+ * @note Dependencies are node names, a constraint using the string value of a non-leaf node is
+ *       not re-validated if only a descendant of that node is changed
+ * @see xml_yang_validate_all_top  for full validation
+ */
+int
+xml_yang_validate_changes(clixon_handle h,
+                          cxobj        *xt,
+                          cxobj       **dvec,
+                          int           dlen,
+                          cxobj       **avec,
+                          int           alen,
+                          cxobj       **tcvec,
+                          int           clen,
+                          cxobj       **xret)
+{
+    int                   retval = -1;
+    yang_stmt            *yspec;
+    clicon_hash_t        *deps;
+    struct validate_marks vm = {NULL, 0, 0};
+    clixon_xvec          *xpvec = NULL;
+    cxobj                *x;
+    cxobj                *xp;
+    int                   top = 0;
+    int                   i;
+    int                   ret;
+
+    if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"))
+        return xml_yang_validate_all_top(h, xt, xret);
+    if ((yspec = clicon_dbspec_yang(h)) == NULL){
+        clixon_err(OE_YANG, ENOENT, "No yang spec");
+        goto done;
+    }
+    if (validate_deps_get(yspec, &deps) < 0)
+        goto done;
+    /* 1. Mark yang nodes whose constraints may be affected by the changes */
+    if (validate_deps_mark(deps, "*", &vm) < 0)
+        goto done;
+    for (i=0; i<dlen; i++)
+        if (validate_deps_mark_xml(deps, dvec[i], 1, &vm) < 0)
+            goto done;
+    for (i=0; i<alen; i++)
+        if (validate_deps_mark_xml(deps, avec[i], 1, &vm) < 0)
+            goto done;
+    for (i=0; i<clen; i++)
+        if (validate_deps_mark_xml(deps, tcvec[i], 0, &vm) < 0)
+            goto done;
+    /* 2. Validate added subtrees and changed nodes, and collect their parents */
+    if ((xpvec = clixon_xvec_new()) == NULL)
+        goto done;
+    for (i=0; i<alen+clen+dlen; i++){
+        if (i < alen){
+            x = avec[i];
+            if ((ret = xml_yang_validate_all1(h, x, 0, xret)) < 0)
+                goto done;
+            xp = xml_parent(x);
+        }
+        else if (i < alen+clen){
+            x = tcvec[i-alen];
+            if ((ret = validate_deps_check(h, x, xret)) < 0)
+                goto done;
+            xp = xml_parent(x);
+        }
+        else {
+            ret = 1;
+            if (validate_target_node(xt, xml_parent(dvec[i-alen-clen]), &xp) < 0)
+                goto done;
+        }
+        if (ret == 0)
+            goto fail;
+        if (xp == NULL || xml_flag(xp, XML_FLAG_TRANSIENT))
+            continue;
+        xml_flag_set(xp, XML_FLAG_TRANSIENT);
+        if (clixon_xvec_append(xpvec, xp) < 0)
+            goto done;
+    }
+    /* 3. Validate parents of changes: mandatory, unique, min/max-elements */
+    for (i=0; i<clixon_xvec_len(xpvec); i++){
+        xp = clixon_xvec_i(xpvec, i);
+        if (xp == xt){
+            top++;
+            continue;
+        }
+        if ((ret = validate_deps_check(h, xp, xret)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+    }
+    /* 4. Validate instances of affected constraints in the whole tree */
+    if ((ret = validate_deps_walk(h, xt, xret)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    for (i=0; i<vm.vm_len; i++)
+        if (yang_flag_get(vm.vm_vec[i], YANG_FLAG_DEP) &&
+            (yang_keyword_get(vm.vm_vec[i]) == Y_MODULE ||
+             yang_keyword_get(vm.vm_vec[i]) == Y_SUBMODULE))
+            top++;
+    if (top){
+        if ((ret = xml_yang_validate_minmax(xt, 0, xret)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+    }
+    retval = 1;
+ done:
+    for (i=0; i<vm.vm_len; i++)
+        yang_flag_reset(vm.vm_vec[i], YANG_FLAG_DEP|YANG_FLAG_DEP_ANC);
+    if (vm.vm_vec)
+        free(vm.vm_vec);
+    if (xpvec){
+        for (i=0; i<clixon_xvec_len(xpvec); i++)
+            xml_flag_reset(clixon_xvec_i(xpvec, i), XML_FLAG_TRANSIENT);
+        clixon_xvec_free(xpvec);
+    }
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
 /*! Check validity of outgoing RPC
  *
  * Rewrite return message if errors
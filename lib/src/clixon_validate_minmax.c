@@ -79,31 +79,205 @@
 #include "clixon_xml_bind.h"
 #include "clixon_validate_minmax.h"
 
-/*! New element last in list, check if already exists if sp return -1
+/* Counters of unique-constraint checks, see xml_yang_validate_unique_stats */
+static uint64_t _unique_hashed = 0;  /* Tuples inserted in hashed tuple sets */
+static uint64_t _unique_cmp = 0;     /* Full tuple comparisons on hash match */
+
+/*! Set of value tuples used to detect duplicates of unique constraints
  *
- * @param[in]  vec   Vector of existing entries (new is last)
- * @param[in]  i1    The new entry is placed at vec[i1]
- * @param[in]  vlen  Length of entry
- * @param[in]  sorted Sorted by system, ie sorted by key, otherwise no assumption
+ * Open addressing hash table of tuple indexes into a vector of tuples, each tuple consists of
+ * vlen (borrowed) body strings. The full hash of each tuple is stored so that tuples are only
+ * compared on equal hashes.
+ */
+struct unique_set {
+    char    **us_vec;    /* Tuples, us_vlen strings each, strings are borrowed */
+    uint32_t *us_hash;   /* Hash of each tuple in us_vec */
+    int       us_vlen;   /* Number of strings per tuple */
+    size_t    us_nr;     /* Number of tuples */
+    size_t    us_alloc;  /* Number of allocated tuples in us_vec */
+    uint32_t *us_tab;    /* Hash table, tuple index + 1, 0 is empty */
+    uint32_t  us_size;   /* Number of slots in us_tab, power of two */
+};
+
+/*! Hash function of a value tuple (FNV-1a, string terminators included)
+ */
+static uint32_t
+unique_tuple_hash(char **tuple,
+                  int    vlen)
+{
+    uint32_t h = 2166136261U;
+    int      v;
+    char    *s;
+
+    for (v=0; v<vlen; v++){
+        s = tuple[v];
+        do {
+            h ^= (uint8_t)*s;
+            h *= 16777619U;
+        } while (*s++);
+    }
+    return h;
+}
+
+/*! Create a unique tuple set
+ *
+ * @param[in]  us    Unique set
+ * @param[in]  vlen  Number of strings per tuple
+ * @param[in]  hint  Expected number of tuples
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+unique_set_init(struct unique_set *us,
+                int                vlen,
+                size_t             hint)
+{
+    memset(us, 0, sizeof(*us));
+    us->us_vlen = vlen;
+    us->us_size = 16;
+    while (us->us_size < 2*hint)
+        us->us_size <<= 1;
+    if ((us->us_tab = calloc(us->us_size, sizeof(uint32_t))) == NULL){
+        clixon_err(OE_UNIX, errno, "calloc");
+        return -1;
+    }
+    return 0;
+}
+
+/*! Free a unique tuple set (but not the borrowed strings)
+ */
+static void
+unique_set_free(struct unique_set *us)
+{
+    if (us->us_tab)
+        free(us->us_tab);
+    if (us->us_vec)
+        free(us->us_vec);
+    if (us->us_hash)
+        free(us->us_hash);
+}
+
+/*! Double the hash table of a unique tuple set and rehash all tuples
+ */
+static int
+unique_set_grow(struct unique_set *us)
+{
+    uint32_t *tab;
+    uint32_t  size;
+    uint32_t  j;
+    size_t    i;
+
+    size = us->us_size << 1;
+    if ((tab = calloc(size, sizeof(uint32_t))) == NULL){
+        clixon_err(OE_UNIX, errno, "calloc");
+        return -1;
+    }
+    for (i=0; i<us->us_nr; i++){
+        j = us->us_hash[i] & (size-1);
+        while (tab[j] != 0)
+            j = (j+1) & (size-1);
+        tab[j] = i+1;
+    }
+    free(us->us_tab);
+    us->us_tab = tab;
+    us->us_size = size;
+    return 0;
+}
+
+/*! Add a tuple to a unique tuple set unless an equal tuple already exists
+ *
+ * @param[in]  us    Unique set
+ * @param[in]  tuple Vector of us_vlen strings, strings are borrowed by the set
+ * @retval     1     Added, tuple is unique
+ * @retval     0     Duplicate, an equal tuple exists
+ * @retval    -1     Error
+ */
+static int
+unique_set_add(struct unique_set *us,
+               char             **tuple)
+{
+    int       vlen = us->us_vlen;
+    uint32_t  h;
+    uint32_t  j;
+    uint32_t  k;
+    char    **t;
+    int       v;
+
+    if (2*(us->us_nr+1) > us->us_size &&
+        unique_set_grow(us) < 0)
+        return -1;
+    _unique_hashed++;
+    h = unique_tuple_hash(tuple, vlen);
+    j = h & (us->us_size-1);
+    while ((k = us->us_tab[j]) != 0){
+        if (us->us_hash[k-1] == h){
+            t = &us->us_vec[(k-1)*vlen];
+            _unique_cmp++;
+            for (v=0; v<vlen; v++)
+                if (strcmp(t[v], tuple[v]) != 0)
+                    break;
+            if (v == vlen)
+                return 0;
+        }
+        j = (j+1) & (us->us_size-1);
+    }
+    if (us->us_nr == us->us_alloc){
+        us->us_alloc = us->us_alloc ? 2*us->us_alloc : 16;
+        if ((us->us_vec = realloc(us->us_vec, us->us_alloc*vlen*sizeof(char*))) == NULL){
+            clixon_err(OE_UNIX, errno, "realloc");
+            return -1;
+        }
+        if ((us->us_hash = realloc(us->us_hash, us->us_alloc*sizeof(uint32_t))) == NULL){
+            clixon_err(OE_UNIX, errno, "realloc");
+            return -1;
+        }
+    }
+    memcpy(&us->us_vec[us->us_nr*vlen], tuple, vlen*sizeof(char*));
+    us->us_hash[us->us_nr] = h;
+    us->us_tab[j] = ++us->us_nr;
+    return 1;
+}
+
+/*! Get statistics of unique constraint checks using hashed tuple sets
+ *
+ * @param[out] hashed  Number of tuples (list entries or search results) inserted in tuple sets
+ * @param[out] cmp     Number of full tuple comparisons made on hash matches
+ * @retval     0       OK
+ */
+int
+xml_yang_validate_unique_stats(uint64_t *hashed,
+                               uint64_t *cmp)
+{
+    if (hashed)
+        *hashed = _unique_hashed;
+    if (cmp)
+        *cmp = _unique_cmp;
+    return 0;
+}
+
+/*! Collect search results of one list entry, check if any already exists
+ *
+ * @param[in]  x     List entry
+ * @param[in]  xpath Descendant schema node identifier as canonical xpath
+ * @param[in]  nsc   Namespace context of xpath
+ * @param[in]  us    Unique set of search results of previous entries, new results are added
  * @retval     1     Validation OK
- * @retval     0     Validation failed (cbret set)
+ * @retval     0     Validation failed, duplicate found
  * @retval    -1     Error
- * @note This is currently quadratic complexity. It could be improved by inserting new element sorted and binary search.
  */
 static int
-unique_search_xpath(cxobj  *x,
-                    char   *xpath,
-                    cvec   *nsc,
-                    char ***svec,
-                    size_t *slen)
+unique_search_xpath(cxobj             *x,
+                    char              *xpath,
+                    cvec              *nsc,
+                    struct unique_set *us)
 {
     int     retval = -1;
     cxobj **xvec = NULL;
     size_t  xveclen;
     int     i;
-    int     s;
     cxobj  *xi;
     char   *bi;
+    int     ret;
 
     /* Collect tuples */
     if (xpath_vec(x, nsc, "%s", &xvec, &xveclen, xpath) < 0)
@@ -112,20 +286,10 @@ unique_search_xpath(cxobj  *x,
         xi = xvec[i];
         if ((bi = xml_body(xi)) == NULL)
             break;
-        /* Check if bi is duplicate? 
-         * XXX: sort svec?
-         */
-        for (s=0; s<(*slen); s++){
-            if (strcmp(bi, (*svec)[s]) == 0){
-                goto fail;
-            }
-        }
-        (*slen) ++;
-        if (((*svec) = realloc((*svec), (*slen)*sizeof(char*))) == NULL){
-            clixon_err(OE_UNIX, errno, "realloc");
+        if ((ret = unique_set_add(us, &bi)) < 0)
             goto done;
-        }
-        (*svec)[(*slen)-1] = bi;
+        if (ret == 0)
+            goto fail;
     } /* i search results */
     retval = 1;
  done:
@@ -137,51 +301,35 @@ unique_search_xpath(cxobj  *x,
     goto done;
 }
 
-/*! New element last in list, return error if already exists 
+/*! New element last in list sorted by key, return error if already exists
  *
+ * Just look at previous element to see if it is duplicate (sorted by system)
  * @param[in]  vec   Vector of existing entries (new is last)
  * @param[in]  i1    The new entry is placed at vec[i1]
  * @param[in]  vlen  Length of vec
- * @param[in]  sorted Sorted by system, ie sorted by key, otherwise no assumption
  * @retval     0     OK, entry is unique
  * @retval    -1     Duplicate detected
- * @note This is currently quadratic complexity. It could be improved by inserting new element sorted and binary search.
+ * @see unique_set_add  for the general (unsorted) case
  */
 static int
 check_insert_duplicate(char **vec,
                        int    i1,
-                       int    vlen,
-                       int    sorted)
+                       int    vlen)
 {
     int i;
     int v;
     char *b;
 
-    if (sorted){
-        /* Just go look at previous element to see if it is duplicate (sorted by system) */
-        if (i1 == 0)
+    if (i1 == 0)
+        return 0;
+    i = i1-1;
+    for (v=0; v<vlen; v++){
+        b = vec[i*vlen+v];
+        if (b == NULL || strcmp(b, vec[i1*vlen+v]))
             return 0;
-        i = i1-1;
-        for (v=0; v<vlen; v++){
-            b = vec[i*vlen+v];
-            if (b == NULL || strcmp(b, vec[i1*vlen+v]))
-                return 0;
-        }
-        /* here we have passed thru all keys of previous element and they are all equal */
-        return -1;
-    }
-    else{
-        for (i=0; i<i1; i++){
-            for (v=0; v<vlen; v++){
-                b = vec[i*vlen+v];
-                if (b == NULL || strcmp(b, vec[i1*vlen+v]))
-                    break;
-            }
-            if (v==vlen) /* duplicate */
-                break;
-        }
-        return i==i1?0:-1;
     }
+    /* here we have passed thru all keys of previous element and they are all equal */
+    return -1;
 }
 
 /*! Given a list with unique constraint, detect duplicates
@@ -226,13 +374,14 @@ check_unique_list_direct(cxobj     *x,
     int       sorted;
     char     *str;
     cvec     *cvk;
+    struct unique_set us = {0,};
+    int       ret;
 
     /* If list and is sorted by system, then it is assumed elements are in key-order which is optimized
-     * Other cases are "unique" constraint or list sorted by user which is quadratic in complexity
-     * This second case COULD be optimized if binary insert is made on the vec vector.
+     * Other cases are "unique" constraint or list sorted by user which use a hashed tuple set
      */
     sorted = (yang_keyword_get(yu) == Y_LIST &&
-              yang_find(y, Y_ORDERED_BY, "user") == NULL);
+              !yang_ordered_by_user(y));
     cvk = yang_cvec_get(yu);
     /* nr of unique elements to check */
     if ((clen = cvec_len(cvk)) == 0){
@@ -243,6 +392,9 @@ check_unique_list_direct(cxobj     *x,
         clixon_err(OE_UNIX, errno, "calloc");
         goto done;
     }
+    if (!sorted &&
+        unique_set_init(&us, clen, xml_child_nr(xt)) < 0)
+        goto done;
     /* A vector is built with key-values, for each iteration check "backward" in the vector
      * for duplicates
      */
@@ -250,7 +402,6 @@ check_unique_list_direct(cxobj     *x,
     do {
         cvi = NULL;
         v = 0; /* index in each tuple */
-        /* XXX Quadratic if clen > 1 */
         while ((cvi = cvec_each(cvk, cvi)) != NULL){
             /* RFC7950: Sec 7.8.3.1: entries that do not have value for all
              * referenced leafs are not taken into account */
@@ -267,7 +418,11 @@ check_unique_list_direct(cxobj     *x,
         }
         if (cvi==NULL){
             /* Last element (i) is newly inserted, see if it is already there */
-            if (check_insert_duplicate(vec, i, clen, sorted) < 0){
+            if (sorted)
+                ret = check_insert_duplicate(vec, i, clen) < 0 ? 0 : 1;
+            else if ((ret = unique_set_add(&us, &vec[i*clen])) < 0)
+                goto done;
+            if (ret == 0){
                 if (xret && netconf_data_not_unique_xml(xret, x, cvk) < 0)
                     goto done;
                 goto fail;
@@ -280,6 +435,7 @@ check_unique_list_direct(cxobj     *x,
     /* It would be possible to cache vec here as an optimization */
     retval = 1;
  done:
+    unique_set_free(&us);
     if (vec)
         free(vec);
     return retval;
@@ -321,8 +477,7 @@ check_unique_list(cxobj     *x,
 {
     int       retval = -1;
     cg_var    *cvi; /* unique node name */
-    char     **svec = NULL; /* vector of search results */
-    size_t     slen = 0;
+    struct unique_set us = {0,}; /* set of search results */
     char      *xpath0 = NULL;
     char      *xpath1 = NULL;
     int        ret;
@@ -354,9 +509,11 @@ check_unique_list(cxobj     *x,
         goto done;
     if (ret == 0)
         goto fail; // XXX set xret
+    if (unique_set_init(&us, 1, xml_child_nr(xt)) < 0)
+        goto done;
     do {
         /* Collect search results from one */
-        if ((ret = unique_search_xpath(x, xpath1, nsc1, &svec, &slen)) < 0)
+        if ((ret = unique_search_xpath(x, xpath1, nsc1, &us)) < 0)
             goto done;
         if (ret == 0){
             if (xret && netconf_data_not_unique_xml(xret, x, cvk) < 0)
@@ -375,8 +532,7 @@ check_unique_list(cxobj     *x,
         cvec_free(nsc1);
     if (xpath1)
         free(xpath1);
-    if (svec)
-        free(svec);
+    unique_set_free(&us);
     return retval;
  fail:
     retval = 0;
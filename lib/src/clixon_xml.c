@@ -46,6 +46,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <inttypes.h>
 #include <unistd.h>
@@ -81,7 +82,7 @@
  * Constants
  */
 /* How many XML children to start with if any. Then add quadratic until threshold when
- * add linearly
+ * add with half the size
  * Heurestics: if child is body only single child is expected, but element children may
  * have siblings
  */
@@ -89,6 +90,27 @@
 #define XML_CHILDVEC_SIZE_START_ELMNT 16
 #define XML_CHILDVEC_SIZE_THRESHOLD 65536
 
+/* Child vectors with at least this many children are used as gap buffers on insert and
+ * remove: the free space is moved to where the last change was made instead of always
+ * being at the end, so consecutive changes at nearby positions do not move the whole tail.
+ */
+#define XML_CHILDVEC_GAP_THRESHOLD 1024
+
+/* Values of body and attribute nodes of at most this size (including null) are stored
+ * in the node itself, longer values are allocated separately
+ */
+#define XML_VALUE_INLINE 16
+
+/* Size and alignment in bytes of a slab of XML nodes, power of two, see XML_NODE_SLAB */
+#define XML_SLAB_SIZE 65536
+
+/* Initial number of buckets of the intern table of names and prefixes */
+#define XML_INTERN_SIZE_START 256
+
+/* Get child i of element x, taking the gap into account, no checks */
+#define XML_CHILD(x, i) (((i) < (x)->x_childvec_gap) ? (x)->x_childvec[(i)] : \
+                         (x)->x_childvec[(i) + (x)->x_childvec_max - (x)->x_childvec_len])
+
 /* Intention of these macros is to guard against access of type-specific fields 
  * As debug they can contain an assert.
  */
@@ -99,6 +121,17 @@
  * Types
  */
 
+/*! Interned string, shared by all XML nodes with same name or prefix
+ *
+ * Node names and prefixes point to xi_str. 
+ */
+struct xml_intern{
+    struct xml_intern *xi_next;  /* Next in hash bucket */
+    uint32_t           xi_hash;  /* Hash value of string */
+    uint32_t           xi_ref;   /* Reference count: number of XML nodes using it */
+    char               xi_str[]; /* Null-terminated string */
+};
+
 #ifdef XML_EXPLICIT_INDEX
 static int xml_search_index_free(cxobj *x);
 
@@ -176,12 +209,14 @@ struct xml{
     int              _x_i;          /* internal use for stable sorting:
                                        see xml_enumerate and xml_cmp */
     /*----- next is body/attribute only */
-    cbuf             *x_value_cb;  /* attribute and body nodes have values (XXX: this consumes 
-                                       memory) cv? */
+    char             *x_value;      /* attribute and body nodes have values, inline or allocated */
+    uint32_t          x_value_len;  /* Length of value (excluding null) */
+    uint32_t          x_value_max;  /* Size of allocated value, 0 if inline in struct xmlbody */
     /*----- up to here is common to all next is element only */
     struct xml      **x_childvec;   /* vector of children nodes (XXX: use clixon_vec ) */
     int               x_childvec_len;/* Number of children */
     int               x_childvec_max;/* Length of allocated vector */
+    int               x_childvec_gap;/* Start of free space in vector, equal to len if at end */
 
     cvec             *x_ns_cache;   /* Cached vector of namespaces (set by bind-yang) */
     yang_stmt        *x_spec;       /* Pointer to specification, eg yang, 
@@ -207,7 +242,10 @@ struct xmlbody{
     int              _xb_vector_i;   /* internal use: xml_child_each */
     int              _xb_i;          /* internal use for sorting: 
                                        see xml_enumerate and xml_cmp */
-    cbuf             *xb_value_cb;  /* attribute and body nodes have values */
+    char             *xb_value;      /* attribute and body nodes have values */
+    uint32_t          xb_value_len;  /* Length of value (excluding null) */
+    uint32_t          xb_value_max;  /* Size of allocated value, 0 if inline */
+    char              xb_value_buf[XML_VALUE_INLINE]; /* Short values are stored here */
 };
 
 /*
@@ -237,6 +275,137 @@ xml_type2str(enum cxobj_type type)
 /* Stats (too low-level to hang it on handle) */
 static uint64_t _stats_xml_nr = 0;
 
+#ifdef XML_NODE_SLAB
+/*! Slab of XML nodes of one size, aligned at XML_SLAB_SIZE
+ *
+ * The header is placed first in the slab, the nodes follow. The slab of a node is found
+ * by masking the node address with the slab alignment.
+ */
+struct xml_slab{
+    struct xml_slab       *sl_next;  /* Next slab with free nodes */
+    struct xml_slab       *sl_prev;  /* Previous slab with free nodes */
+    struct xml_slab_cache *sl_cache; /* Cache the slab belongs to */
+    void                  *sl_free;  /* Free list of nodes linked via first word of each node */
+    int                    sl_used;  /* Number of allocated nodes */
+};
+
+/*! Cache of slabs of one node size
+ *
+ * One empty slab is kept in the cache so that a tree built and freed repeatedly does not
+ * allocate and free a slab every time. It is freed when no node of the cache is in use.
+ */
+struct xml_slab_cache{
+    size_t           sc_size;  /* Size of one node */
+    struct xml_slab *sc_avail; /* Slabs with free nodes */
+    struct xml_slab *sc_empty; /* Cached empty slab, also in sc_avail */
+    uint64_t         sc_used;  /* Number of allocated nodes in all slabs */
+};
+
+static struct xml_slab_cache _xml_slab_elmnt = {sizeof(struct xml), NULL, NULL, 0};
+static struct xml_slab_cache _xml_slab_body = {sizeof(struct xmlbody), NULL, NULL, 0};
+
+/*! Offset of first node in a slab, header rounded up to pointer alignment */
+#define XML_SLAB_HDR ((sizeof(struct xml_slab) + sizeof(void*) - 1) & ~(sizeof(void*) - 1))
+
+/*! Allocate an XML node from a slab, allocate a new slab if no slab has free nodes
+ *
+ * @param[in]  sc    Slab cache
+ * @retval     x     Uninitialized node
+ * @retval     NULL  Error
+ */
+static void *
+xml_slab_alloc(struct xml_slab_cache *sc)
+{
+    struct xml_slab *sl;
+    char            *p;
+    void            *x;
+    size_t           i;
+    int              ret;
+
+    if ((sl = sc->sc_avail) == NULL){
+        if ((ret = posix_memalign((void**)&sl, XML_SLAB_SIZE, XML_SLAB_SIZE)) != 0){
+            clixon_err(OE_XML, ret, "posix_memalign");
+            return NULL;
+        }
+        memset(sl, 0, sizeof(*sl));
+        sl->sl_cache = sc;
+        p = (char*)sl + XML_SLAB_HDR;
+        for (i=(XML_SLAB_SIZE-XML_SLAB_HDR)/sc->sc_size; i>0; i--){
+            *(void**)(p + (i-1)*sc->sc_size) = sl->sl_free;
+            sl->sl_free = p + (i-1)*sc->sc_size;
+        }
+        sc->sc_avail = sl;
+    }
+    if (sl == sc->sc_empty)
+        sc->sc_empty = NULL;
+    x = sl->sl_free;
+    sl->sl_free = *(void**)x;
+    sl->sl_used++;
+    sc->sc_used++;
+    if (sl->sl_free == NULL){ /* Full: unlink from available slabs */
+        sc->sc_avail = sl->sl_next;
+        if (sl->sl_next)
+            sl->sl_next->sl_prev = NULL;
+        sl->sl_next = NULL;
+    }
+    return x;
+}
+
+/*! Unlink an empty slab from the available slabs of its cache and free it
+ *
+ * @param[in]  sc    Slab cache
+ * @param[in]  sl    Empty slab
+ */
+static void
+xml_slab_release(struct xml_slab_cache *sc,
+                 struct xml_slab       *sl)
+{
+    if (sl->sl_prev)
+        sl->sl_prev->sl_next = sl->sl_next;
+    else
+        sc->sc_avail = sl->sl_next;
+    if (sl->sl_next)
+        sl->sl_next->sl_prev = sl->sl_prev;
+    if (sl == sc->sc_empty)
+        sc->sc_empty = NULL;
+    free(sl);
+}
+
+/*! Return an XML node to its slab
+ *
+ * A slab that becomes empty is kept as the cached empty slab if there is none, otherwise
+ * it is freed. The cached slab is freed when no node of the cache is in use, eg on exit.
+ * @param[in]  x     Node
+ */
+static void
+xml_slab_free(void *x)
+{
+    struct xml_slab       *sl;
+    struct xml_slab_cache *sc;
+
+    sl = (struct xml_slab*)((uintptr_t)x & ~((uintptr_t)XML_SLAB_SIZE - 1));
+    sc = sl->sl_cache;
+    if (sl->sl_free == NULL){ /* Was full: link first in available slabs */
+        sl->sl_prev = NULL;
+        sl->sl_next = sc->sc_avail;
+        if (sc->sc_avail)
+            sc->sc_avail->sl_prev = sl;
+        sc->sc_avail = sl;
+    }
+    *(void**)x = sl->sl_free;
+    sl->sl_free = x;
+    sc->sc_used--;
+    if (--sl->sl_used == 0){
+        if (sc->sc_empty == NULL)
+            sc->sc_empty = sl;
+        else
+            xml_slab_release(sc, sl);
+    }
+    if (sc->sc_used == 0 && sc->sc_empty)
+        xml_slab_release(sc, sc->sc_empty);
+}
+#endif /* XML_NODE_SLAB */
+
 /*! Get global statistics about XML objects
  *
  * @param[out]  nr  Number of existing XML objects (created - freed)
@@ -262,10 +431,7 @@ xml_stats_one(cxobj    *x,
 {
     size_t sz = 0;
 
-    if (x->x_name)
-        sz += strlen(x->x_name) + 1;
-    if (x->x_prefix)
-        sz += strlen(x->x_prefix) + 1;
+    /* Names and prefixes are interned and not counted */
     switch (xml_type(x)){
     case CX_ELMNT:
         sz += sizeof(struct xml);
@@ -288,8 +454,7 @@ xml_stats_one(cxobj    *x,
     case CX_BODY:
     case CX_ATTR:
         sz += sizeof(struct xmlbody);
-        if (x->x_value_cb)
-            sz += cbuf_buflen(x->x_value_cb);
+        sz += x->x_value_max;
         break;
     default:
         break;
@@ -336,6 +501,152 @@ xml_stats(cxobj    *xt,
     return retval;
 }
 
+/* Intern table of names and prefixes, hashed on string, size is power of two */
+static struct xml_intern **_xml_intern_vec = NULL;
+static uint32_t            _xml_intern_size = 0; /* Number of buckets */
+static uint32_t            _xml_intern_nr = 0;   /* Number of interned strings */
+
+/*! Hash function for interned strings (FNV-1a)
+ */
+static uint32_t
+xml_intern_hash(const char *str)
+{
+    uint32_t h = 2166136261U;
+
+    while (*str){
+        h ^= (uint8_t)*str++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/*! Find interned string
+ *
+ * @param[in]  str   String
+ * @param[in]  hash  Hash value of str
+ * @retval     xi    Interned string
+ * @retval     NULL  Not found
+ */
+static struct xml_intern *
+xml_intern_lookup(const char *str,
+                  uint32_t    hash)
+{
+    struct xml_intern *xi;
+
+    if (_xml_intern_vec == NULL)
+        return NULL;
+    for (xi = _xml_intern_vec[hash & (_xml_intern_size-1)]; xi; xi = xi->xi_next)
+        if (xi->xi_hash == hash && strcmp(xi->xi_str, str) == 0)
+            return xi;
+    return NULL;
+}
+
+/*! Double the number of buckets of the intern table and rehash
+ *
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xml_intern_grow(void)
+{
+    struct xml_intern **vec;
+    struct xml_intern  *xi;
+    uint32_t            size;
+    uint32_t            i;
+
+    size = _xml_intern_size ? 2*_xml_intern_size : XML_INTERN_SIZE_START;
+    if ((vec = calloc(size, sizeof(*vec))) == NULL){
+        clixon_err(OE_XML, errno, "calloc");
+        return -1;
+    }
+    for (i=0; i<_xml_intern_size; i++)
+        while ((xi = _xml_intern_vec[i]) != NULL){
+            _xml_intern_vec[i] = xi->xi_next;
+            xi->xi_next = vec[xi->xi_hash & (size-1)];
+            vec[xi->xi_hash & (size-1)] = xi;
+        }
+    if (_xml_intern_vec)
+        free(_xml_intern_vec);
+    _xml_intern_vec = vec;
+    _xml_intern_size = size;
+    return 0;
+}
+
+/*! Get interned copy of a string and increment its reference count
+ *
+ * @param[in]  str   String
+ * @retval     istr  Interned string, release with xml_intern_release
+ * @retval     NULL  Error
+ */
+static char *
+xml_intern(const char *str)
+{
+    struct xml_intern *xi;
+    uint32_t           hash;
+    size_t             len;
+
+    hash = xml_intern_hash(str);
+    if ((xi = xml_intern_lookup(str, hash)) == NULL){
+        if (_xml_intern_nr >= _xml_intern_size &&
+            xml_intern_grow() < 0)
+            return NULL;
+        len = strlen(str);
+        if ((xi = malloc(sizeof(*xi) + len + 1)) == NULL){
+            clixon_err(OE_XML, errno, "malloc");
+            return NULL;
+        }
+        xi->xi_hash = hash;
+        xi->xi_ref = 0;
+        memcpy(xi->xi_str, str, len + 1);
+        xi->xi_next = _xml_intern_vec[hash & (_xml_intern_size-1)];
+        _xml_intern_vec[hash & (_xml_intern_size-1)] = xi;
+        _xml_intern_nr++;
+    }
+    xi->xi_ref++;
+    return xi->xi_str;
+}
+
+/*! Decrement reference count of interned string and free it if not used
+ *
+ * @param[in]  str   Interned string, as returned by xml_intern
+ */
+static void
+xml_intern_release(char *str)
+{
+    struct xml_intern  *xi;
+    struct xml_intern **xp;
+
+    xi = (struct xml_intern *)(str - offsetof(struct xml_intern, xi_str));
+    if (--xi->xi_ref > 0)
+        return;
+    xp = &_xml_intern_vec[xi->xi_hash & (_xml_intern_size-1)];
+    while (*xp != xi)
+        xp = &(*xp)->xi_next;
+    *xp = xi->xi_next;
+    free(xi);
+    if (--_xml_intern_nr == 0){
+        free(_xml_intern_vec);
+        _xml_intern_vec = NULL;
+        _xml_intern_size = 0;
+    }
+}
+
+/*! Find interned string without changing its reference count
+ *
+ * @param[in]  str   String
+ * @retval     istr  Interned string, can be compared by pointer to names and prefixes of nodes
+ * @retval     NULL  No XML node has this name or prefix
+ */
+static char *
+xml_intern_find(const char *str)
+{
+    struct xml_intern *xi;
+
+    if ((xi = xml_intern_lookup(str, xml_intern_hash(str))) == NULL)
+        return NULL;
+    return xi->xi_str;
+}
+
 /*
  * Access functions
  */
@@ -353,7 +664,7 @@ xml_name(cxobj *xn)
     return xn->x_name;
 }
 
-/*! Set name of xnode, name is copied
+/*! Set name of xnode, name is interned
  *
  * @param[in]  xn    xml node
  * @param[in]  name  new name, null-terminated string, copied by function
@@ -364,16 +675,13 @@ int
 xml_name_set(cxobj *xn,
              char  *name)
 {
-    if (xn->x_name){
-        free(xn->x_name);
-        xn->x_name = NULL;
-    }
-    if (name){
-        if ((xn->x_name = strdup(name)) == NULL){
-            clixon_err(OE_XML, errno, "strdup");
-            return -1;
-        }
-    }
+    char *iname = NULL;
+
+    if (name && (iname = xml_intern(name)) == NULL)
+        return -1;
+    if (xn->x_name)
+        xml_intern_release(xn->x_name);
+    xn->x_name = iname;
     return 0;
 }
 
@@ -388,7 +696,7 @@ xml_prefix(cxobj *xn)
     return xn->x_prefix;
 }
 
-/*! Set prefix of xnode, prefix is copied
+/*! Set prefix of xnode, prefix is interned
  *
  * @param[in]  xn      XML node
  * @param[in]  prefix  New prefix, null-terminated string, copied by function
@@ -399,16 +707,13 @@ int
 xml_prefix_set(cxobj *xn,
                char  *prefix)
 {
-    if (xn->x_prefix){
-        free(xn->x_prefix);
-        xn->x_prefix = NULL;
-    }
-    if (prefix){
-        if ((xn->x_prefix = strdup(prefix)) == NULL){
-            clixon_err(OE_XML, errno, "strdup");
-            return -1;
-        }
-    }
+    char *iprefix = NULL;
+
+    if (prefix && (iprefix = xml_intern(prefix)) == NULL)
+        return -1;
+    if (xn->x_prefix)
+        xml_intern_release(xn->x_prefix);
+    xn->x_prefix = iprefix;
     return 0;
 }
 
@@ -649,7 +954,61 @@ xml_value(cxobj *xn)
 {
     if (!is_bodyattr(xn))
         return NULL;
-    return xn->x_value_cb?cbuf_get(xn->x_value_cb):NULL;
+    return xn->x_value;
+}
+
+/*! Make room for a value of a body or attribute node
+ *
+ * Short values are stored inline in the node, longer are allocated and grow geometrically
+ * @param[in]  xn    xml body or attribute node
+ * @param[in]  sz    Required size including null
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xml_value_reserve(cxobj *xn,
+                  size_t sz)
+{
+    size_t max0;
+    size_t max;
+    char  *v;
+
+    if (xn->x_value == NULL && sz <= XML_VALUE_INLINE){
+        xn->x_value = ((struct xmlbody *)xn)->xb_value_buf;
+        return 0;
+    }
+    if (xn->x_value == NULL)
+        max0 = 0;
+    else
+        max0 = xn->x_value_max ? xn->x_value_max : XML_VALUE_INLINE;
+    if (sz <= max0)
+        return 0;
+    if (sz > UINT32_MAX){
+        clixon_err(OE_XML, EINVAL, "value too large");
+        return -1;
+    }
+    max = 2*max0;
+    if (max < sz)
+        max = sz;
+    if (max > UINT32_MAX)
+        max = UINT32_MAX;
+    if (xn->x_value_max){
+        if ((v = realloc(xn->x_value, max)) == NULL){
+            clixon_err(OE_XML, errno, "realloc");
+            return -1;
+        }
+    }
+    else {
+        if ((v = malloc(max)) == NULL){
+            clixon_err(OE_XML, errno, "malloc");
+            return -1;
+        }
+        if (xn->x_value) /* Copy inline value */
+            memcpy(v, xn->x_value, xn->x_value_len + 1);
+    }
+    xn->x_value = v;
+    xn->x_value_max = max;
+    return 0;
 }
 
 /*! Set value of xml node, value is copied
@@ -664,7 +1023,7 @@ xml_value_set(cxobj *xn,
               char  *val)
 {
     int    retval = -1;
-    size_t sz;
+    size_t len;
 
     if (!is_bodyattr(xn))
         return 0;
@@ -672,16 +1031,11 @@ xml_value_set(cxobj *xn,
         clixon_err(OE_XML, EINVAL, "value is NULL");
         goto done;
     }
-    sz = strlen(val)+1;
-    if (xn->x_value_cb == NULL){
-        if ((xn->x_value_cb = cbuf_new_alloc(sz)) == NULL){
-            clixon_err(OE_XML, errno, "cbuf_new");
-            goto done;
-        }
-    }
-    else
-        cbuf_reset(xn->x_value_cb);
-    cbuf_append_str(xn->x_value_cb, val);
+    len = strlen(val);
+    if (xml_value_reserve(xn, len+1) < 0)
+        goto done;
+    memmove(xn->x_value, val, len+1);
+    xn->x_value_len = len;
     retval = 0;
  done:
     return retval;
@@ -699,7 +1053,7 @@ xml_value_append(cxobj *xn,
                  char  *val)
 {
     int    retval = -1;
-    size_t sz;
+    size_t len;
 
     if (!is_bodyattr(xn))
         return 0;
@@ -707,17 +1061,11 @@ xml_value_append(cxobj *xn,
         clixon_err(OE_XML, EINVAL, "value is NULL");
         goto done;
     }
-    sz = strlen(val)+1;
-    if (xn->x_value_cb == NULL){
-        if ((xn->x_value_cb = cbuf_new_alloc(sz)) == NULL){
-            clixon_err(OE_XML, errno, "cbuf_new");
-            goto done;
-        }
-    }
-    if (cbuf_append_str(xn->x_value_cb, val) < 0){
-        clixon_err(OE_XML, errno, "cprintf");
+    len = strlen(val);
+    if (xml_value_reserve(xn, xn->x_value_len+len+1) < 0)
         goto done;
-    }
+    memcpy(xn->x_value + xn->x_value_len, val, len+1);
+    xn->x_value_len += len;
     retval = 0;
  done:
     return retval;
@@ -836,7 +1184,7 @@ xml_child_i(cxobj *xn,
     if (!is_element(xn))
         return NULL;
     if (i < xn->x_childvec_len)
-        return xn->x_childvec[i];
+        return XML_CHILD(xn, i);
     return NULL;
 }
 
@@ -879,8 +1227,12 @@ xml_child_i_set(cxobj *xt,
 {
     if (!is_element(xt))
         return NULL;
-    if (i < xt->x_childvec_len)
-        xt->x_childvec[i] = xc;
+    if (i < xt->x_childvec_len){
+        if (i < xt->x_childvec_gap)
+            xt->x_childvec[i] = xc;
+        else
+            xt->x_childvec[i + xt->x_childvec_max - xt->x_childvec_len] = xc;
+    }
     return 0;
 }
 
@@ -901,6 +1253,11 @@ xml_child_order(cxobj *xp,
 
     if (!is_element(xp))
         return -1;
+    /* Try the position of the last iteration first */
+    i = xc->_x_vector_i;
+    if (i >= 0 && i < xp->x_childvec_len && XML_CHILD(xp, i) == xc)
+        return i;
+    i = 0;
     while ((x = xml_child_each(xp, x, -1)) != NULL) {
         if (x == xc)
             return i;
@@ -956,7 +1313,7 @@ xml_child_each(cxobj           *xparent,
     if (!is_element(xparent))
         return NULL;
     for (i=xprev?xprev->_x_vector_i+1:0; i<xparent->x_childvec_len; i++){
-        xn = xparent->x_childvec[i];
+        xn = XML_CHILD(xparent, i);
         if (xn == NULL)
             continue;
         if (type != CX_ERROR && xml_type(xn) != type)
@@ -993,7 +1350,7 @@ xml_child_each_attr(cxobj  *xparent,
     if (!is_element(xparent))
         return NULL;
     for (i=xprev?xprev->_x_vector_i+1:0; i<xparent->x_childvec_len; i++){
-        xn = xparent->x_childvec[i];
+        xn = XML_CHILD(xparent, i);
         if (xn == NULL)
             continue;
         if (xml_type(xn) != CX_ATTR){
@@ -1008,6 +1365,80 @@ xml_child_each_attr(cxobj  *xparent,
     return xn;
 }
 
+/*! Move the free space of a child vector to a position
+ *
+ * @param[in]  xp  Parent XML node
+ * @param[in]  pos Position, the free space starts directly after child pos-1
+ */
+static void
+xml_childvec_gap_move(cxobj *xp,
+                      int    pos)
+{
+    int gap = xp->x_childvec_gap;
+    int gaplen = xp->x_childvec_max - xp->x_childvec_len;
+
+    if (pos < gap)
+        memmove(&xp->x_childvec[pos+gaplen], &xp->x_childvec[pos], (gap-pos)*sizeof(cxobj*));
+    else if (pos > gap)
+        memmove(&xp->x_childvec[gap], &xp->x_childvec[gap+gaplen], (pos-gap)*sizeof(cxobj*));
+    xp->x_childvec_gap = pos;
+}
+
+/*! Make room for one more child in a child vector
+ *
+ * @param[in]  xp     Parent XML node
+ * @param[in]  start  Initial size if vector is empty
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xml_childvec_grow(cxobj *xp,
+                  int    start)
+{
+    if (xp->x_childvec_len < xp->x_childvec_max)
+        return 0;
+    xp->x_childvec_gap = xp->x_childvec_len; /* Vector is full: gap is empty, move it last */
+    if (xp->x_childvec_len < XML_CHILDVEC_SIZE_THRESHOLD)
+        xp->x_childvec_max = xp->x_childvec_max?2*xp->x_childvec_max:start;
+    else
+        xp->x_childvec_max += xp->x_childvec_max/2;
+    xp->x_childvec = realloc(xp->x_childvec, xp->x_childvec_max*sizeof(cxobj*));
+    if (xp->x_childvec == NULL){
+        clixon_err(OE_XML, errno, "realloc");
+        return -1;
+    }
+    return 0;
+}
+
+/*! Insert child in vector at position, vector must have room
+ *
+ * Small vectors keep the free space last. Large vectors move the free space to the
+ * insert position, which is cheap if the previous insert or remove was nearby.
+ * @param[in]  xp  Parent XML node
+ * @param[in]  xc  Child XML node
+ * @param[in]  pos Position
+ */
+static void
+xml_childvec_insert(cxobj *xp,
+                    cxobj *xc,
+                    int    pos)
+{
+    if (xp->x_childvec_len < XML_CHILDVEC_GAP_THRESHOLD){
+        xml_childvec_gap_move(xp, xp->x_childvec_len);
+        memmove(&xp->x_childvec[pos+1], &xp->x_childvec[pos],
+                (xp->x_childvec_len - pos)*sizeof(cxobj *));
+        xp->x_childvec[pos] = xc;
+        xp->x_childvec_len++;
+        xp->x_childvec_gap = xp->x_childvec_len;
+    }
+    else {
+        xml_childvec_gap_move(xp, pos);
+        xp->x_childvec[pos] = xc;
+        xp->x_childvec_len++;
+        xp->x_childvec_gap++;
+    }
+}
+
 /*! Extend child vector with one and insert xml node there
  *
  * @note does not do anything with child, you may need to set its parent, etc
@@ -1028,19 +1459,9 @@ xml_child_append(cxobj *xp,
      */
     if (xml_type(xc) == CX_ELMNT)
         start = XML_CHILDVEC_SIZE_START_ELMNT;
-    xp->x_childvec_len++;
-    if (xp->x_childvec_len > xp->x_childvec_max){
-        if (xp->x_childvec_len < XML_CHILDVEC_SIZE_THRESHOLD)
-            xp->x_childvec_max = xp->x_childvec_max?2*xp->x_childvec_max:start;
-        else
-            xp->x_childvec_max += XML_CHILDVEC_SIZE_THRESHOLD;
-        xp->x_childvec = realloc(xp->x_childvec, xp->x_childvec_max*sizeof(cxobj*));
-        if (xp->x_childvec == NULL){
-            clixon_err(OE_XML, errno, "realloc");
-            return -1;
-        }
-    }
-    xp->x_childvec[xp->x_childvec_len-1] = xc;
+    if (xml_childvec_grow(xp, start) < 0)
+        return -1;
+    xml_childvec_insert(xp, xc, xp->x_childvec_len);
     return 0;
 }
 
@@ -1059,25 +1480,11 @@ xml_child_insert_pos(cxobj *xp,
                      cxobj *xc,
                      int    pos)
 {
-    size_t size;
-
     if (!is_element(xp))
         return 0;
-    xp->x_childvec_len++;
-    if (xp->x_childvec_len > xp->x_childvec_max){
-        if (xp->x_childvec_len < XML_CHILDVEC_SIZE_THRESHOLD)
-            xp->x_childvec_max = xp->x_childvec_max?2*xp->x_childvec_max:XML_CHILDVEC_SIZE_START;
-        else
-            xp->x_childvec_max += XML_CHILDVEC_SIZE_THRESHOLD;
-        xp->x_childvec = realloc(xp->x_childvec, xp->x_childvec_max*sizeof(cxobj*));
-        if (xp->x_childvec == NULL){
-            clixon_err(OE_XML, errno, "realloc");
-            return -1;
-        }
-    }
-    size = (xml_child_nr(xp) - pos - 1)*sizeof(cxobj *);
-    memmove(&xp->x_childvec[pos+1], &xp->x_childvec[pos], size);
-    xp->x_childvec[pos] = xc;
+    if (xml_childvec_grow(xp, XML_CHILDVEC_SIZE_START) < 0)
+        return -1;
+    xml_childvec_insert(xp, xc, pos);
     return 0;
 }
 
@@ -1097,6 +1504,7 @@ xml_childvec_set(cxobj *x,
         return 0;
     x->x_childvec_len = len;
     x->x_childvec_max = len;
+    x->x_childvec_gap = len;
     if (x->x_childvec)
         free(x->x_childvec);
     if ((x->x_childvec = calloc(len, sizeof(cxobj*))) == NULL){
@@ -1107,12 +1515,15 @@ xml_childvec_set(cxobj *x,
 }
 
 /*! Get the children of an XML node as an XML vector
+ *
+ * @note The vector is only valid until the children are modified
  */
 cxobj **
 xml_childvec_get(cxobj *x)
 {
     if (!is_element(x))
         return NULL;
+    xml_childvec_gap_move(x, x->x_childvec_len); /* Make vector contiguous */
     return x->x_childvec;
 }
 
@@ -1180,10 +1591,15 @@ xml_new(char           *name,
         return NULL;
         break;
     }
+#ifdef XML_NODE_SLAB
+    if ((x = xml_slab_alloc(type==CX_ELMNT?&_xml_slab_elmnt:&_xml_slab_body)) == NULL)
+        return NULL;
+#else
     if ((x = malloc(sz)) == NULL){
         clixon_err(OE_XML, errno, "malloc");
         return NULL;
     }
+#endif
     memset(x, 0, sz);
     xml_type_set(x, type);
     if (name && (xml_name_set(x, name)) < 0)
@@ -1322,8 +1738,10 @@ xml_find(cxobj *xp,
     }
     if (!is_element(xp))
         return NULL;
+    if ((name = xml_intern_find(name)) == NULL) /* No node has this name */
+        return NULL;
     while ((x = xml_child_each(xp, x, -1)) != NULL)
-        if (strcmp(name, xml_name(x)) == 0)
+        if (xml_name(x) == name)
             break; /* x is set */
     return x;
 }
@@ -1382,8 +1800,8 @@ xml_addsub(cxobj *xp,
         /* clear namespace context cache of child */
         nscache_clear(xc);
 #ifdef XML_EXPLICIT_INDEX
-    if (xml_search_index_p(xc))
-            xml_search_child_insert(xp, xc);
+        if (xml_search_index_insert(xc) < 0)
+            goto done;
 #endif
     }
     retval = 0;
@@ -1504,18 +1922,25 @@ xml_child_rm(cxobj *xp,
         clixon_err(OE_XML, 0, "Child not found");
         goto done;
     }
-    xml_parent_set(xc, NULL);
-    xp->x_childvec[i] = NULL;
-    xp->x_childvec_len--;
-    if (i<xp->x_childvec_len)
-        memmove(&xp->x_childvec[i], &xp->x_childvec[i+1], (xp->x_childvec_len-i)*sizeof(cxobj*));
 #ifdef XML_EXPLICIT_INDEX
-    if (xml_type(xc) == CX_ELMNT){
-        if (xml_search_index_p(xc))
-            xml_search_child_rm(xp, xc);
-
-    }
+    /* Must be done before parent is reset since index is kept in grandparent */
+    if (xml_search_index_rm(xc) < 0)
+        goto done;
 #endif
+    xml_parent_set(xc, NULL);
+    if (xp->x_childvec_len <= XML_CHILDVEC_GAP_THRESHOLD){
+        xml_childvec_gap_move(xp, xp->x_childvec_len);
+        xp->x_childvec[i] = NULL;
+        xp->x_childvec_len--;
+        if (i<xp->x_childvec_len)
+            memmove(&xp->x_childvec[i], &xp->x_childvec[i+1], (xp->x_childvec_len-i)*sizeof(cxobj*));
+        xp->x_childvec_gap = xp->x_childvec_len;
+    }
+    else { /* Extend free space with child i */
+        xml_childvec_gap_move(xp, i+1);
+        xp->x_childvec_gap--;
+        xp->x_childvec_len--;
+    }
     retval = 0;
  done:
     return retval;
@@ -1827,19 +2252,20 @@ xml_find_type(cxobj          *xt,
               enum cxobj_type type)
 {
     cxobj *x = NULL;
-    int    pmatch;  /* prefix match */
-    char  *xprefix; /* xprefix */
+    char  *iprefix = NULL; /* interned prefix */
+    char  *iname = NULL;   /* interned name */
 
     if (!is_element(xt))
         return NULL;
+    /* Names and prefixes of nodes are interned: if not found, no node matches */
+    if (prefix && (iprefix = xml_intern_find(prefix)) == NULL)
+        return NULL;
+    if (name && (iname = xml_intern_find(name)) == NULL)
+        return NULL;
     while ((x = xml_child_each(xt, x, type)) != NULL) {
-        if (prefix){
-            xprefix = xml_prefix(x);
-            pmatch = xprefix ? strcmp(prefix,xprefix)==0 : 0;
-        }
-        else
-            pmatch = 1;
-        if (pmatch && (name==NULL || strcmp(name, xml_name(x)) == 0))
+        if (iprefix && xml_prefix(x) != iprefix)
+            continue;
+        if (iname == NULL || xml_name(x) == iname)
             return x;
     }
     return NULL;
@@ -1868,8 +2294,10 @@ xml_find_value(cxobj      *xt,
 
     if (!is_element(xt))
         return NULL;
+    if ((name = xml_intern_find(name)) == NULL)
+        return NULL;
     while ((x = xml_child_each(xt, x, -1)) != NULL)
-        if (strcmp(name, xml_name(x)) == 0)
+        if (xml_name(x) == name)
             return xml_value(x);
     return NULL;
 }
@@ -1894,8 +2322,10 @@ xml_find_body(cxobj      *xt,
 
     if (!is_element(xt))
         return NULL;
+    if ((name = xml_intern_find(name)) == NULL)
+        return NULL;
     while ((x = xml_child_each(xt, x, -1)) != NULL)
-        if (strcmp(name, xml_name(x)) == 0)
+        if (xml_name(x) == name)
             return xml_body(x);
     return NULL;
 }
@@ -1924,8 +2354,10 @@ xml_find_body_obj(cxobj      *xt,
 
     if (!is_element(xt))
         return NULL;
+    if ((name = xml_intern_find(name)) == NULL)
+        return NULL;
     while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
-        if (strcmp(name, xml_name(x)))
+        if (xml_name(x) != name)
             continue;
         if ((bstr = xml_body(x)) == NULL)
             continue;
@@ -1950,11 +2382,12 @@ xml_free(cxobj *x)
         return 0;
     }
     if (x->x_name)
-        free(x->x_name);
+        xml_intern_release(x->x_name);
     if (x->x_prefix)
-        free(x->x_prefix);
+        xml_intern_release(x->x_prefix);
     switch (xml_type(x)){
     case CX_ELMNT:
+        xml_childvec_gap_move(x, x->x_childvec_len);
         for (i=0; i<x->x_childvec_len; i++){
             if ((xc = x->x_childvec[i]) != NULL){
                 xml_free(xc);
@@ -1973,13 +2406,17 @@ xml_free(cxobj *x)
         break;
     case CX_BODY:
     case CX_ATTR:
-        if (x->x_value_cb)
-            cbuf_free(x->x_value_cb);
+        if (x->x_value_max)
+            free(x->x_value);
         break;
     default:
         break;
     }
+#ifdef XML_NODE_SLAB
+    xml_slab_free(x);
+#else
     free(x);
+#endif
     _stats_xml_nr--;
     return 0;
 }
@@ -2061,6 +2498,12 @@ xml_copy(cxobj *x0,
             goto done;
         if (xml_copy(x, xcopy) < 0) /* recursion */
             goto done;
+#ifdef XML_EXPLICIT_INDEX
+        /* Index after recursion when the body of an index variable is copied */
+        if (xml_search_index_p(xcopy) &&
+            xml_search_child_insert(x1, xcopy) < 0)
+            goto done;
+#endif
     }
     retval = 0;
   done:
@@ -2681,8 +3124,10 @@ xml_search_child_rm(cxobj *xp,
 {
     int                 retval = -1;
     cxobj              *xpp;
+    cxobj              *x;
     char               *indexvar;
     int                 i;
+    int                 j;
     int                 len;
     struct search_index *si;
     int                  eq = 0;
@@ -2698,10 +3143,109 @@ xml_search_child_rm(cxobj *xp,
     len = clixon_xvec_len(si->si_xvec);
     if ((i = xml_search_indexvar_binary_pos(xp, indexvar, si->si_xvec, 0, len, len, &eq)) < 0)
         goto done;
-        //    if (clixon_xvec_i(si->si_xvec, i) == xp)
-    if (eq)
-        if (clixon_xvec_rm_pos(si->si_xvec, i) < 0)
+    if (eq == 0)
+        goto ok;
+    /* Index values need not be unique: find xp itself among the equal entries */
+    for (j=i; j>=0; j--){
+        if ((x = clixon_xvec_i(si->si_xvec, j)) == xp)
+            break;
+        if (xml_cmp(xp, x, 0, 0, indexvar) != 0){
+            j = -1;
+            break;
+        }
+    }
+    if (j < 0)
+        for (j=i+1; j<len; j++){
+            if ((x = clixon_xvec_i(si->si_xvec, j)) == xp)
+                break;
+            if (xml_cmp(xp, x, 0, 0, indexvar) != 0){
+                j = len;
+                break;
+            }
+        }
+    if (j >= 0 && j < len)
+        if (clixon_xvec_rm_pos(si->si_xvec, j) < 0)
+            goto done;
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Add an XML node, and the index variables it holds, to search vectors
+ *
+ * The node is either an index variable whose list element is attached, or a list
+ * element whose index variables should be added to the search vectors of its parent.
+ * Call after the node has been linked to its parent.
+ * @param[in] x   XML node
+ * @retval    0   OK
+ * @retval   -1   Error
+ * @see xml_search_index_rm
+ */
+int
+xml_search_index_insert(cxobj *x)
+{
+    int        retval = -1;
+    yang_stmt *y;
+    cxobj     *xc;
+    int        i;
+
+    if (xml_type(x) != CX_ELMNT)
+        goto ok;
+    if (xml_search_index_p(x)){
+        if (xml_search_child_insert(xml_parent(x), x) < 0)
+            goto done;
+    }
+    else if ((y = xml_spec(x)) != NULL &&
+             yang_flag_get(y, YANG_FLAG_INDEXED) &&
+             xml_parent(x) != NULL){
+        for (i=0; i<xml_child_nr(x); i++){
+            xc = xml_child_i(x, i);
+            if (xml_type(xc) == CX_ELMNT &&
+                xml_search_index_p(xc) &&
+                xml_search_child_insert(x, xc) < 0)
+                goto done;
+        }
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Remove an XML node, and the index variables it holds, from search vectors
+ *
+ * Call before the node is unlinked from its parent.
+ * @param[in] x   XML node
+ * @retval    0   OK
+ * @retval   -1   Error
+ * @see xml_search_index_insert
+ */
+int
+xml_search_index_rm(cxobj *x)
+{
+    int        retval = -1;
+    yang_stmt *y;
+    cxobj     *xc;
+    int        i;
+
+    if (xml_type(x) != CX_ELMNT)
+        goto ok;
+    if (xml_search_index_p(x)){
+        if (xml_search_child_rm(xml_parent(x), x) < 0)
             goto done;
+    }
+    else if ((y = xml_spec(x)) != NULL &&
+             yang_flag_get(y, YANG_FLAG_INDEXED) &&
+             xml_parent(x) != NULL){
+        for (i=0; i<xml_child_nr(x); i++){
+            xc = xml_child_i(x, i);
+            if (xml_type(xc) == CX_ELMNT &&
+                xml_search_index_p(xc) &&
+                xml_search_child_rm(x, xc) < 0)
+                goto done;
+        }
+    }
  ok:
     retval = 0;
  done:
@@ -360,55 +360,6 @@ populate_self_top(clixon_handle h,
     goto done;
 }
 
-/*! Find yang spec association of tree of XML nodes
- *
- * Populate xt:s children as top-level symbols
- * This may be unnecessary if yspec is set on manual creation: x=xml_new(); xml_spec_set(x,y)
- * @param[in]   h      Clixon handle (sometimes NULL)
- * @param[in]   xt     XML tree node
- * @param[in]   yb     How to bind yang to XML top-level when parsing
- * @param[in]   yspec  Yang spec
- * @param[out]  xerr   Reason for failure, or NULL
- * @retval      1      OK yang assignment made
- * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
- * @retval     -1      Error
- * @code
- *   cxobj *xerr = NULL;
- *   if (xml_bind_yang(h, x, YB_MODULE, yspec, &xerr) < 0)
- *     err;
- * @endcode
- * There are several functions in the API family
- * @see xml_bind_yang_rpc     for incoming rpc 
- * @see xml_bind_yang0        If the calling xml object should also be populated
- * @note For subs to anyxml nodes will not have spec set
- */
-int
-xml_bind_yang(clixon_handle h,
-              cxobj        *xt,
-              yang_bind     yb,
-              yang_stmt    *yspec,
-              cxobj       **xerr)
-{
-    int    retval = -1;
-    cxobj *xc;         /* xml child */
-    int    ret;
-
-    strip_body_objects(xt);
-    xc = NULL;     /* Apply on children */
-    while ((xc = xml_child_each(xt, xc, CX_ELMNT)) != NULL) {
-        if ((ret = xml_bind_yang0(h, xc, yb, yspec, xerr)) < 0)
-            goto done;
-        if (ret == 0)
-            goto fail;
-    }
-    retval = 1;
- done:
-    return retval;
- fail:
-    retval = 0;
-    goto done;
-}
-
 /*! Bind yang opt
  *
  * @param[in]   h      Clixon handle (sometimes NULL)
@@ -416,6 +367,7 @@ xml_bind_yang(clixon_handle h,
  * @param[in]   yb     How to bind yang to XML top-level when parsing
  * @param[in]   yspec  Yang spec
  * @param[in]   xsibling
+ * @param[in]   sort   If set, sort xt after binding its children
  * @param[out]  xerr   Reason for failure, or NULL
  * @retval      1      OK yang assignment made
  * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
@@ -427,6 +379,7 @@ xml_bind_yang0_opt(clixon_handle h,
                    yang_bind     yb,
                    yang_stmt    *yspec,
                    cxobj        *xsibling,
+                   int           sort,
                    cxobj       **xerr)
 {
     int        retval = -1;
@@ -501,15 +454,15 @@ xml_bind_yang0_opt(clixon_handle h,
         if (yc0 != NULL &&
             clicon_strcmp(name0, name) == 0 &&
             clicon_strcmp(prefix0, prefix) == 0){
-            if ((ret = xml_bind_yang0_opt(h, xc, ybc, yspec1, xc0, xerr)) < 0)
+            if ((ret = xml_bind_yang0_opt(h, xc, ybc, yspec1, xc0, sort, xerr)) < 0)
                 goto done;
         }
         else if (xsibling &&
                  (xs = xml_find_type(xsibling, prefix, name, CX_ELMNT)) != NULL){
-            if ((ret = xml_bind_yang0_opt(h, xc, ybc, yspec1, xs, xerr)) < 0)
+            if ((ret = xml_bind_yang0_opt(h, xc, ybc, yspec1, xs, sort, xerr)) < 0)
                 goto done;
         }
-        else if ((ret = xml_bind_yang0_opt(h, xc, ybc, yspec1, NULL, xerr)) < 0)
+        else if ((ret = xml_bind_yang0_opt(h, xc, ybc, yspec1, NULL, sort, xerr)) < 0)
             goto done;
         if (ret == 0)
             goto fail;
@@ -518,34 +471,41 @@ xml_bind_yang0_opt(clixon_handle h,
         name0 = xml_name(xc);
         prefix0 = xml_prefix(xc);
     }
- ok:
+    if (sort && xml_sort_children(xt) < 0)
+        goto done;
     retval = 1;
  done:
     return retval;
+ ok: /* Children not bound, eg anyxml or mount-point */
+    if (sort && xml_sort_recurse(xt) < 0)
+        goto done;
+    retval = 1;
+    goto done;
  fail:
     retval = 0;
     goto done;
 }
 
-/*! Find yang spec association of tree of XML nodes
+/*! Find yang spec association of a tree of XML nodes, and optionally sort
  *
  * @param[in]   h      Clixon handle (sometimes NULL)
  * @param[in]   xt     XML tree node
  * @param[in]   yb     How to bind yang to XML top-level when parsing
  * @param[in]   yspec  Yang spec
+ * @param[in]   sort   If set, sort each node after binding its children
  * @param[out]  xerr   Reason for failure, or NULL
  * @retval      1      OK yang assignment made
  * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
  * @retval     -1      Error
- * Populate xt as top-level node
- * @see xml_bind_yang  If only children of xt should be populated, not xt itself
+ * @see xml_bind_yang0
  */
-int
-xml_bind_yang0(clixon_handle h,
-               cxobj        *xt,
-               yang_bind     yb,
-               yang_stmt    *yspec,
-               cxobj       **xerr)
+static int
+xml_bind_yang01(clixon_handle h,
+                cxobj        *xt,
+                yang_bind     yb,
+                yang_stmt    *yspec,
+                int           sort,
+                cxobj       **xerr)
 {
     int        retval = -1;
     cxobj     *xc;           /* xml child */
@@ -575,20 +535,171 @@ xml_bind_yang0(clixon_handle h,
     strip_body_objects(xt);
     xc = NULL;     /* Apply on children */
     while ((xc = xml_child_each(xt, xc, CX_ELMNT)) != NULL) {
-        if ((ret = xml_bind_yang0_opt(h, xc, YB_PARENT, yspec, NULL, xerr)) < 0)
+        if ((ret = xml_bind_yang0_opt(h, xc, YB_PARENT, yspec, NULL, sort, xerr)) < 0)
             goto done;
         if (ret == 0)
             goto fail;
     }
- ok:
+    if (sort && xml_sort_children(xt) < 0)
+        goto done;
     retval = 1;
  done:
     return retval;
+ ok: /* Children not bound, eg anyxml */
+    if (sort && xml_sort_recurse(xt) < 0)
+        goto done;
+    retval = 1;
+    goto done;
  fail:
     retval = 0;
     goto done;
 }
 
+/*! Find yang spec association of children of xt, and optionally sort
+ *
+ * @param[in]   h      Clixon handle (sometimes NULL)
+ * @param[in]   xt     XML tree node
+ * @param[in]   yb     How to bind yang to XML top-level when parsing
+ * @param[in]   yspec  Yang spec
+ * @param[in]   sort   If set, sort each node after binding its children
+ * @param[out]  xerr   Reason for failure, or NULL
+ * @retval      1      OK yang assignment made
+ * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
+ * @retval     -1      Error
+ * @see xml_bind_yang
+ */
+static int
+xml_bind_yang1(clixon_handle h,
+               cxobj        *xt,
+               yang_bind     yb,
+               yang_stmt    *yspec,
+               int           sort,
+               cxobj       **xerr)
+{
+    int    retval = -1;
+    cxobj *xc;         /* xml child */
+    int    ret;
+
+    strip_body_objects(xt);
+    xc = NULL;     /* Apply on children */
+    while ((xc = xml_child_each(xt, xc, CX_ELMNT)) != NULL) {
+        if ((ret = xml_bind_yang01(h, xc, yb, yspec, sort, xerr)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+    }
+    if (sort && xml_sort_children(xt) < 0)
+        goto done;
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Find yang spec association of tree of XML nodes
+ *
+ * @param[in]   h      Clixon handle (sometimes NULL)
+ * @param[in]   xt     XML tree node
+ * @param[in]   yb     How to bind yang to XML top-level when parsing
+ * @param[in]   yspec  Yang spec
+ * @param[out]  xerr   Reason for failure, or NULL
+ * @retval      1      OK yang assignment made
+ * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
+ * @retval     -1      Error
+ * Populate xt as top-level node
+ * @see xml_bind_yang  If only children of xt should be populated, not xt itself
+ */
+int
+xml_bind_yang0(clixon_handle h,
+               cxobj        *xt,
+               yang_bind     yb,
+               yang_stmt    *yspec,
+               cxobj       **xerr)
+{
+    return xml_bind_yang01(h, xt, yb, yspec, 0, xerr);
+}
+
+/*! Find yang spec association of tree of XML nodes and sort the tree
+ *
+ * Same as xml_bind_yang0 followed by xml_sort_recurse but done in one pass
+ * @param[in]   h      Clixon handle (sometimes NULL)
+ * @param[in]   xt     XML tree node
+ * @param[in]   yb     How to bind yang to XML top-level when parsing
+ * @param[in]   yspec  Yang spec
+ * @param[out]  xerr   Reason for failure, or NULL
+ * @retval      1      OK yang assignment made and tree sorted
+ * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
+ * @retval     -1      Error
+ * @see xml_bind_yang_sort
+ */
+int
+xml_bind_yang0_sort(clixon_handle h,
+                    cxobj        *xt,
+                    yang_bind     yb,
+                    yang_stmt    *yspec,
+                    cxobj       **xerr)
+{
+    return xml_bind_yang01(h, xt, yb, yspec, 1, xerr);
+}
+
+/*! Find yang spec association of tree of XML nodes
+ *
+ * Populate xt:s children as top-level symbols
+ * This may be unnecessary if yspec is set on manual creation: x=xml_new(); xml_spec_set(x,y)
+ * @param[in]   h      Clixon handle (sometimes NULL)
+ * @param[in]   xt     XML tree node
+ * @param[in]   yb     How to bind yang to XML top-level when parsing
+ * @param[in]   yspec  Yang spec
+ * @param[out]  xerr   Reason for failure, or NULL
+ * @retval      1      OK yang assignment made
+ * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
+ * @retval     -1      Error
+ * @code
+ *   cxobj *xerr = NULL;
+ *   if (xml_bind_yang(h, x, YB_MODULE, yspec, &xerr) < 0)
+ *     err;
+ * @endcode
+ * There are several functions in the API family
+ * @see xml_bind_yang_rpc     for incoming rpc 
+ * @see xml_bind_yang0        If the calling xml object should also be populated
+ * @note For subs to anyxml nodes will not have spec set
+ */
+int
+xml_bind_yang(clixon_handle h,
+              cxobj        *xt,
+              yang_bind     yb,
+              yang_stmt    *yspec,
+              cxobj       **xerr)
+{
+    return xml_bind_yang1(h, xt, yb, yspec, 0, xerr);
+}
+
+/*! Find yang spec association of tree of XML nodes and sort the tree
+ *
+ * Same as xml_bind_yang followed by xml_sort_recurse but done in one pass: each node is
+ * sorted directly after its children are bound, while the subtree is still hot.
+ * @param[in]   h      Clixon handle (sometimes NULL)
+ * @param[in]   xt     XML tree node
+ * @param[in]   yb     How to bind yang to XML top-level when parsing
+ * @param[in]   yspec  Yang spec
+ * @param[out]  xerr   Reason for failure, or NULL
+ * @retval      1      OK yang assignment made and tree sorted
+ * @retval      0      Partial or no yang assigment made (at least one failed) and xerr set
+ * @retval     -1      Error
+ * @see xml_bind_yang
+ */
+int
+xml_bind_yang_sort(clixon_handle h,
+                   cxobj        *xt,
+                   yang_bind     yb,
+                   yang_stmt    *yspec,
+                   cxobj       **xerr)
+{
+    return xml_bind_yang1(h, xt, yb, yspec, 1, xerr);
+}
+
 /*! RPC-specific
  *
  * @param[in]   h      Clixon handle
@@ -538,6 +538,8 @@ xml_dump(FILE  *f,
  * @param[in]     prefix   Add string to beginning of each line (if pretty)
  * @param[in]     depth    Limit levels of child resources: -1 is all, 0 is none, 1 is node itself
  * @param[in]     wdef     With-defaults parameter, default is WITHDEFAULTS_REPORT_ALL
+ * @param[in]     fn       Flush callback called after each child element, or NULL
+ * @param[in]     arg      Argument to flush callback
  * @retval        0        OK
  * @retval       -1        Error
  * wdef changes the output as follows:
@@ -548,13 +550,15 @@ xml_dump(FILE  *f,
  * @see xml2file_recurse  same with FILE
  */
 static int
-xml2cbuf_recurse(cbuf             *cb,
-                 cxobj            *x,
-                 int               level,
-                 int               pretty,
-                 char             *prefix,
-                 int32_t           depth,
-                 withdefaults_type wdef)
+xml2cbuf_recurse(cbuf                 *cb,
+                 cxobj                *x,
+                 int                   level,
+                 int                   pretty,
+                 char                 *prefix,
+                 int32_t               depth,
+                 withdefaults_type     wdef,
+                 clixon_cbuf_flush_cb *fn,
+                 void                 *arg)
 {
     int        retval = -1;
     cxobj     *xc;
@@ -619,7 +623,7 @@ xml2cbuf_recurse(cbuf             *cb,
         while ((xc = xml_child_each(x, xc, -1)) != NULL)
             switch (xml_type(xc)){
             case CX_ATTR:
-                if (xml2cbuf_recurse(cb, xc, level+1, pretty, prefix, -1, wdef) < 0)
+                if (xml2cbuf_recurse(cb, xc, level+1, pretty, prefix, -1, wdef, NULL, NULL) < 0)
                     goto done;
                 break;
             case CX_BODY:
@@ -656,12 +660,14 @@ xml2cbuf_recurse(cbuf             *cb,
                             xa = xml_find_type(xc, IETF_NETCONF_WITH_DEFAULTS_ATTR_PREFIX, IETF_NETCONF_WITH_DEFAULTS_ATTR_NAMESPACE, CX_ATTR);
                         }
                     }
-                    if (xml2cbuf_recurse(cb, xc, level+1, pretty, prefix, depth-1, wdef) < 0)
+                    if (xml2cbuf_recurse(cb, xc, level+1, pretty, prefix, depth-1, wdef, fn, arg) < 0)
                         goto done;
                     if (xa){
                         if (xml_purge(xa) < 0)
                             goto done;
                     }
+                    if (fn && xml_type(xc) == CX_ELMNT && (*fn)(cb, arg) < 0)
+                        goto done;
                 }
             if (pretty && hasbody == 0){
                 if (prefix)
@@ -720,18 +726,54 @@ clixon_xml2cbuf1(cbuf                *cb,
                  int32_t              depth,
                  int                  skiptop,
                  withdefaults_type    wdef)
+{
+    return clixon_xml2cbuf_flush(cb, xn, level, pretty, prefix, depth, skiptop, wdef, NULL, NULL);
+}
+
+/*! Print an XML tree structure to a cligen buffer incrementally using a flush callback
+ *
+ * Same as clixon_xml2cbuf1 but calls fn after every encoded element so that the caller
+ * can drain the buffer, eg write it to a socket, instead of holding the whole output.
+ * @param[in,out] cb      Cligen buffer to write to
+ * @param[in]     xn      Top-level xml object
+ * @param[in]     level   Indentation level for pretty
+ * @param[in]     pretty  Insert \n and spaces to make the xml more readable.
+ * @param[in]     prefix  Add string to beginning of each line (or NULL) (if pretty)
+ * @param[in]     depth   Limit levels of child resources: -1: all, 0: none, 1: node itself
+ * @param[in]     skiptop 0: Include top object 1: Skip top-object, only children,
+ * @param[in]     wdef    With-defaults parameter, default is WITHDEFAULTS_REPORT_ALL
+ * @param[in]     fn      Flush callback, or NULL
+ * @param[in]     arg     Argument to flush callback
+ * @retval        0       OK
+ * @retval       -1       Error
+ * @note The remainder of the output is left in cb on return, caller must handle it
+ */
+int
+clixon_xml2cbuf_flush(cbuf                 *cb,
+                      cxobj                *xn,
+                      int                   level,
+                      int                   pretty,
+                      char                 *prefix,
+                      int32_t               depth,
+                      int                   skiptop,
+                      withdefaults_type     wdef,
+                      clixon_cbuf_flush_cb *fn,
+                      void                 *arg)
 {
     int    retval = -1;
     cxobj *xc;
 
     if (skiptop){
         xc = NULL;
-        while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL)
-            if (xml2cbuf_recurse(cb, xc, level, pretty, prefix, depth, wdef) < 0)
+        while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL){
+            if (xml2cbuf_recurse(cb, xc, level, pretty, prefix, depth, wdef, fn, arg) < 0)
+                goto done;
+            if (fn && (*fn)(cb, arg) < 0)
                 goto done;
+        }
     }
     else {
-        if (xml2cbuf_recurse(cb, xn, level, pretty, prefix, depth, wdef) < 0)
+        if (xml2cbuf_recurse(cb, xn, level, pretty, prefix, depth, wdef, fn, arg) < 0)
             goto done;
     }
     retval = 0;
@@ -864,10 +906,7 @@ _xml_parse(const char *str,
         clixon_err(OE_XML, errno, "Unexpected NULL XML");
         return -1;
     }
-    if ((xy.xy_parse_string = strdup(str)) == NULL){
-        clixon_err(OE_XML, errno, "strdup");
-        return -1;
-    }
+    xy.xy_parse_string = str; /* Copied by the lexer, no need to dup */
     xy.xy_xtop = xt;
     xy.xy_xparent = xt;
     xy.xy_yspec = yspec;
@@ -893,15 +932,16 @@ _xml_parse(const char *str,
         case YB_PARENT:
             /* xt:n         Has spec
              * x:   <a> <-- populate from parent
+             * Bind and sort the new subtree in one pass
              */
-            if ((ret = xml_bind_yang0(NULL, x, YB_PARENT, NULL, xerr)) < 0)
+            if ((ret = xml_bind_yang0_sort(NULL, x, YB_PARENT, NULL, xerr)) < 0)
                 goto done;
             if (ret == 0)
                 failed++;
             break;
 
         case YB_MODULE_NEXT:
-            if ((ret = xml_bind_yang(NULL, x, YB_MODULE, yspec, xerr)) < 0)
+            if ((ret = xml_bind_yang_sort(NULL, x, YB_MODULE, yspec, xerr)) < 0)
                 goto done;
             if (ret == 0)
                 failed++;
@@ -910,7 +950,7 @@ _xml_parse(const char *str,
             /* xt:<top>     nospec
              * x:   <a> <-- populate from modules
              */
-            if ((ret = xml_bind_yang0(NULL, x, YB_MODULE, yspec, xerr)) < 0)
+            if ((ret = xml_bind_yang0_sort(NULL, x, YB_MODULE, yspec, xerr)) < 0)
                 goto done;
             if (ret == 0)
                 failed++;
@@ -929,15 +969,21 @@ _xml_parse(const char *str,
     if (failed)
         goto fail;
     /* Sort the complete tree after parsing. Sorting is not really meaningful if Yang
-       not bound */
-    if (yb != YB_NONE)
+       not bound.
+       The new subtrees are already sorted when bound, so if xt was empty on entry only
+       the top-level needs sorting. */
+    if (yb == YB_RPC ||
+        (yb != YB_NONE && xml_child_nr_type(xt, CX_ELMNT) != xy.xy_xlen)){
         if (xml_sort_recurse(xt) < 0)
             goto done;
+    }
+    else if (yb != YB_NONE){
+        if (xml_sort_children(xt) < 0)
+            goto done;
+    }
     retval = 1;
  done:
     clixon_xml_parsel_exit(&xy);
-    if (xy.xy_parse_string != NULL)
-        free(xy.xy_parse_string);
     if (xy.xy_xvec)
         free(xy.xy_xvec);
     return retval;
@@ -979,16 +1025,14 @@ clixon_xml_parse_file(FILE      *fp,
                       cxobj    **xt,
                       cxobj    **xerr)
 {
-    int   retval = -1;
-    int   ret;
-    int   len = 0;
-    char  ch;
-    char *xmlbuf = NULL;
-    char *ptr;
-    int   xmlbuflen = BUFLEN; /* start size */
-    int   oldxmlbuflen;
-    int   failed = 0;
-    int   xtempty; /* empty on entry */
+    int     retval = -1;
+    int     ret;
+    char   *xmlbuf = NULL;
+    size_t  xmlbuflen = BUFLEN; /* start size */
+    size_t  len = 0;
+    size_t  n;
+    int     failed = 0;
+    int     xtempty; /* empty on entry */
 
     if (xt == NULL || fp == NULL){
         clixon_err(OE_XML, EINVAL, "arg is NULL");
@@ -1003,41 +1047,36 @@ clixon_xml_parse_file(FILE      *fp,
         clixon_err(OE_XML, errno, "malloc");
         goto done;
     }
-    memset(xmlbuf, 0, xmlbuflen);
-    ptr = xmlbuf;
+    /* Read whole file in blocks, doubling buffer as needed */
     while (1){
-        if ((ret = fread(&ch, 1, 1, fp)) < 0){
-            clixon_err(OE_XML, errno, "read");
-            break;
-        }
-        if (ret != 0){
-            xmlbuf[len++] = ch;
-        }
-        if (ret == 0) {
-            if (*xt == NULL)
-                if ((*xt = xml_new(XML_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
-                    goto done;
-            if ((ret = _xml_parse(ptr, yb, yspec, *xt, xerr)) < 0)
-                goto done;
-            if (ret == 0)
-                failed++;
-            break;
-        }
         if (len >= xmlbuflen-1){ /* Space: one for the null character */
-            oldxmlbuflen = xmlbuflen;
             xmlbuflen *= 2;
             if ((xmlbuf = realloc(xmlbuf, xmlbuflen)) == NULL){
                 clixon_err(OE_XML, errno, "realloc");
                 goto done;
             }
-            memset(xmlbuf+oldxmlbuflen, 0, xmlbuflen-oldxmlbuflen);
-            ptr = xmlbuf;
         }
-    } /* while */
+        if ((n = fread(xmlbuf+len, 1, xmlbuflen-1-len, fp)) == 0){
+            if (ferror(fp)){
+                clixon_err(OE_XML, errno, "read");
+                goto done;
+            }
+            break;
+        }
+        len += n;
+    }
+    xmlbuf[len] = '\0';
+    if (*xt == NULL)
+        if ((*xt = xml_new(XML_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
+            goto done;
+    if ((ret = _xml_parse(xmlbuf, yb, yspec, *xt, xerr)) < 0)
+        goto done;
+    if (ret == 0)
+        failed++;
     retval = (failed==0) ? 1 : 0;
  done:
     if (retval < 0 && *xt && xtempty){
-        free(*xt);
+        xml_free(*xt);
         *xt = NULL;
     }
     if (xmlbuf)
@@ -1464,7 +1503,7 @@ xml_diff2cbuf(cbuf  *cb,
         eq = xml_cmp(x0c, x1c, 0, 0, NULL);
         b0 = xml_body(x0c);
         b1 = xml_body(x1c);
-        if (eq && y0c && y1c && y0c == y1c && yang_find(y0c, Y_ORDERED_BY, "user")){
+        if (eq && y0c && y1c && y0c == y1c && yang_ordered_by_user(y0c)){
             if (xml_diff2cbuf_ordered_by_user(cb, x0, x1, x0c, x1c, y0c, level) < 0)
                 goto done;
             /* Show all marked as DELETE as - entries
@@ -422,7 +422,7 @@ xml_diff1(cxobj     *x0,
         /* Both x0c and x1c exists, check if they are yang-equal. */
         eq = xml_cmp(x0c, x1c, 0, 0, NULL);
         /* override ordered-by user with special look-ahead checks */
-        if (eq && y0c && y1c && y0c == y1c && yang_find(y0c, Y_ORDERED_BY, "user")){
+        if (eq && y0c && y1c && y0c == y1c && yang_ordered_by_user(y0c)){
             if (xml_diff_ordered_by_user(x0, x1, x0c, x1c, y0c) < 0)
                 goto done;
             /* Add all in x0 marked as DELETE in x0vec 
@@ -1967,8 +1967,8 @@ yang_check_when_xpath(cxobj        *xn,
     cxobj     *x = NULL;
     int        nr = 0;
     cvec      *nsc = NULL;
+    xpath_tree *xpt = NULL;
     int        xmalloc = 0;   /* ugly help variable to clean temporary object */
-    int        nscmalloc = 0; /* ugly help variable to remove */
 
     /* First variant */
     if ((xpath = yang_when_xpath_get(yn)) != NULL){
@@ -1988,14 +1988,20 @@ yang_check_when_xpath(cxobj        *xn,
         }
         else
             x = xn;
-        if (xml_nsctx_yang(yn, &nsc) < 0)
+        /* Namespace context and parsed xpath are cached in yang */
+        if (yang_nsctx_cache_get(yn, &nsc) < 0)
+            goto done;
+        if (yang_xpath_cache_get(yc, &xpt) < 0)
             goto done;
-        nscmalloc++;
         *hit = 1;
     }
     else
         *hit = 0;
-    if (x && xpath){
+    if (x && xpt){
+        if ((nr = xpath_tree_bool(x, nsc, xpt)) < 0)
+            goto done;
+    }
+    else if (x && xpath){
         if ((nr = xpath_vec_bool(x, nsc, "%s", xpath)) < 0)
             goto done;
     }
@@ -2007,8 +2013,6 @@ yang_check_when_xpath(cxobj        *xn,
  done:
     if (xmalloc)
         xml_purge(x);
-    if (nsc && nscmalloc)
-        xml_nsctx_free(nsc);
     return retval;
 }
 
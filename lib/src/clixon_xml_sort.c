@@ -277,7 +277,7 @@ xml_cmp(cxobj  *x1,
 #ifndef STATE_ORDERED_BY_SYSTEM
          yang_config(y1)==0 ||
 #endif
-         yang_find(y1, Y_ORDERED_BY, "user") != NULL)){
+         yang_ordered_by_user(y1))){
             equal = nr1-nr2;
             goto done; /* Ordered by user or state data : maintain existing order */
         }
@@ -427,31 +427,57 @@ xml_sort(cxobj *x)
     return 0;
 }
 
-/*! Recursively sort a tree 
+/*! Sort the children of a node unless they already are sorted, not recursive
  *
- * Alt to use xml_apply
  * @param[in]  xn      XML node
+ * @retval     1       This node is not sortable
  * @retval     0       OK
  * @retval    -1       Error
+ * @see xml_sort_recurse
  */
 int
-xml_sort_recurse(cxobj *xn)
+xml_sort_children(cxobj *xn)
 {
-    int    retval = -1;
-    cxobj *x;
-    int    ret;
+    int retval = -1;
+    int ret;
 
     ret = xml_sort_verify(xn, NULL);
     if (ret == 1) /* This node is not sortable */
-        goto ok;
+        goto notsortable;
     if (ret == -1){ /* not sorted */
         if ((ret = xml_sort(xn)) < 0)
             goto done;
         if (ret == 1) /* This node is not sortable */
-            goto ok;
+            goto notsortable;
     }
     if (xml_cv_cache_clear(xn) < 0)
         goto done;
+    retval = 0;
+ done:
+    return retval;
+ notsortable:
+    retval = 1;
+    goto done;
+}
+
+/*! Recursively sort a tree 
+ *
+ * Alt to use xml_apply
+ * @param[in]  xn      XML node
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+int
+xml_sort_recurse(cxobj *xn)
+{
+    int    retval = -1;
+    cxobj *x;
+    int    ret;
+
+    if ((ret = xml_sort_children(xn)) < 0)
+        goto done;
+    if (ret == 1) /* This node is not sortable */
+        goto ok;
     x = NULL;
     while ((x = xml_child_each(xn, x, CX_ELMNT)) != NULL) {
         if (xml_sort_recurse(x) < 0)
@@ -522,8 +548,7 @@ xml_find_keys_notsorted(cxobj   *xp,
 
 /*! Find more equal objects in a vector up and down in the array of the present
  *
- * @param[in]  childvec  Vector of children of parent
- * @param[in]  childlen  Length of child vector
+ * @param[in]  xp        Parent XML node
  * @param[in]  x1        XML node to match
  * @param[in]  yangi     Yang order number (according to spec)
  * @param[in]  mid       Where to start from (may be in middle of interval)
@@ -532,8 +557,7 @@ xml_find_keys_notsorted(cxobj   *xp,
  * @retval    -1         Error
  */
 static int
-search_multi_equals(cxobj  **childvec,
-                    size_t   childlen,
+search_multi_equals(cxobj   *xp,
                     cxobj   *x1,
                     int      yangi,
                     int      mid,
@@ -542,12 +566,13 @@ search_multi_equals(cxobj  **childvec,
 {
     int        retval = -1;
     int        i;
+    int        childlen;
     cxobj     *xc;
     yang_stmt *yc;
     int        yi;
 
     for (i=mid-1; i>=0; i--){ /* First decrement */
-        xc = childvec[i];
+        xc = xml_child_i(xp, i);
         yc = xml_spec(xc);
         if ((yi = yang_order(yc)) < -1)
             goto done;
@@ -558,8 +583,9 @@ search_multi_equals(cxobj  **childvec,
         if (clixon_xvec_prepend(xvec, xc) < 0)
             goto done;
     }
+    childlen = xml_child_nr(xp);
     for (i=mid+1; i<childlen; i++){ /* Then increment */
-        xc = childvec[i];
+        xc = xml_child_i(xp, i);
         yc = xml_spec(xc);
         if ((yi = yang_order(yc)) < -1)
             goto done;
@@ -795,8 +821,7 @@ xml_search_binary(cxobj   *xp,
         if (clixon_xvec_append(xvec, xc) < 0)
             goto done;
         /* there may be more? */
-        if (search_multi_equals(xml_childvec_get(xp), xml_child_nr(xp),
-                                x1, yangi, mid, skip1, xvec) < 0)
+        if (search_multi_equals(xp, x1, yangi, mid, skip1, xvec) < 0)
             goto done;
     }
     else if (cmp < 0)
@@ -857,7 +882,7 @@ xml_search_yang(cxobj       *xp,
     else
 #endif
         if (yang_keyword_get(yc) == Y_LIST || yang_keyword_get(yc) == Y_LEAF_LIST)
-            sorted = (yang_find(yc, Y_ORDERED_BY, "user") == NULL);
+            sorted = !yang_ordered_by_user(yc);
     if ((yangi = yang_order(yc)) < -1)
         goto done;
     if (xml_search_binary(xp, x1, sorted, yangi, low, upper, skip1, indexvar, xvec) < 0)
@@ -1104,7 +1129,7 @@ xml_insert(cxobj           *xp,
     else
 #endif
         if (yang_keyword_get(y) == Y_LIST || yang_keyword_get(y) == Y_LEAF_LIST)
-            userorder = (yang_find(y, Y_ORDERED_BY, "user") != NULL);
+            userorder = yang_ordered_by_user(y);
     if ((yi = yang_order(y)) < -1)
         goto done;
     if ((i = xml_insert2(xp, xi, y, yi,
@@ -1116,7 +1141,10 @@ xml_insert(cxobj           *xp,
     xml_parent_set(xi, xp);
     /* clear namespace context cache of child */
     nscache_clear(xi);
-
+#ifdef XML_EXPLICIT_INDEX
+    if (xml_search_index_insert(xi) < 0)
+        goto done;
+#endif
     retval = 0;
  done:
     return retval;
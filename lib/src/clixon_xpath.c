@@ -600,6 +600,44 @@ xpath_parse(const char  *xpath,
     return retval;
 }
 
+/*! Given XML tree and parsed xpath, eval it and return xpath context
+ *
+ * Use this if the same xpath is evaluated many times, eg a YANG must statement
+ * @param[in]  xcur   XML-tree where to search
+ * @param[in]  nsc    External XML namespace context, or NULL
+ * @param[in]  xptree Parsed XPath, see xpath_parse
+ * @param[in]  localonly Skip prefix and namespace tests (non-standard)
+ * @param[out] xrp    Return XPath context
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see xpath_vec_ctx
+ */
+int
+xpath_tree_ctx(cxobj      *xcur,
+               cvec       *nsc,
+               xpath_tree *xptree,
+               int         localonly,
+               xp_ctx    **xrp)
+{
+    int         retval = -1;
+    xp_ctx      xc = {0,};
+
+    xc.xc_type = XT_NODESET;
+    xc.xc_node = xcur;
+    xc.xc_initial = xcur;
+    if (cxvec_append(xcur, &xc.xc_nodeset, &xc.xc_size) < 0)
+        goto done;
+    if (xp_eval(&xc, xptree, nsc, localonly, xrp) < 0)
+        goto done;
+    retval = 0;
+ done:
+    if (xc.xc_nodeset){
+        free(xc.xc_nodeset);
+        xc.xc_nodeset = NULL;
+    }
+    return retval;
+}
+
 /*! Given XML tree and xpath, parse xpath, eval it and return xpath context, 
  *
  * This is a raw form of xpath where you can do type conversion of the return
@@ -628,29 +666,60 @@ xpath_vec_ctx(cxobj      *xcur,
 {
     int         retval = -1;
     xpath_tree *xptree = NULL;
-    xp_ctx      xc = {0,};
     
     clixon_debug(CLIXON_DBG_XPATH | CLIXON_DBG_DETAIL, "%s", xpath);
     if (xpath_parse(xpath, &xptree) < 0)
         goto done;
-    xc.xc_type = XT_NODESET;
-    xc.xc_node = xcur;
-    xc.xc_initial = xcur;
-    if (cxvec_append(xcur, &xc.xc_nodeset, &xc.xc_size) < 0)
-        goto done;
-    if (xp_eval(&xc, xptree, nsc, localonly, xrp) < 0)
+    if (xpath_tree_ctx(xcur, nsc, xptree, localonly, xrp) < 0)
         goto done;
     retval = 0;
  done:
-    if (xc.xc_nodeset){
-        free(xc.xc_nodeset);
-        xc.xc_nodeset = NULL;
-    }
     if (xptree)
         xpath_tree_free(xptree);
     return retval;
 }
 
+/*! Eval xpath and return first matching node only
+ *
+ * Plain child paths are searched depth-first and stop at the first match.
+ * @param[in]  xcur      XML tree where to search
+ * @param[in]  nsc       External XML namespace context, or NULL
+ * @param[in]  xpath     XPath syntax
+ * @param[in]  localonly Skip prefix and namespace tests (non-standard)
+ * @retval     xml-tree  XML tree of first match
+ * @retval     NULL      Error or not found
+ * @see xpath_vec_ctx
+ */
+static cxobj *
+xpath_first0(cxobj      *xcur,
+             cvec       *nsc,
+             const char *xpath,
+             int         localonly)
+{
+    cxobj      *cx = NULL;
+    xpath_tree *xptree = NULL;
+    xp_ctx     *xr = NULL;
+    int         ret;
+
+    clixon_debug(CLIXON_DBG_XPATH | CLIXON_DBG_DETAIL, "%s", xpath);
+    if (xpath_parse(xpath, &xptree) < 0)
+        goto done;
+    if ((ret = xp_eval_first(xcur, xptree, nsc, localonly, &cx)) < 0)
+        goto done;
+    if (ret == 1)
+        goto done;
+    if (xpath_tree_ctx(xcur, nsc, xptree, localonly, &xr) < 0)
+        goto done;
+    if (xr && xr->xc_type == XT_NODESET && xr->xc_size)
+        cx = xr->xc_nodeset[0];
+ done:
+    if (xr)
+        ctx_free(xr);
+    if (xptree)
+        xpath_tree_free(xptree);
+    return cx;
+}
+
 /*! XPath nodeset function where only the first matching entry is returned
  *
  * @param[in]  xcur      XML tree where to search
@@ -682,7 +751,6 @@ xpath_first(cxobj      *xcur,
     va_list    ap;
     size_t     len;
     char      *xpath = NULL;
-    xp_ctx    *xr = NULL;
     
     va_start(ap, xpformat);    
     len = vsnprintf(NULL, 0, xpformat, ap);
@@ -700,13 +768,8 @@ xpath_first(cxobj      *xcur,
         goto done;
     }
     va_end(ap);
-    if (xpath_vec_ctx(xcur, nsc, xpath, 0, &xr) < 0)
-        goto done;
-    if (xr && xr->xc_type == XT_NODESET && xr->xc_size)
-        cx = xr->xc_nodeset[0];
+    cx = xpath_first0(xcur, nsc, xpath, 0);
  done:
-    if (xr)
-        ctx_free(xr);
     if (xpath)
         free(xpath);
     return cx;
@@ -741,7 +804,6 @@ xpath_first_localonly(cxobj      *xcur,
     va_list    ap;
     size_t     len;
     char      *xpath = NULL;
-    xp_ctx    *xr = NULL;
     
     va_start(ap, xpformat);    
     len = vsnprintf(NULL, 0, xpformat, ap);
@@ -759,13 +821,8 @@ xpath_first_localonly(cxobj      *xcur,
         goto done;
     }
     va_end(ap);
-    if (xpath_vec_ctx(xcur, NULL, xpath, 1, &xr) < 0)
-        goto done;
-    if (xr && xr->xc_type == XT_NODESET && xr->xc_size)
-        cx = xr->xc_nodeset[0];
+    cx = xpath_first0(xcur, NULL, xpath, 1);
  done:
-    if (xr)
-        ctx_free(xr);
     if (xpath)
         free(xpath);
     return cx;
@@ -972,6 +1029,71 @@ xpath_vec_bool(cxobj      *xcur,
     return retval;
 }
 
+/*! Given XML tree and parsed xpath, returns boolean
+ *
+ * @param[in]  xcur   XML-tree where to search
+ * @param[in]  nsc    External XML namespace context, or NULL
+ * @param[in]  xptree Parsed XPath, see xpath_parse
+ * @retval     1      True
+ * @retval     0      False
+ * @retval    -1      Error
+ * @see xpath_vec_bool
+ */
+int
+xpath_tree_bool(cxobj      *xcur,
+                cvec       *nsc,
+                xpath_tree *xptree)
+{
+    int     retval = -1;
+    xp_ctx *xr = NULL;
+
+    if (xpath_tree_ctx(xcur, nsc, xptree, 0, &xr) < 0)
+        goto done;
+    if (xr)
+        retval = ctx2boolean(xr);
+ done:
+    if (xr)
+        ctx_free(xr);
+    return retval;
+}
+
+/*! Given XML tree and parsed xpath, returns nodeset as xml node vector
+ *
+ * @param[in]  xcur   XML-tree where to search
+ * @param[in]  nsc    External XML namespace context, or NULL
+ * @param[in]  xptree Parsed XPath, see xpath_parse
+ * @param[out] vec    Vector of xml-trees. Vector must be free():d after use
+ * @param[out] veclen Length of vector in return value
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see xpath_vec
+ */
+int
+xpath_tree_vec(cxobj      *xcur,
+               cvec       *nsc,
+               xpath_tree *xptree,
+               cxobj    ***vec,
+               size_t     *veclen)
+{
+    int     retval = -1;
+    xp_ctx *xr = NULL;
+
+    *vec = NULL;
+    *veclen = 0;
+    if (xpath_tree_ctx(xcur, nsc, xptree, 0, &xr) < 0)
+        goto done;
+    if (xr && xr->xc_type == XT_NODESET){
+        *vec    = xr->xc_nodeset;
+        xr->xc_nodeset = NULL;
+        *veclen = xr->xc_size;
+    }
+    retval = 0;
+ done:
+    if (xr)
+        ctx_free(xr);
+    return retval;
+}
+
 /*! Translate an xpath/nsc pair to a "canonical" form using yang prefixes
  *
  * @param[in]  xs      Parsed xpath - xpath_tree
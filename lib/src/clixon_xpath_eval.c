@@ -132,9 +132,6 @@ nodetest_eval_node(cxobj      *x,
     /* Namespaces is s0, name is s1 */
     if (strcmp(xs->xs_s1, "*")==0)
         return 1;
-    /* get namespace of xml tree */
-    if (xml2ns(x, prefix1, &nsxml) < 0)
-        goto done;
     prefix2 = xs->xs_s0;
     name2 = xs->xs_s1;
     /* Before going into namespaces, check name equality and filter out noteq  */
@@ -142,6 +139,9 @@ nodetest_eval_node(cxobj      *x,
         retval = 0; /* no match */
         goto done;
     }
+    /* get namespace of xml tree */
+    if (xml2ns(x, prefix1, &nsxml) < 0)
+        goto done;
     /* Here names are equal
      * Now look for namespaces
      * 1) prefix1 and prefix2 point to same namespace <<-- try this first
@@ -1410,3 +1410,211 @@ xp_eval(xp_ctx     *xc,
 } /* xp_eval */
 
 
+
+/*! Collect location steps of an xpath if it is a plain child path
+ *
+ * A plain child path is on the form a/b/c or /a/b/c, where each step has the child axis, a
+ * name test, and no predicates except ones the list optimizer may handle.
+ * @param[in]     xs     XPath node tree
+ * @param[in,out] steps  Vector of location steps in path order
+ * @param[in,out] nsteps Length of steps
+ * @param[out]    abs    Set to 1 if absolute path
+ * @retval        1      Plain child path
+ * @retval        0      Other xpath
+ * @retval       -1      Error
+ */
+static int
+xp_first_steps(xpath_tree   *xs,
+               xpath_tree ***steps,
+               int          *nsteps,
+               int          *abs)
+{
+    int          retval = -1;
+    xpath_tree **vec;
+    int          ret;
+
+    switch (xs->xs_type){
+    case XP_EXP:
+    case XP_AND:
+    case XP_RELEX:
+    case XP_ADD:
+    case XP_UNION:
+    case XP_PATHEXPR:
+    case XP_LOCPATH:
+        if (xs->xs_int != A_NAN || xs->xs_c0 == NULL || xs->xs_c1 != NULL)
+            goto ok;
+        return xp_first_steps(xs->xs_c0, steps, nsteps, abs);
+    case XP_ABSPATH:
+        if (xs->xs_int != A_ROOT || xs->xs_c0 == NULL || *nsteps != 0)
+            goto ok;
+        *abs = 1;
+        return xp_first_steps(xs->xs_c0, steps, nsteps, abs);
+    case XP_RELLOCPATH:
+        if (xs->xs_int != A_NAN || xs->xs_c0 == NULL)
+            goto ok;
+        if ((ret = xp_first_steps(xs->xs_c0, steps, nsteps, abs)) != 1)
+            return ret;
+        if (xs->xs_c1 == NULL)
+            break;
+        return xp_first_steps(xs->xs_c1, steps, nsteps, abs);
+    case XP_STEP:
+        if (xs->xs_int != A_CHILD ||
+            xs->xs_c0 == NULL || xs->xs_c0->xs_type != XP_NODE ||
+            (xs->xs_c1 != NULL && xs->xs_c1->xs_type != XP_PRED))
+            goto ok;
+        if ((vec = realloc(*steps, (*nsteps+1)*sizeof(xpath_tree *))) == NULL){
+            clixon_err(OE_UNIX, errno, "realloc");
+            goto done;
+        }
+        vec[(*nsteps)++] = xs;
+        *steps = vec;
+        break;
+    default:
+        goto ok;
+    }
+    retval = 1;
+ done:
+    return retval;
+ ok:
+    retval = 0;
+    goto done;
+}
+
+/*! Depth-first search for the first node matching a plain child path
+ *
+ * @param[in]  xv        XML node (context of step i)
+ * @param[in]  steps     Vector of location steps
+ * @param[in]  nsteps    Length of steps
+ * @param[in]  i         Current step
+ * @param[in]  nsc       XML Namespace context
+ * @param[in]  localonly Skip prefix and namespace tests (non-standard)
+ * @param[out] xfirst    First matching node, or NULL if not found
+ * @retval     1         OK, see xfirst
+ * @retval     0         A predicate could not be evaluated, use xp_eval
+ * @retval    -1         Error
+ */
+static int
+xp_first_dfs(cxobj       *xv,
+             xpath_tree **steps,
+             int          nsteps,
+             int          i,
+             cvec        *nsc,
+             int          localonly,
+             cxobj      **xfirst)
+{
+    int         retval = -1;
+    xpath_tree *xs = steps[i];
+    xpath_tree *xpred = xs->xs_c1;
+    cxobj     **vec = NULL;
+    int         veclen = 0;
+    cxobj      *x;
+    int         j;
+    int         ret;
+
+    if (xpred && (xpred->xs_c0 || xpred->xs_c1)){
+        /* Predicates: only if binary search applies */
+        if ((ret = xpath_optimize_check(xs, xv, &vec, &veclen)) < 0)
+            goto done;
+        if (ret == 0)
+            goto ok;
+        for (j=0; j<veclen; j++){
+            if (i == nsteps-1){
+                *xfirst = vec[j];
+                break;
+            }
+            if ((ret = xp_first_dfs(vec[j], steps, nsteps, i+1, nsc, localonly, xfirst)) != 1){
+                retval = ret;
+                goto done;
+            }
+            if (*xfirst)
+                break;
+        }
+    }
+    else {
+        /* Index loop, xml_child_each may be in use by caller */
+        for (j=0; j<xml_child_nr(xv); j++){
+            x = xml_child_i(xv, j);
+            if (xml_type(x) != CX_ELMNT)
+                continue;
+            if (nodetest_eval(x, xs->xs_c0, nsc, localonly) != 1)
+                continue;
+            if (i == nsteps-1){
+                *xfirst = x;
+                break;
+            }
+            if ((ret = xp_first_dfs(x, steps, nsteps, i+1, nsc, localonly, xfirst)) != 1){
+                retval = ret;
+                goto done;
+            }
+            if (*xfirst)
+                break;
+        }
+    }
+    retval = 1;
+ done:
+    if (vec)
+        free(vec);
+    return retval;
+ ok:
+    retval = 0;
+    goto done;
+}
+
+/*! Evaluate xpath and return first node only, stop at first match if possible
+ *
+ * For plain child paths a depth-first search is made without building intermediate
+ * nodesets. The first node in document order is the same as the first node of the
+ * nodeset of xp_eval.
+ * @param[in]  xcur      XML tree where to search
+ * @param[in]  xs        XPath node tree
+ * @param[in]  nsc       XML Namespace context
+ * @param[in]  localonly Skip prefix and namespace tests (non-standard)
+ * @param[out] xfirst    First matching node, or NULL if not found
+ * @retval     1         OK, see xfirst
+ * @retval     0         Not a plain child path, use xp_eval
+ * @retval    -1         Error
+ * @see xpath_first
+ */
+int
+xp_eval_first(cxobj      *xcur,
+              xpath_tree *xs,
+              cvec       *nsc,
+              int         localonly,
+              cxobj     **xfirst)
+{
+    int          retval = -1;
+    xpath_tree **steps = NULL;
+    int          nsteps = 0;
+    int          abs = 0;
+    cxobj       *x;
+    int          ret;
+
+    *xfirst = NULL;
+    if ((ret = xp_first_steps(xs, &steps, &nsteps, &abs)) < 0)
+        goto done;
+    if (ret == 0 || nsteps == 0)
+        goto ok;
+    x = xcur;
+    if (abs){
+#ifdef XML_PARENT_CANDIDATE
+        while (xml_parent(x) != NULL || xml_parent_candidate(x) != NULL)
+            x = xml_parent(x)?xml_parent(x):xml_parent_candidate(x);
+#else
+        while (xml_parent(x) != NULL)
+            x = xml_parent(x);
+#endif
+    }
+    if ((ret = xp_first_dfs(x, steps, nsteps, 0, nsc, localonly, xfirst)) < 0)
+        goto done;
+    if (ret == 0)
+        goto ok;
+    retval = 1;
+ done:
+    if (steps)
+        free(steps);
+    return retval;
+ ok:
+    *xfirst = NULL;
+    retval = 0;
+    goto done;
+}
@@ -46,5 +46,6 @@ extern const map_str2int xpopmap[];
  * Prototypes
  */
 int xp_eval(xp_ctx *xc, xpath_tree *xs, cvec *nsc, int localonly, xp_ctx **xrp);
+int xp_eval_first(cxobj *xcur, xpath_tree *xs, cvec *nsc, int localonly, cxobj **xfirst);
 
 #endif /* _CLIXON_XPATH_EVAL_H */
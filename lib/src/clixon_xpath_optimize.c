@@ -74,8 +74,10 @@
 static xpath_tree *_xmtop = NULL; /* pattern match tree top */
 static xpath_tree *_xm = NULL;
 static xpath_tree *_xe = NULL;
+static xpath_tree *_xr = NULL; /* relational expression _y='_z' of _xe */
 static int _optimize_enable = 1;
 static int _optimize_hits = 0;
+static int _optimize_index_hits = 0;
 #endif /* XPATH_LIST_OPTIMIZE */
 
 /* XXX development in clixon_xpath_eval */
@@ -89,6 +91,23 @@ xpath_list_optimize_stats(int *hits)
     return 0;
 }
 
+/*! Get and reset number of xpath lookups made using explicit search indexes
+ *
+ * Subset of the hits given by xpath_list_optimize_stats
+ * @param[out] hits  Number of lookups using a non-key search index variable
+ * @retval     0     OK
+ */
+int
+xpath_list_optimize_index_stats(int *hits)
+{
+    *hits = 0;
+#ifdef XPATH_LIST_OPTIMIZE
+    *hits = _optimize_index_hits;
+    _optimize_index_hits = 0;
+#endif
+    return 0;
+}
+
 /*! Enable xpath optimize
  *
  * Cant replace this with option since there is no handle in xpath functions,...
@@ -142,6 +161,9 @@ xpath_optimize_init(xpath_tree **xm,
         /* get expression [_y=_z] */
         if ((_xe = xpath_tree_traverse(xs, 1, -1)) == NULL)
             goto done;
+        /* get relational expression _y=_z (below EXP and AND) */
+        if ((_xr = xpath_tree_traverse(_xe, 0, 0, -1)) == NULL)
+            goto done;
         /* get keyname (_y) */
         if ((xs = xpath_tree_traverse(_xe, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1)) == NULL)
             goto done;
@@ -159,10 +181,72 @@ xpath_optimize_init(xpath_tree **xm,
 }
 
 
+/*! Recursive function to loop over and-expressions and pattern match them
+ *
+ * An and-expression is on the form: _y1='_z1' and _y2='_z2' and ...
+ * @param[in]  xa    XPath tree of type AND
+ * @param[out] cvk   Vector of <keyname>:<keyval> pairs
+ * @retval     1     Match
+ * @retval     0     No match
+ * @retval    -1     Error
+ * @see loop_preds
+ */
+static int
+loop_and(xpath_tree *xa,
+         cvec       *cvk)
+{
+    int          retval = -1;
+    int          ret;
+    xpath_tree  *xr;
+    xpath_tree **vec = NULL;
+    size_t       veclen = 0;
+    cg_var      *cvi;
+
+    if (xa->xs_type != XP_AND)
+        goto ok;
+    if (xa->xs_int == XO_AND){
+        if ((ret = loop_and(xa->xs_c0, cvk)) < 0)
+            goto done;
+        if (ret == 0)
+            goto ok;
+        xr = xa->xs_c1;
+    }
+    else if (xa->xs_int == A_NAN)
+        xr = xa->xs_c0;
+    else
+        goto ok;
+    if (xr == NULL)
+        goto ok;
+    if ((ret = xpath_tree_eq(_xr, xr, &vec, &veclen)) < 0)
+        goto done;
+    if (ret == 0)
+        goto ok;
+    if (veclen != 2)
+        goto ok;
+    if ((cvi = cvec_add(cvk, CGV_STRING)) == NULL){
+        clixon_err(OE_XML, errno, "cvec_add");
+        goto done;
+    }
+    cv_name_set(cvi, vec[0]->xs_s1);
+    if (vec[1]->xs_type == XP_PRIME_NR)
+        cv_string_set(cvi, vec[1]->xs_strnr);
+    else
+        cv_string_set(cvi, vec[1]->xs_s0);
+    retval = 1;
+ done:
+    if (vec)
+        free(vec);
+    return retval;
+ ok: /* no match, not special case */
+    retval = 0;
+    goto done;
+}
+
 /*! Recursive function to loop over all EXPR and pattern match them
  *
+ * Each predicate is an equality or an and-combination of equalities, eg:
+ *   [_y1='_z1'][_y2='_z2' and _y3='_z3']
  * @param[in]  xt    XPath tree of type PRED
- * @param[in]  xepat Pattern matching XPath tree of type EXPR
  * @param[out] cvk   Vector of <keyname>:<keyval> pairs
  * @retval     1     Match
  * @retval     0     No match
@@ -171,43 +255,89 @@ xpath_optimize_init(xpath_tree **xm,
  */
 static int
 loop_preds(xpath_tree *xt,
-           xpath_tree *xepat,
            cvec       *cvk)
 {
     int          retval = -1;
     int          ret;
     xpath_tree  *xe;
-    xpath_tree **vec = NULL;
-    size_t       veclen = 0;
-    cg_var      *cvi;
 
     if (xt->xs_type == XP_PRED && xt->xs_c0){
-        if ((ret = loop_preds(xt->xs_c0, xepat, cvk)) < 0)
+        if ((ret = loop_preds(xt->xs_c0, cvk)) < 0)
             goto done;
         if (ret == 0)
             goto ok;
     }
     if ((xe = xt->xs_c1) && (xe->xs_type == XP_EXP)){
-        if ((ret = xpath_tree_eq(xepat, xe, &vec, &veclen)) < 0)
+        /* Top-level or-expression is not handled */
+        if (xe->xs_int != A_NAN || xe->xs_c0 == NULL || xe->xs_c1 != NULL)
+            goto ok;
+        if ((ret = loop_and(xe->xs_c0, cvk)) < 0)
             goto done;
         if (ret == 0)
             goto ok;
-        if (veclen != 2)
+    }
+    retval = 1;
+ done:
+    return retval;
+ ok: /* no match, not special case */
+    retval = 0;
+    goto done;
+}
+
+/*! Rearrange predicate variables in list key order
+ *
+ * The predicate variables must be exactly all keys, or the first keys, of the list, but
+ * may be given in any order
+ * @param[in]  cvv   List keys as given by yang_cvec_get
+ * @param[in]  cvk   Vector of <keyname>:<keyval> pairs from predicates
+ * @param[out] cvk1  Vector of <keyname>:<keyval> pairs in key order. Free with cvec_free
+ * @retval     1     OK, cvk1 is set
+ * @retval     0     Not keys, cvk1 is not set
+ * @retval    -1     Error
+ */
+static int
+keys_order(cvec  *cvv,
+           cvec  *cvk,
+           cvec **cvk1)
+{
+    int     retval = -1;
+    cvec   *cvo = NULL;
+    cg_var *cvi;
+    cg_var *cvj;
+    cg_var *cv;
+    int     i;
+    int     j;
+
+    if (cvec_len(cvk) == 0 || cvec_len(cvk) > cvec_len(cvv))
+        goto ok;
+    if ((cvo = cvec_new(0)) == NULL){
+        clixon_err(OE_YANG, errno, "cvec_new");
+        goto done;
+    }
+    for (i=0; i<cvec_len(cvk); i++){
+        cvi = cvec_i(cvv, i);
+        cv = NULL;
+        for (j=0; j<cvec_len(cvk); j++){
+            cvj = cvec_i(cvk, j);
+            if (strcmp(cv_name_get(cvj), cv_string_get(cvi)) == 0){
+                if (cv != NULL) /* Same key twice */
+                    goto ok;
+                cv = cvj;
+            }
+        }
+        if (cv == NULL)
             goto ok;
-        if ((cvi = cvec_add(cvk, CGV_STRING)) == NULL){
-            clixon_err(OE_XML, errno, "cvec_add");
+        if (cvec_append_var(cvo, cv) == NULL){
+            clixon_err(OE_YANG, errno, "cvec_append_var");
             goto done;
         }
-        cv_name_set(cvi, vec[0]->xs_s1);
-        if (vec[1]->xs_type == XP_PRIME_NR)
-            cv_string_set(cvi, vec[1]->xs_strnr);
-        else
-            cv_string_set(cvi, vec[1]->xs_s0);
     }
+    *cvk1 = cvo;
+    cvo = NULL;
     retval = 1;
  done:
-    if (vec)
-        free(vec);
+    if (cvo)
+        cvec_free(cvo);
     return retval;
  ok: /* no match, not special case */
     retval = 0;
@@ -245,9 +375,11 @@ xpath_list_optimize_fn(xpath_tree  *xt,
     xpath_tree  *xtp;
     int          ret;
     cvec        *cvk = NULL; /* vector of index keys */
-    cg_var      *cvi;
-    int          i;
+    cvec        *cvk1 = NULL; /* index keys in key order */
     yang_stmt   *ypp;
+#ifdef XML_EXPLICIT_INDEX
+    yang_stmt   *yi;
+#endif
 
     /* revert to non-optimized if no yang */
     if ((yp = xml_spec(xv)) == NULL)
@@ -262,8 +394,8 @@ xpath_list_optimize_fn(xpath_tree  *xt,
             goto ok;
     } while((ypp = yang_parent_get(ypp)) != NULL);
     /* Check yang and that only a list with key as index is a special case can do bin search 
-     * That is, ONLY check optimize cases of this type:_x[_y='_z']
-     * Should we extend this simple example and have more cases (all cases?)
+     * That is, ONLY check optimize cases of this type:_x[_y='_z'], where the predicates may be
+     * several, or and-combinations, of key equalities, see loop_preds
      */
     xpath_optimize_init(&xm, &xem);
     /* Here is where pattern is checked for equality and where variable binding is made (if
@@ -289,29 +421,40 @@ xpath_list_optimize_fn(xpath_tree  *xt,
         clixon_err(OE_YANG, errno, "cvec_new");
         goto done;
     }
-    if ((ret = loop_preds(xtp, xem, cvk)) < 0)
+    if ((ret = loop_preds(xtp, cvk)) < 0)
         goto done;
     if (ret == 0)
         goto ok;
-
-    if (cvec_len(cvv) != cvec_len(cvk))
-        goto ok;
-    i = 0;
-    cvi = NULL;
-    while ((cvi = cvec_each(cvk, cvi)) != NULL) {
-        if (strcmp(cv_name_get(cvi), cv_string_get(cvec_i(cvv,i))))
-            goto ok;
-        i++;
+    /* All keys or first keys, in any order, in one or several predicates */
+    if ((ret = keys_order(cvv, cvk, &cvk1)) < 0)
+        goto done;
+    if (ret == 1){
+        /* Use 2a form since yc allready given to compute cvk */
+        if (clixon_xml_find_index(xv, yp, NULL, name, cvk1, xvec) < 0)
+            goto done;
+        retval = 1; /* match */
+        goto done;
     }
-    /* Use 2a form since yc allready given to compute cvk */
-    if (clixon_xml_find_index(xv, yp, NULL, name, cvk, xvec) < 0)
+#ifdef XML_EXPLICIT_INDEX
+    /* Or a single non-key leaf registered as explicit search index: _x[_i='_z'] */
+    if (cvec_len(cvk) == 1 &&
+        (yi = yang_find(yc, Y_LEAF, cv_name_get(cvec_i(cvk, 0)))) != NULL &&
+        yang_flag_get(yi, YANG_FLAG_INDEX) != 0){
+        if (clixon_xml_find_index(xv, yp, NULL, name, cvk, xvec) < 0)
+            goto done;
+        _optimize_index_hits++;
+        retval = 1; /* match */
         goto done;
-    retval = 1; /* match */
+    }
+#endif
+    goto ok;
  done:
     if (vec)
         free(vec);
     if (cvk)
         cvec_free(cvk);
+    if (cvk1)
+        cvec_free(cvk1);
     return retval;
  ok: /* no match, not special case */
     retval = 0;
@@ -76,6 +76,8 @@
 #include "clixon_log.h"
 #include "clixon_debug.h"
 #include "clixon_xml_nsctx.h"
+#include "clixon_xpath_ctx.h"
+#include "clixon_xpath.h"
 #include "clixon_yang_module.h"
 #include "clixon_plugin.h"
 #include "clixon_data.h"
@@ -173,6 +175,11 @@ static const map_str2int ykmap[] = {
     {NULL,               -1}
 };
 
+/* Generation of cached yang_order and ordered-by values
+ * Any change of a yang child vector invalidates all cached values, see yang_order_invalidate
+ */
+static uint32_t _yang_order_gen = 1;
+
 /* Forward static */
 static int yang_type_cache_free(yang_type_cache *ycache);
 static int yang_type_cache_cp(yang_stmt *ynew, yang_stmt *yold);
@@ -251,6 +258,10 @@ int
 yang_argument_set(yang_stmt *ys,
                   char      *arg)
 {
+    if (ys->ys_xpath){ /* Cached parse of previous argument */
+        xpath_tree_free(ys->ys_xpath);
+        ys->ys_xpath = NULL;
+    }
     ys->ys_argument = arg; /* not strdup/copied */
     return 0;
 }
@@ -429,6 +440,31 @@ yang_flag_reset(yang_stmt *ys,
     return 0;
 }
 
+/*! Get cached JSON encoding kind of a leaf or leaf-list
+ *
+ * @param[in]  ys     Yang statement
+ * @retval     kind   JSON encoding kind, 0 if not set
+ * @see xml2json_encode_kind in clixon_json.c
+ */
+int
+yang_json_kind_get(yang_stmt *ys)
+{
+    return ys->ys_json_kind;
+}
+
+/*! Cache JSON encoding kind of a leaf or leaf-list
+ *
+ * @param[in]  ys     Yang statement
+ * @param[in]  kind   JSON encoding kind
+ */
+int
+yang_json_kind_set(yang_stmt *ys,
+                   int        kind)
+{
+    ys->ys_json_kind = kind;
+    return 0;
+}
+
 /*! Get yang xpath for "when"-associated augment
  *
  * Ie, for yang structures like: augment <path> { when <xpath>; ... }
@@ -511,6 +547,161 @@ yang_when_nsc_set(yang_stmt *ys,
     return retval;
 }
 
+/*! Get namespace context of yang statement, computed once and then cached
+ *
+ * Same as xml_nsctx_yang() but the context is kept in the yang statement, eg for
+ * "must" or leafref validation of every data node instance
+ * @param[in]  ys     Yang statement
+ * @param[out] nsc    Namespace context. Note: do not free, belongs to ys
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see xml_nsctx_yang
+ */
+int
+yang_nsctx_cache_get(yang_stmt *ys,
+                     cvec     **nsc)
+{
+    int retval = -1;
+
+    if (ys->ys_nsc == NULL &&
+        xml_nsctx_yang(ys, &ys->ys_nsc) < 0)
+        goto done;
+    *nsc = ys->ys_nsc;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Get parsed xpath of yang statement argument, parsed once and then cached
+ *
+ * For statements with xpath argument such as must, when and path
+ * @param[in]  ys     Yang statement
+ * @param[out] xpt    Parsed xpath. Note: do not free, belongs to ys
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+int
+yang_xpath_cache_get(yang_stmt          *ys,
+                     struct xpath_tree **xpt)
+{
+    int retval = -1;
+
+    if (ys->ys_xpath == NULL){
+        if (ys->ys_argument == NULL){
+            clixon_err(OE_YANG, EINVAL, "No xpath argument of %s", yang_key2str(ys->ys_keyword));
+            goto done;
+        }
+        if (xpath_parse(ys->ys_argument, &ys->ys_xpath) < 0)
+            goto done;
+    }
+    *xpt = ys->ys_xpath;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Get validation dependency index of yang spec
+ *
+ * @param[in]  yspec  Yang spec
+ * @retval     deps   Hash of node names to vectors of yang nodes, see xml_yang_validate_changes
+ * @retval     NULL   Not built
+ */
+clicon_hash_t *
+yang_deps_get(yang_stmt *yspec)
+{
+    return yspec->ys_deps;
+}
+
+/*! Set validation dependency index of yang spec
+ *
+ * @param[in]  yspec  Yang spec
+ * @param[in]  deps   Dependency index, consumed by yspec. Previous index is freed
+ * @retval     0      OK
+ */
+int
+yang_deps_set(yang_stmt     *yspec,
+              clicon_hash_t *deps)
+{
+    if (yspec->ys_deps)
+        clicon_hash_free(yspec->ys_deps);
+    yspec->ys_deps = deps;
+    return 0;
+}
+
+/*! Invalidate module lookup cache of yang spec
+ *
+ * Called when modules are removed from the yang spec. Modules appended to the yang spec
+ * do not change earlier (first) matches and do not invalidate the cache.
+ * @param[in]  yspec  Yang spec
+ */
+static int
+yang_modidx_invalidate(yang_stmt *yspec)
+{
+    if (yspec->ys_modidx){
+        clicon_hash_free(yspec->ys_modidx);
+        yspec->ys_modidx = NULL;
+    }
+    return 0;
+}
+
+/*! Get module from module lookup cache of yang spec
+ *
+ * @param[in]  yspec  Yang spec
+ * @param[in]  type   Lookup type, eg 'n' for namespace, see callers
+ * @param[in]  key    Name or namespace
+ * @retval     ymod   Cached (first) matching module
+ * @retval     NULL   Not cached
+ * @see yang_modidx_set
+ */
+yang_stmt *
+yang_modidx_get(yang_stmt  *yspec,
+                char        type,
+                const char *key)
+{
+    char   k[256];
+    void  *p;
+    size_t vlen = 0;
+
+    if (yspec->ys_modidx == NULL || key == NULL)
+        return NULL;
+    if (snprintf(k, sizeof(k), "%c:%s", type, key) >= sizeof(k))
+        return NULL;
+    if ((p = clicon_hash_value(yspec->ys_modidx, k, &vlen)) == NULL ||
+        vlen != sizeof(yang_stmt *))
+        return NULL;
+    return *(yang_stmt **)p;
+}
+
+/*! Add module to module lookup cache of yang spec
+ *
+ * Only first matches in the order of modules in the yang spec may be added
+ * @param[in]  yspec  Yang spec
+ * @param[in]  type   Lookup type, eg 'n' for namespace, see callers
+ * @param[in]  key    Name or namespace
+ * @param[in]  ymod   First matching module
+ * @retval     0      OK, or not cached
+ * @retval    -1      Error
+ */
+int
+yang_modidx_set(yang_stmt  *yspec,
+                char        type,
+                const char *key,
+                yang_stmt  *ymod)
+{
+    char k[256];
+
+    if (yang_keyword_get(yspec) != Y_SPEC || key == NULL)
+        return 0;
+    if (snprintf(k, sizeof(k), "%c:%s", type, key) >= sizeof(k))
+        return 0;
+    if (yspec->ys_modidx == NULL &&
+        (yspec->ys_modidx = clicon_hash_init()) == NULL)
+        return -1;
+    if (clicon_hash_add(yspec->ys_modidx, k, &ymod, sizeof(ymod)) == NULL)
+        return -1;
+    return 0;
+}
+
 /*! Get yang filename for error/debug purpose
  *
  * @param[in]  ys       Yang statement
@@ -744,6 +935,14 @@ ys_free1(yang_stmt *ys,
         free(ys->ys_when_xpath);
     if (ys->ys_when_nsc)
         cvec_free(ys->ys_when_nsc);
+    if (ys->ys_nsc)
+        cvec_free(ys->ys_nsc);
+    if (ys->ys_xpath)
+        xpath_tree_free(ys->ys_xpath);
+    if (ys->ys_deps)
+        clicon_hash_free(ys->ys_deps);
+    if (ys->ys_modidx)
+        clicon_hash_free(ys->ys_modidx);
     if (ys->ys_stmt)
         free(ys->ys_stmt);
     if (ys->ys_filename)
@@ -763,6 +962,19 @@ ys_free1(yang_stmt *ys,
     return 0;
 }
 
+/*! Invalidate all cached yang order values, called when a yang child vector changes
+ *
+ * Functions in this file that change child vectors call it. Code elsewhere that changes
+ * ys_stmt directly must also call it.
+ * @see yang_order
+ */
+void
+yang_order_invalidate(void)
+{
+    if (++_yang_order_gen == 0) /* 0 means not set */
+        _yang_order_gen = 1;
+}
+
 /*! Remove child i from parent yp (dont free) 
  *
  * @param[in]  yp   Parent node
@@ -791,6 +1003,9 @@ ys_prune(yang_stmt *yp,
     }
     yp->ys_len--;
     yp->ys_stmt[yp->ys_len] = NULL;
+    yang_order_invalidate();
+    if (yp->ys_keyword == Y_SPEC)
+        yang_modidx_invalidate(yp);
  done:
     return yc;
 }
@@ -850,6 +1065,9 @@ ys_freechildren(yang_stmt *ys)
         free(ys->ys_stmt);
         ys->ys_stmt = NULL;
     }
+    yang_order_invalidate();
+    if (ys->ys_keyword == Y_SPEC)
+        yang_modidx_invalidate(ys);
     return 0;
 }
 
@@ -886,6 +1104,7 @@ yn_realloc(yang_stmt *yn)
         return -1;
     }
     yn->ys_stmt[yn->ys_len - 1] = NULL; /* init field */
+    yang_order_invalidate();
     return 0;
 }
 
@@ -915,6 +1134,12 @@ ys_cp(yang_stmt *ynew,
 
     memcpy(ynew, yold, sizeof(*yold));
     ynew->ys_parent = NULL;
+    ynew->ys_json_kind = 0; /* Type may resolve differently in new context */
+    ynew->ys_order_gen = 0; /* Order is relative to parent */
+    ynew->ys_nsc = NULL;      /* Namespace context may differ in new module */
+    ynew->ys_xpath = NULL;
+    ynew->ys_deps = NULL;
+    ynew->ys_modidx = NULL;
     if (yold->ys_stmt)
         if ((ynew->ys_stmt = calloc(yold->ys_len, sizeof(yang_stmt *))) == NULL){
             clixon_err(OE_YANG, errno, "calloc");
@@ -1123,7 +1348,14 @@ yang_find(yang_stmt  *yn,
     char      *name;
     yang_stmt *yspec;
     yang_stmt *ym;
-    
+    int        modidx;
+
+    /* Module lookups in yang spec are cached */
+    modidx = (yn->ys_keyword == Y_SPEC && argument != NULL &&
+              (keyword == Y_MODULE || keyword == Y_SUBMODULE));
+    if (modidx &&
+        (yret = yang_modidx_get(yn, keyword==Y_MODULE?'m':'s', argument)) != NULL)
+        return yret;
     for (i=0; i<yn->ys_len; i++){
         ys = yn->ys_stmt[i];
         if (keyword == 0 || ys->ys_keyword == keyword){
@@ -1148,6 +1380,9 @@ yang_find(yang_stmt  *yn,
             }
         }
     }
+    if (modidx && yret &&
+        yang_modidx_set(yn, keyword==Y_MODULE?'m':'s', argument, yret) < 0)
+        return NULL;
     return yret?yret:yretsub;
 }
 
@@ -1645,17 +1880,17 @@ yang_order1(yang_stmt *yp,
     return retval;
 }
 
-/*! Return order of yang statement y in parents child vector
+/*! Compute order of yang statement y in parents child vector, not cached
  *
  * @param[in]  y      Find position of this data-node
- * @param[out] index  Index of y in yp:s list of children
  * @retval   >=0      Order of child with specified argument
  * @retval    -1      No spec, y is NULL, which applies to eg attributes and are placed first
  * @retval    -2      Error: Not found
  * @note special handling if y is child of (sub)module
+ * @see yang_order  cached variant
  */
-int
-yang_order(yang_stmt *y)
+static int
+yang_order0(yang_stmt *y)
 {
     int         retval = -2;
     yang_stmt  *yp;
@@ -1701,6 +1936,50 @@ yang_order(yang_stmt *y)
     return retval;
 }
 
+/*! Return order of yang statement y in parents child vector
+ *
+ * The order is cached in y together with the ordered-by property, the cache is
+ * invalidated whenever a yang child vector is modified, eg augment or mount.
+ * @param[in]  y      Find position of this data-node
+ * @retval   >=0      Order of child with specified argument
+ * @retval    -1      No spec, y is NULL, which applies to eg attributes and are placed first
+ * @retval    -2      Error: Not found
+ * @note special handling if y is child of (sub)module
+ */
+int
+yang_order(yang_stmt *y)
+{
+    int order;
+
+    if (y == NULL)
+        return -1;
+    if (y->ys_order_gen == _yang_order_gen)
+        return y->ys_order;
+    if ((order = yang_order0(y)) < 0)
+        return order;
+    y->ys_order = order;
+    y->ys_order_user = (yang_find(y, Y_ORDERED_BY, "user") != NULL);
+    y->ys_order_gen = _yang_order_gen;
+    return order;
+}
+
+/*! Return if list or leaf-list is ordered-by user
+ *
+ * Cached together with yang_order
+ * @param[in]  y      Yang list or leaf-list
+ * @retval     1      Ordered-by user
+ * @retval     0      Ordered-by system, or not list/leaf-list
+ */
+int
+yang_ordered_by_user(yang_stmt *y)
+{
+    if (y->ys_order_gen == _yang_order_gen)
+        return y->ys_order_user;
+    if (yang_parent_get(y) == NULL || yang_order(y) < 0) /* Not cached */
+        return yang_find(y, Y_ORDERED_BY, "user") != NULL;
+    return y->ys_order_user;
+}
+
 /*! Map from YANG keywords ints to strings
  *
  * @param[in] int  Integer representation of YANG keywords
@@ -3068,7 +3347,6 @@ yang_features(clixon_handle h,
 {
     int        retval = -1;
     int        i;
-    int        j;
     yang_stmt *ys = NULL;
     yang_stmt *ymod;
     const char *mainfile = NULL;
@@ -3107,10 +3385,7 @@ yang_features(clixon_handle h,
                         yang_flag_set(ys, YANG_FLAG_DISABLED);
                         break;
                     }
-                    for (j=i+1; j<yt->ys_len; j++)
-                        yt->ys_stmt[j-1] = yt->ys_stmt[j];
-                    yt->ys_len--;
-                    yt->ys_stmt[yt->ys_len] = NULL;
+                    ys_prune(yt, i);
                     ys_free(ys);
                     continue; /* Don't increment i */
                     break;
@@ -3960,6 +4235,7 @@ yang_sort_subelements(yang_stmt *ys)
         /* This enumerates _ys_vector_i in ys->ys_stmt vector */
         while ((yc = yn_each(ys, yc)) != NULL) ;
         qsort(ys->ys_stmt, ys->ys_len, sizeof(ys), yang_sort_subelements_fn);
+        yang_order_invalidate();
     }
     retval = 0;
     // done:
@@ -3990,6 +4266,7 @@ yang_list_index_add(yang_stmt *ys)
         goto ok;
     }
     yang_flag_set(ys, YANG_FLAG_INDEX);
+    yang_flag_set(yp, YANG_FLAG_INDEXED);
  ok:
     retval = 0;
    // done:
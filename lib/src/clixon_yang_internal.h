@@ -73,6 +73,10 @@ struct yang_stmt{
 
     char              *ys_argument;  /* String / argument depending on keyword */
     uint16_t           ys_flags;     /* Flags according to YANG_FLAG_MARK and others */
+    uint8_t            ys_json_kind; /* Cached JSON encoding of leaf/leaf-list, 0 if not set */
+    uint8_t            ys_order_user; /* Cached: ordered-by user, valid if ys_order_gen is current */
+    int                ys_order;     /* Cached yang_order(), valid if ys_order_gen is current */
+    uint32_t           ys_order_gen; /* Generation of cached order, 0 if not set */
     yang_stmt         *ys_mymodule;  /* Shortcut to "my" module. Used by:
                                         1) Augmented nodes "belong" to the module where the 
                                            augment is declared, which may be differnt from
@@ -106,6 +110,10 @@ struct yang_stmt{
     yang_type_cache   *ys_typecache; /* If ys_keyword==Y_TYPE, cache all typedef data except unions */
     char              *ys_when_xpath; /* Special conditional for a "when"-associated augment/uses xpath */
     cvec              *ys_when_nsc;   /* Special conditional for a "when"-associated augment/uses namespace ctx */
+    cvec              *ys_nsc;        /* Cached namespace context, see yang_nsctx_cache_get */
+    struct xpath_tree *ys_xpath;      /* Cached parsed xpath argument (must, when, path) */
+    clicon_hash_t     *ys_deps;       /* Cached validation dependency index, only YS_SPEC */
+    clicon_hash_t     *ys_modidx;     /* Cached module lookups by name/namespace, only YS_SPEC */
     char              *ys_filename;   /* For debug/errors: filename (only (sub)modules) */
     int                ys_linenum;    /* For debug/errors: line number (in ys_filename) */
     rpc_callback_t    *ys_action_cb;  /* Action callback list, only for Y_ACTION */
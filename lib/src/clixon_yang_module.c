@@ -617,10 +617,14 @@ yang_find_module_by_namespace(yang_stmt *yspec,
 
     if (ns == NULL)
         goto done;
+    if ((ymod = yang_modidx_get(yspec, 'n', ns)) != NULL)
+        goto done;
     while ((ymod = yn_each(yspec, ymod)) != NULL) {
         if (yang_find(ymod, Y_NAMESPACE, ns) != NULL)
             break;
     }
+    if (ymod && yang_modidx_set(yspec, 'n', ns, ymod) < 0)
+        ymod = NULL;
  done:
     return ymod;
 }
@@ -717,10 +721,15 @@ yang_find_module_by_name(yang_stmt *yspec,
 {
     yang_stmt *ymod = NULL;
 
+    if ((ymod = yang_modidx_get(yspec, 'a', name)) != NULL)
+        return ymod;
     while ((ymod = yn_each(yspec, ymod)) != NULL)
         if ((yang_keyword_get(ymod) == Y_MODULE || yang_keyword_get(ymod) == Y_SUBMODULE) &&
-            strcmp(yang_argument_get(ymod), name)==0)
+            strcmp(yang_argument_get(ymod), name)==0){
+            if (yang_modidx_set(yspec, 'a', name, ymod) < 0)
+                return NULL;
             return ymod;
+        }
     return NULL;
 }
 
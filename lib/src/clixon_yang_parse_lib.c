@@ -101,8 +101,8 @@
 #include "clixon_yang_sub_parse.h"
 #include "clixon_yang_parse_lib.h"
 
-/* Size of json read buffer when reading from file*/
-#define BUFLEN 1024
+/* Size of yang read buffer when reading from file*/
+#define BUFLEN 8192
 
 /* Forward */
 static int yang_expand_grouping(yang_stmt *yn);
@@ -620,6 +620,7 @@ yang_expand_uses_node(yang_stmt *yn,
         /* Move existing elements if any */
         if (size)
             memmove(&yn->ys_stmt[i+glen+1], &yn->ys_stmt[i+1], size);
+        yang_order_invalidate();
     }
     /* Find when statement, if present */
     if ((ywhen = yang_find(ys, Y_WHEN, NULL)) != NULL){
@@ -699,6 +700,7 @@ yang_expand_uses_node(yang_stmt *yn,
     /* Remove the grouping copy */
     ygrouping2->ys_len = 0; /* Cant do with get access function */
     ys_free(ygrouping2);
+    yang_order_invalidate(); /* yn children were replaced directly */
     retval = 0;
  done:
     if (wnsc)
@@ -853,36 +855,34 @@ yang_parse_file(FILE       *fp,
                 yang_stmt  *yspec)
 {
     char         *buf = NULL;
-    int           i;
-    char          c;
-    int           len;
+    size_t        buflen = BUFLEN;
+    size_t        len = 0;
+    size_t        n;
     yang_stmt    *ymod = NULL;
-    int           ret;
 
-    len = BUFLEN; /* any number is fine */
-    if ((buf = malloc(len)) == NULL){
+    if ((buf = malloc(buflen)) == NULL){
         clixon_err(OE_XML, errno, "malloc");
         goto done;
     }
-    memset(buf, 0, len);
-    i = 0; /* position in buf */
-    while (1){ /* read the whole file */
-        if ((ret = fread(&c, 1, 1, fp)) < 0){
-            clixon_err(OE_XML, errno, "read");
-            break;
-        }
-        if (ret == 0)
-            break; /* eof */
-        if (i == len-1){
-            if ((buf = realloc(buf, 2*len)) == NULL){
+    /* Read whole file in blocks, doubling buffer as needed */
+    while (1){
+        if (len >= buflen-1){ /* Space: one for the null character */
+            buflen *= 2;
+            if ((buf = realloc(buf, buflen)) == NULL){
                 clixon_err(OE_XML, errno, "realloc");
                 goto done;
             }
-            memset(buf+len, 0, len);
-            len *= 2;
         }
-        buf[i++] = (char)(c&0xff);
-    } /* read a line */
+        if ((n = fread(buf+len, 1, buflen-1-len, fp)) == 0){
+            if (ferror(fp)){
+                clixon_err(OE_XML, errno, "read");
+                goto done;
+            }
+            break;
+        }
+        len += n;
+    }
+    buf[len] = '\0';
     if ((ymod = yang_parse_str(buf, name, yspec)) < 0)
         goto done;
   done:
@@ -932,6 +932,264 @@ filename2revision(const char *filename,
     return retval;
 }
 
+/* Index of yang files in the yang dirs, see yang_file_index_hold */
+typedef struct {
+    int             yi_ref;   /* Number of nested holders */
+    int             yi_built; /* Index is built, lazily on first lookup */
+    int             yi_len;   /* Length of yi_dirs */
+    clicon_hash_t **yi_dirs;  /* Per dir option in config order: module[@revision] -> path */
+} yang_file_index;
+
+/*! Add a yang file to the index of one dir
+ *
+ * Both "module" and "module@revision" keys are added. The module key refers to the
+ * most recent file (last in sort order), the module@revision key to the first file found.
+ * @param[in]  hash  Index of one dir
+ * @param[in]  name  Filename without dir, eg a@2000-01-01.yang
+ * @param[in]  path  Filename with dir
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+yang_file_index_add(clicon_hash_t *hash,
+                    char          *name,
+                    char          *path)
+{
+    int     retval = -1;
+    char   *base = NULL;
+    char   *rev;
+    char   *p0;
+    size_t  len;
+    int     i;
+
+    len = strlen(name);
+    if (len <= 5 || strcmp(name + len - 5, ".yang") != 0)
+        goto ok;
+    if ((base = strdup(name)) == NULL){
+        clixon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    base[len - 5] = '\0';
+    if ((rev = index(base, '@')) != NULL){
+        if (clicon_hash_value(hash, base, NULL) == NULL &&
+            clicon_hash_add(hash, base, path, strlen(path)+1) == NULL)
+            goto done;
+        *rev++ = '\0';
+        /* Only revision-date on the form YYYY-MM-DD matches module without revision */
+        if (strlen(rev) != 10 || rev[4] != '-' || rev[7] != '-')
+            goto ok;
+        for (i=0; i<10; i++)
+            if (i != 4 && i != 7 && !isdigit(rev[i]))
+                goto ok;
+    }
+    if ((p0 = clicon_hash_value(hash, base, NULL)) != NULL){
+        if ((p0 = rindex(p0, '/')) == NULL || strcoll(name, p0+1) <= 0)
+            goto ok;
+    }
+    if (clicon_hash_add(hash, base, path, strlen(path)+1) == NULL)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    if (base)
+        free(base);
+    return retval;
+}
+
+/*! Build index of yang files in CLICON_YANG_MAIN_DIR and CLICON_YANG_DIR options
+ *
+ * CLICON_YANG_MAIN_DIR is not searched recursively, CLICON_YANG_DIR is.
+ * @param[in]  h     Clixon handle
+ * @param[in]  yi    Yang file index
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+yang_file_index_build(clixon_handle    h,
+                      yang_file_index *yi)
+{
+    int            retval = -1;
+    cxobj         *x;
+    cxobj         *xc;
+    char          *dir;
+    clicon_hash_t *hash;
+    struct dirent *dp = NULL;
+    int            ndp;
+    int            i;
+    cvec          *cvv = NULL;
+    cg_var        *cv;
+    char           path[MAXPATHLEN];
+
+    yi->yi_built = 1;
+    if ((x = clicon_conf_xml(h)) == NULL)
+        goto ok;
+    xc = NULL;
+    while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL) {
+        if (strcmp(xml_name(xc), "CLICON_YANG_MAIN_DIR") != 0 &&
+            strcmp(xml_name(xc), "CLICON_YANG_DIR") != 0)
+            continue;
+        if ((dir = xml_body(xc)) == NULL)
+            continue;
+        if ((hash = clicon_hash_init()) == NULL)
+            goto done;
+        if ((yi->yi_dirs = realloc(yi->yi_dirs, (yi->yi_len+1)*sizeof(*yi->yi_dirs))) == NULL){
+            clixon_err(OE_UNIX, errno, "realloc");
+            clicon_hash_free(hash);
+            goto done;
+        }
+        yi->yi_dirs[yi->yi_len++] = hash;
+        if (strcmp(xml_name(xc), "CLICON_YANG_MAIN_DIR") == 0){
+            if ((ndp = clicon_file_dirent(dir, &dp, "\\.yang$", S_IFREG)) < 0)
+                goto done;
+            for (i = 0; i < ndp; i++){
+                snprintf(path, MAXPATHLEN-1, "%s/%s", dir, dp[i].d_name);
+                if (yang_file_index_add(hash, dp[i].d_name, path) < 0)
+                    goto done;
+            }
+            if (dp){
+                free(dp);
+                dp = NULL;
+            }
+        }
+        else {
+            if ((cvv = cvec_new(0)) == NULL){
+                clixon_err(OE_UNIX, errno, "cvec_new");
+                goto done;
+            }
+            if (clicon_files_recursive(dir, "\\.yang$", cvv) < 0)
+                goto done;
+            cv = NULL;
+            while ((cv = cvec_each(cvv, cv)) != NULL)
+                if (yang_file_index_add(hash, cv_name_get(cv), cv_string_get(cv)) < 0)
+                    goto done;
+            cvec_free(cvv);
+            cvv = NULL;
+        }
+    }
+ ok:
+    retval = 0;
+ done:
+    if (dp)
+        free(dp);
+    if (cvv)
+        cvec_free(cvv);
+    return retval;
+}
+
+/*! Hold index of yang files while parsing a yang module and its imports
+ *
+ * Without the index, every import scans all yang dirs for its file. With it, the dirs are
+ * scanned once when the first file is looked up and until the last holder releases it.
+ * Files added to the yang dirs meanwhile are not found.
+ * @param[in]  h     Clixon handle
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see yang_file_index_release
+ */
+static int
+yang_file_index_hold(clixon_handle h)
+{
+    int              retval = -1;
+    yang_file_index *yi = NULL;
+
+    if (h == NULL)
+        goto ok;
+    if (clicon_ptr_get(h, "yang-file-index", (void**)&yi) < 0 || yi == NULL){
+        if ((yi = malloc(sizeof(*yi))) == NULL){
+            clixon_err(OE_UNIX, errno, "malloc");
+            goto done;
+        }
+        memset(yi, 0, sizeof(*yi));
+        if (clicon_ptr_set(h, "yang-file-index", yi) < 0){
+            free(yi);
+            goto done;
+        }
+    }
+    yi->yi_ref++;
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Release index of yang files, free it when there are no more holders
+ *
+ * @param[in]  h     Clixon handle
+ * @retval     0     OK
+ * @see yang_file_index_hold
+ */
+static int
+yang_file_index_release(clixon_handle h)
+{
+    yang_file_index *yi = NULL;
+    int              i;
+
+    if (h == NULL ||
+        clicon_ptr_get(h, "yang-file-index", (void**)&yi) < 0 || yi == NULL)
+        return 0;
+    if (--yi->yi_ref > 0)
+        return 0;
+    for (i=0; i<yi->yi_len; i++)
+        clicon_hash_free(yi->yi_dirs[i]);
+    if (yi->yi_dirs)
+        free(yi->yi_dirs);
+    free(yi);
+    clicon_ptr_del(h, "yang-file-index");
+    return 0;
+}
+
+/*! Look up yang file in index of yang files
+ *
+ * @param[in]  h        Clixon handle
+ * @param[in]  module   Name of main YANG module. 
+ * @param[in]  revision Revision or NULL
+ * @param[out] fbuf     Buffer containing filename or NULL (if retval=1)
+ * @retval     2        No index held, scan yang dirs instead
+ * @retval     1        Match found, most recent entry returned in fbuf
+ * @retval     0        No matching entry found
+ * @retval    -1        Error 
+ */
+static int
+yang_file_index_find(clixon_handle h,
+                     const char   *module,
+                     const char   *revision,
+                     cbuf         *fbuf)
+{
+    int              retval = -1;
+    yang_file_index *yi = NULL;
+    cbuf            *cb = NULL;
+    char            *path;
+    int              i;
+
+    if (h == NULL ||
+        clicon_ptr_get(h, "yang-file-index", (void**)&yi) < 0 || yi == NULL){
+        retval = 2;
+        goto done;
+    }
+    if (!yi->yi_built && yang_file_index_build(h, yi) < 0)
+        goto done;
+    if ((cb = cbuf_new()) == NULL){
+        clixon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "%s", module);
+    if (revision)
+        cprintf(cb, "@%s", revision);
+    for (i=0; i<yi->yi_len; i++){
+        if ((path = clicon_hash_value(yi->yi_dirs[i], cbuf_get(cb), NULL)) != NULL){
+            if (fbuf)
+                cprintf(fbuf, "%s", path);
+            retval = 1;
+            goto done;
+        }
+    }
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
 /*! No specific revision give. Match a yang file given module 
  *
  * @param[in]  h        CLICON handle
@@ -957,7 +1215,14 @@ yang_file_find_match(clixon_handle h,
     cvec         *cvv = NULL;
     cg_var       *cv = NULL;
     cg_var       *bestcv = NULL;
+    int           ret;
 
+    if ((ret = yang_file_index_find(h, module, revision, fbuf)) < 0)
+        goto done;
+    if (ret != 2){
+        retval = ret;
+        goto done;
+    }
     /* get clicon config file in xml form */
     if ((x = clicon_conf_xml(h)) == NULL)
         goto ok;
@@ -1564,6 +1829,7 @@ yang_spec_parse_module(clixon_handle h,
     int         retval = -1;
     int         modmin;       /* Existing number of modules */
     char       *base = NULL;;
+    int         held = 0;
 
     if (yspec == NULL){
         clixon_err(OE_YANG, EINVAL, "yang spec is NULL");
@@ -1578,6 +1844,9 @@ yang_spec_parse_module(clixon_handle h,
     /* Do not load module if it already exists */
     if (yang_find_module_by_name_revision(yspec, name, revision) != NULL)
         goto ok;
+    if (yang_file_index_hold(h) < 0)
+        goto done;
+    held++;
     /* Find a yang module and parse it and all its submodules */
     if (yang_parse_module(h, name, revision, yspec, NULL) == NULL)
         goto done;
@@ -1586,6 +1855,8 @@ yang_spec_parse_module(clixon_handle h,
  ok:
     retval = 0;
  done:
+    if (held)
+        yang_file_index_release(h);
     if (base)
         free(base);
     return retval;
@@ -1610,6 +1881,7 @@ yang_spec_parse_file(clixon_handle h,
     int         retval = -1;
     int         modmin;       /* Existing number of modules */
     char       *base = NULL;;
+    int         held = 0;
 
     /* Apply steps 2.. on new modules, ie ones after modmin. */
     modmin = yang_len_get(yspec);
@@ -1626,6 +1898,9 @@ yang_spec_parse_file(clixon_handle h,
         *index(base, '@') = '\0';
     if (yang_find(yspec, Y_MODULE, base) != NULL)
         goto ok;
+    if (yang_file_index_hold(h) < 0)
+        goto done;
+    held++;
     if (yang_parse_filename(h, filename, yspec) == NULL)
         goto done;
     if (yang_parse_post(h, yspec, modmin) < 0)
@@ -1633,6 +1908,8 @@ yang_spec_parse_file(clixon_handle h,
  ok:
     retval = 0;
  done:
+    if (held)
+        yang_file_index_release(h);
     if (base)
         free(base);
     return retval;
@@ -1675,6 +1952,7 @@ yang_spec_load_dir(clixon_handle h,
     uint32_t       rev0; /* revision in existing module */
     char          *oldbase = NULL;
     int            taken = 0;
+    int            held = 0;
 
     /* Get yang files names from yang module directory. Note that these
      * are sorted alphatetically:
@@ -1686,6 +1964,9 @@ yang_spec_load_dir(clixon_handle h,
         goto done;
     if (ndp == 0)
         goto ok;
+    if (yang_file_index_hold(h) < 0)
+        goto done;
+    held++;
     /* Apply post steps on new modules, ie ones after modmin. */
     modmin = yang_len_get(yspec);
     /* Load all yang files in dir */
@@ -1742,10 +2023,18 @@ yang_spec_load_dir(clixon_handle h,
             goto done;
         }
         /* If ym0 and ym exists, delete the yang with oldest revision 
-         * This is a failsafe in case anything else fails
+         * This is a failsafe in case anything else fails, eg module name differs from filename
+         * Only modules loaded from this dir are removed
          */
+        if ((ym0 = yang_find(yspec, yang_keyword_get(ym), yang_argument_get(ym))) != NULL &&
+            ym0 != ym &&
+            (yrev = yang_find(ym0, Y_REVISION, NULL)) != NULL)
+            rev0 = cv_uint32_get(yang_cv_get(yrev));
         if (revm && rev0){
-            if (revm > rev0) /* Loaded module is older or eq -> remove ym */
+            for (j=0; j<yang_len_get(yspec); j++)
+                if (yspec->ys_stmt[j] == ym0)
+                    break;
+            if (revm > rev0 && j >= modmin) /* Loaded module is newer -> remove ym0 */
                 ym = ym0;
             for (j=0; j<yang_len_get(yspec); j++)
                 if (yspec->ys_stmt[j] == ym)
@@ -1759,6 +2048,8 @@ yang_spec_load_dir(clixon_handle h,
  ok:
     retval = 0;
   done:
+    if (held)
+        yang_file_index_release(h);
     if (dp)
         free(dp);
     if (base)
@@ -0,0 +1,157 @@
+#!/usr/bin/env bash
+# Lazy autocli: generate the autocli of top-level containers on first use
+# See CLICON_CLI_AUTOCLI_LAZY
+# Trees are named by module, also check a module with a URL namespace
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/$APPNAME.yang
+fyang2=$dir/$APPNAME-url.yang
+clidir=$dir/cli
+if [ -d $clidir ]; then
+    rm -rf $clidir/*
+else
+    mkdir $clidir
+fi
+
+# Generate autocli for these modules
+AUTOCLI=$(autocli_config ${APPNAME}\* kw-nokey false)
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_BACKEND_DIR>/usr/local/lib/$APPNAME/backend</CLICON_BACKEND_DIR>
+  <CLICON_CLISPEC_DIR>$clidir</CLICON_CLISPEC_DIR>
+  <CLICON_CLI_DIR>/usr/local/lib/$APPNAME/cli</CLICON_CLI_DIR>
+  <CLICON_CLI_MODE>$APPNAME</CLICON_CLI_MODE>
+  <CLICON_CLI_AUTOCLI_LAZY>true</CLICON_CLI_AUTOCLI_LAZY>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_YANG_LIBRARY>false</CLICON_YANG_LIBRARY>
+  ${AUTOCLI}
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang2
+module $APPNAME-url {
+  namespace "http://example.com/yang/$APPNAME-url";
+  prefix exu;
+  container sys{
+    leaf name{
+      type string;
+    }
+  }
+}
+EOF
+
+cat <<EOF > $fyang
+module $APPNAME {
+  namespace "urn:example:clixon";
+  prefix ex;
+  import $APPNAME-url {
+    prefix exu;
+  }
+  container table{
+    list parameter{
+      key name;
+      leaf name{
+        type string;
+      }
+      leaf value{
+        type string;
+      }
+    }
+  }
+  container empty{
+    presence "Only presence";
+  }
+  leaf top{
+    type string;
+  }
+}
+EOF
+
+cat <<EOF > $clidir/ex.cli
+CLICON_MODE="example";
+CLICON_PROMPT="%U@%H> ";
+
+set @datamodel, cli_auto_set();
+delete("Delete a configuration item") {
+      @datamodel, cli_auto_del();
+}
+commit("Commit the changes"), cli_commit();
+show("Show a particular state of the system"){
+    configuration("Show configuration"), cli_show_auto_mode("candidate", "xml", false, false);
+}
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "Generated clispec has tree reference to top-level container"
+expectpart "$($clixon_cli -f $cfg -G -1 2>&1)" 0 "@autocli-lazy-$APPNAME-table" "@autocli-lazy-$APPNAME-url-sys" --not-- "value (<value:string>"
+
+new "Completion of lazy top-level container"
+expectpart "$(echo "set table ?" | $clixon_cli -f $cfg 2> /dev/null)" 0 parameter
+
+new "Completion of empty lazy top-level container"
+expectpart "$(echo "set empty ?" | $clixon_cli -f $cfg 2> /dev/null)" 0 "<cr>"
+
+new "set top-level leaf"
+expectpart "$($clixon_cli -f $cfg -1 set top 42)" 0 ""
+
+new "set table parameter x value 17"
+expectpart "$($clixon_cli -f $cfg -1 set table parameter x value 17)" 0 ""
+
+new "set lazy container in module with URL namespace"
+expectpart "$($clixon_cli -f $cfg -1 set sys name foo)" 0 ""
+
+new "set empty"
+expectpart "$($clixon_cli -f $cfg -1 set empty)" 0 ""
+
+new "commit"
+expectpart "$($clixon_cli -f $cfg -1 commit)" 0 ""
+
+new "show config"
+expectpart "$($clixon_cli -f $cfg -1 show config)" 0 "<table xmlns=\"urn:example:clixon\"><parameter><name>x</name><value>17</value></parameter></table>" "<empty xmlns=\"urn:example:clixon\"/>" "<top xmlns=\"urn:example:clixon\">42</top>" "<sys xmlns=\"http://example.com/yang/$APPNAME-url\"><name>foo</name></sys>"
+
+new "delete table parameter x"
+expectpart "$($clixon_cli -f $cfg -1 delete table parameter x)" 0 ""
+
+new "show config deleted"
+expectpart "$($clixon_cli -f $cfg -1 show config)" 0 "<top xmlns=\"urn:example:clixon\">42</top>" --not-- "<parameter>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
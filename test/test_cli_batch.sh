@@ -0,0 +1,217 @@
+#!/usr/bin/env bash
+# CLI batch mode: edits are merged and sent as a single edit-config
+# Both with -b command-line option and with batch begin/end commands
+# Errors are mapped back to line and command
+# Pending edits are sent before copy and save, and dropped by discard and delete all
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/$APPNAME.yang
+fscript=$dir/script.cli
+clidir=$dir/cli
+if [ -d $clidir ]; then
+    rm -rf $clidir/*
+else
+    mkdir $clidir
+fi
+
+# Generate autocli for these modules, including state
+AUTOCLI=$(autocli_config ${APPNAME} kw-nokey true)
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_CLISPEC_DIR>$clidir</CLICON_CLISPEC_DIR>
+  <CLICON_CLI_DIR>/usr/local/lib/$APPNAME/cli</CLICON_CLI_DIR>
+  <CLICON_CLI_MODE>$APPNAME</CLICON_CLI_MODE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_FEATURE>ietf-netconf:startup</CLICON_FEATURE>
+  ${AUTOCLI}
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module $APPNAME {
+  namespace "urn:example:clixon";
+  prefix ex;
+  container x {
+    list m1 {
+      key "a";
+      leaf a {
+        type string;
+      }
+      leaf c {
+        type string;
+      }
+    }
+    leaf s {
+      description "State, setting it is an edit-config error";
+      config false;
+      type string;
+    }
+  }
+}
+EOF
+
+# Note that set uses @datamodelstate to be able to set state data
+cat <<EOF > $clidir/ex.cli
+CLICON_MODE="example";
+CLICON_PROMPT="%U@%H> ";
+
+set @datamodelstate, cli_set();
+delete("Delete a configuration item") {
+      @datamodel, cli_del();
+      all("Delete whole candidate configuration"), delete_all("candidate");
+}
+batch("Batch mode") {
+      begin("Start batch"), cli_batch_begin();
+      end("Send batch"), cli_batch_end();
+}
+commit("Commit the changes"), cli_commit();
+discard("Discard edits"), discard_changes();
+copy("Copy") {
+      candidate("Copy from candidate") startup("Copy to startup"), db_copy("candidate", "startup");
+      m1("Copy m1 entry") <name:string>("Name of entry to copy from") to("Copy to") <toname:string>("Name of entry to copy to"), cli_copy_config("candidate", "/x/m1[%s='%s']", "urn:example:clixon", "a", "name", "toname");
+}
+save("Save candidate to file") <filename:string>("Filename"), save_config_file("candidate", "filename", "xml");
+show("Show a particular state of the system"){
+    configuration("Show configuration"), cli_show_auto_mode("candidate", "xml", false, false);
+    startup("Show startup"), cli_show_auto_mode("startup", "xml", false, false);
+}
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+cat <<EOF > $fscript
+set x m1 a1 c 1
+set x m1 a2 c 2
+set x m1 a1 c 11
+delete x m1 a2
+set x m1 a3 c 3
+commit
+EOF
+
+new "batch script with -b"
+expectpart "$($clixon_cli -f $cfg -b -F $fscript 2>&1)" 0 ""
+
+new "show config"
+expectpart "$($clixon_cli -1 -f $cfg show config)" 0 "<x xmlns=\"urn:example:clixon\"><m1><a>a1</a><c>11</c></m1><m1><a>a3</a><c>3</c></m1></x>" --not-- "<a>a2</a>"
+
+new "delete all"
+expectpart "$($clixon_cli -1 -f $cfg delete all)" 0 ""
+
+new "commit"
+expectpart "$($clixon_cli -1 -f $cfg commit)" 0 ""
+
+cat <<EOF > $fscript
+set x m1 a1 c 1
+set x m1 a2 c 2
+set x s 99
+set x m1 a3 c 3
+EOF
+
+new "batch script error is mapped to line"
+expectpart "$($clixon_cli -f $cfg -b -F $fscript 2>&1)" 255 "line 3 \"set x s 99\"" "State data not allowed"
+
+new "edits before error are in candidate"
+expectpart "$($clixon_cli -1 -f $cfg show config)" 0 "<m1><a>a1</a><c>1</c></m1><m1><a>a2</a><c>2</c></m1>" --not-- "<a>a3</a>" "<s>99</s>"
+
+new "discard"
+expectpart "$($clixon_cli -1 -f $cfg discard)" 0 ""
+
+new "batch begin and end commands"
+expectpart "$(echo -e "batch begin\nset x m1 b1 c 1\nset x m1 b2 c 2\nbatch end\nshow config" | $clixon_cli -f $cfg 2>&1)" 0 "<x xmlns=\"urn:example:clixon\"><m1><a>b1</a><c>1</c></m1><m1><a>b2</a><c>2</c></m1></x>"
+
+new "batch is sent at end of input"
+expectpart "$(echo -e "batch begin\nset x m1 b3 c 3" | $clixon_cli -f $cfg 2>&1)" 0 ""
+
+new "show config b3"
+expectpart "$($clixon_cli -1 -f $cfg show config)" 0 "<m1><a>b3</a><c>3</c></m1>"
+
+new "discard"
+expectpart "$($clixon_cli -1 -f $cfg discard)" 0 ""
+
+cat <<EOF > $fscript
+set x m1 a1 c 1
+set x s 99
+set x m1 a1 c 2
+EOF
+
+new "conflicting edit after error is not applied"
+expectpart "$($clixon_cli -f $cfg -b -F $fscript 2>&1)" 0 "line 2 \"set x s 99\"" "line 3 \"set x m1 a1 c 2\": not applied"
+
+new "show config a1 not changed"
+expectpart "$($clixon_cli -1 -f $cfg show config)" 0 "<m1><a>a1</a><c>1</c></m1>" --not-- "<c>2</c>"
+
+new "discard"
+expectpart "$($clixon_cli -1 -f $cfg discard)" 0 ""
+
+new "copy candidate to startup sends pending edits"
+expectpart "$(echo -e "batch begin\nset x m1 c1 c 1\ncopy candidate startup\nbatch end" | $clixon_cli -f $cfg 2>&1)" 0 ""
+
+new "show startup c1"
+expectpart "$($clixon_cli -1 -f $cfg show startup)" 0 "<m1><a>c1</a><c>1</c></m1>"
+
+new "save sends pending edits"
+expectpart "$(echo -e "batch begin\nset x m1 c2 c 2\nsave $dir/saved.xml\nbatch end" | $clixon_cli -f $cfg 2>&1)" 0 ""
+
+new "saved file has c2"
+expectpart "$(cat $dir/saved.xml)" 0 "<a>c2</a>"
+
+new "copy entry sends pending edits"
+expectpart "$(echo -e "batch begin\nset x m1 c3 c 3\ncopy m1 c3 to c4\nset x m1 c3 c 33\nbatch end" | $clixon_cli -f $cfg 2>&1)" 0 ""
+
+new "show config c3 and copy c4"
+expectpart "$($clixon_cli -1 -f $cfg show config)" 0 "<m1><a>c3</a><c>33</c></m1><m1><a>c4</a><c>3</c></m1>"
+
+new "discard drops pending edits without sending"
+expectpart "$(echo -e "batch begin\nset x m1 d1 c 1\nset x s 99\ndiscard\nbatch end" | $clixon_cli -f $cfg 2>&1)" 0 "" --not-- "State data not allowed"
+
+new "show config empty after discard"
+expectpart "$($clixon_cli -1 -f $cfg show config)" 0 "" --not-- "<a>c1</a>" "<a>d1</a>"
+
+new "delete all drops pending edits without sending"
+expectpart "$(echo -e "set x m1 e1 c 1\nbatch begin\nset x m1 e2 c 2\nset x s 99\ndelete all\nbatch end" | $clixon_cli -f $cfg 2>&1)" 0 "" --not-- "State data not allowed"
+
+new "show config empty after delete all"
+expectpart "$($clixon_cli -1 -f $cfg show config)" 0 "" --not-- "<a>e1</a>" "<a>e2</a>"
+
+new "discard"
+expectpart "$($clixon_cli -1 -f $cfg discard)" 0 ""
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -3,6 +3,7 @@
 # - Multi-line + pretty-print 
 # - Empty values
 # - JSON string encode/decode
+# - Escapes including \u surrogate pairs, numbers, nesting and syntax error positions
 # Note that members should not be quoted. See test_restconf2.sh for typed
 #PROG="valgrind --leak-check=full --show-leak-kinds=all ../util/clixon_util_json"
 # Magic line must be first in script (see README.md)
@@ -174,6 +175,100 @@ JSON='{"text":"bmp:\uFAIL"}'
 new "json escaping unicode BMP fail"
 expecteofx "$clixon_util_json -j -D $DBG" 255 "$JSON" 2> /dev/null
 
+JSON='{"text":"bmp:\u20AC"}'
+new "json escaping \u BMP three bytes euro"
+expecteofx "$clixon_util_json -j" 0 "$JSON" '{"text":"bmp:€"}'
+
+JSON='{"text":"smp:\uD83D\uDE00"}'
+new "json escaping \u surrogate pair"
+expecteofx "$clixon_util_json" 0 "$JSON" '<text>smp:😀</text>'
+
+JSON='{"text":"smp:\ud834\udd1e"}'
+new "json escaping \u surrogate pair lower case"
+expecteofx "$clixon_util_json -j" 0 "$JSON" '{"text":"smp:𝄞"}'
+
+JSON='{"text":"smp:\uD83Dx"}'
+new "json escaping \u high surrogate without low expect fail"
+expectpart "$(echo "$JSON" | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: 'x'"
+
+JSON='{"text":"smp:\uD83DA"}'
+new "json escaping \u high surrogate followed by non-surrogate expect fail"
+expectpart "$(echo "$JSON" | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: '\\\\'"
+
+JSON='{"text":"smp:\uDE00"}'
+new "json escaping \u low surrogate without high expect fail"
+expectpart "$(echo "$JSON" | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: 'u'"
+
+JSON='{"text":"a\/b\\c\"d"}'
+new "json escaping solidus, backslash and quote to xml"
+expecteofx "$clixon_util_json" 0 "$JSON" '<text>a/b\c"d</text>'
+
+JSON='{"text":"bs:\bff:\fcr:\rend"}'
+new "json escaping \b\f\r to json"
+expecteofx "$clixon_util_json -j" 0 "$JSON" "$JSON"
+
+JSON='{"text":"bad:\x"}'
+new "json escaping unknown escape expect fail"
+expectpart "$(echo "$JSON" | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: 'x'"
+
+# Numbers
+new "json number exponent"
+expecteofx "$clixon_util_json" 0 '{"a":1e5}' "<a>1e5</a>"
+
+new "json number negative fraction exponent with plus"
+expecteofx "$clixon_util_json" 0 '{"a":-1.5E+3}' "<a>-1.5E+3</a>"
+
+new "json number exponent with minus"
+expecteofx "$clixon_util_json" 0 '{"a":[2e-2,0.25e10]}' "<a>2e-2</a><a>0.25e10</a>"
+
+new "json number exponent without digits expect fail"
+expectpart "$(echo '{"a":1e}' | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: '}'"
+
+new "json number exponent sign without digits expect fail"
+expectpart "$(echo '{"a":1e+}' | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: '}'"
+
+# Empty objects and arrays
+new "json empty top-level object"
+expecteofx "$clixon_util_json" 0 '{}' ""
+
+new "json empty object and array"
+expecteofx "$clixon_util_json" 0 '{"a":{},"b":[]}' "<a/><b/>"
+
+new "json array of empty objects"
+expecteofx "$clixon_util_json" 0 '{"a":[{},{}]}' "<a/><a/>"
+
+# Deep nesting
+JSON="$(printf '{"a":%.0s' $(seq 1 200))1$(printf '}%.0s' $(seq 1 200))"
+new "json deep nesting"
+expecteofx "$clixon_util_json" 0 "$JSON" "$(printf '<a>%.0s' $(seq 1 200))1$(printf '</a>%.0s' $(seq 1 200))"
+
+JSON="$(printf '{"a":%.0s' $(seq 1 10001))1$(printf '}%.0s' $(seq 1 10001))"
+new "json too deep nesting expect fail"
+expectpart "$(echo "$JSON" | $clixon_util_json 2>&1)" 255 "json_parse: line 1: memory exhausted"
+
+# Malformed input and error position
+JSON='{
+  "a": 1,
+  "b" 2
+}'
+new "json missing colon on line 3 expect fail"
+expectpart "$(echo "$JSON" | $clixon_util_json 2>&1)" 255 "json_parse: line 3: syntax error at or before: '2'"
+
+new "json trailing comma expect fail"
+expectpart "$(echo '{"a":1,}' | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: '}'"
+
+new "json unquoted name expect fail"
+expectpart "$(echo '{a:1}' | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: 'a'"
+
+new "json trailing garbage expect fail"
+expectpart "$(echo '{"a":1} x' | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: 'x'"
+
+new "json bad literal expect fail"
+expectpart "$(echo '{"a":tru}' | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: 't'"
+
+new "json unterminated string expect fail"
+expectpart "$(printf '%s' '{"a":"x' | $clixon_util_json 2>&1)" 255 "json_parse: line 1: syntax error at or before: ''"
+
 rm -rf $dir
 
 new "endtest"
@@ -0,0 +1,213 @@
+#!/usr/bin/env bash
+# Cached parsed xpaths and namespace contexts of must and when statements
+# The xpaths are parsed once per yang statement and reused in later validations.
+# Check that repeated validations give correct results, also for a grouping used in two
+# places, and that changed must and when expressions are used after the yang is changed
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/$APPNAME.yang
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+# Create yang with must and when in a grouping used in two places
+# Args:
+# 1: must expression
+# 2: must error-message
+# 3: when expression
+function create_yang()
+{
+    must=$1
+    msg=$2
+    when=$3
+
+    cat <<EOF > $fyang
+module $APPNAME{
+  yang-version 1.1;
+  namespace "urn:example:clixon";
+  prefix ex;
+  grouping limits {
+    leaf type {
+      type string;
+    }
+    leaf max {
+      type uint32;
+    }
+    leaf value {
+      type uint32;
+      must "$must" {
+        error-message "$msg";
+      }
+    }
+    leaf extra {
+      when "$when";
+      type string;
+    }
+  }
+  container a {
+    list e {
+      key name;
+      leaf name {
+        type string;
+      }
+      uses limits;
+    }
+  }
+  container b {
+    uses limits;
+  }
+}
+EOF
+}
+
+# Start backend
+function testrun_start()
+{
+    new "test params: -f $cfg"
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -zf $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend -s init -f $cfg"
+        start_backend -s init -f $cfg
+    fi
+
+    new "wait backend"
+    wait_backend
+}
+
+function testrun_stop()
+{
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+# Edit candidate
+# Args:
+# 1: config
+function edit()
+{
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config>$1</config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+}
+
+# Validate candidate
+# Args:
+# 1: expected reply
+function validate()
+{
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "$1"
+}
+
+OK="<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "1. Repeated validations with cached xpaths"
+create_yang ". &lt;= ../max" "Value exceeds max" "../type='ext'"
+testrun_start
+
+new "add list entries"
+edit "<a xmlns=\"urn:example:clixon\"><e><name>x1</name><max>10</max><value>5</value></e><e><name>x2</name><max>10</max><value>10</value></e></a>"
+
+new "validate ok"
+validate "$OK"
+
+new "validate again ok"
+validate "$OK"
+
+new "make second entry exceed max"
+edit "<a xmlns=\"urn:example:clixon\"><e><name>x2</name><value>11</value></e></a>"
+
+new "validate must fail"
+validate "<error-message>Value exceeds max</error-message>"
+
+new "validate must fail again"
+validate "<error-message>Value exceeds max</error-message>"
+
+new "fix second entry"
+edit "<a xmlns=\"urn:example:clixon\"><e><name>x2</name><value>9</value></e></a>"
+
+new "validate ok after fix"
+validate "$OK"
+
+new "second use of grouping exceeds max"
+edit "<b xmlns=\"urn:example:clixon\"><max>1</max><value>2</value></b>"
+
+new "validate must fail in second use"
+validate "<error-message>Value exceeds max</error-message>"
+
+new "fix second use"
+edit "<b xmlns=\"urn:example:clixon\"><value>1</value></b>"
+
+new "validate ok after fix of second use"
+validate "$OK"
+
+new "add extra leaf with when false"
+edit "<a xmlns=\"urn:example:clixon\"><e><name>x1</name><type>other</type><extra>y</extra></e></a>"
+
+new "validate when fail"
+validate "<error-message>Failed WHEN condition of extra in module $APPNAME (WHEN xpath is ../type='ext')</error-message>"
+
+new "make when true"
+edit "<a xmlns=\"urn:example:clixon\"><e><name>x1</name><type>ext</type></e></a>"
+
+new "validate when ok"
+validate "$OK"
+
+new "commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "$OK"
+
+testrun_stop
+
+new "2. Changed must and when expressions"
+create_yang ". &lt; ../max" "Value must be less than max" "../type='ext2'"
+testrun_start
+
+new "add same config as before"
+edit "<a xmlns=\"urn:example:clixon\"><e><name>x1</name><type>ext</type><extra>y</extra><max>10</max><value>5</value></e><e><name>x2</name><max>10</max><value>9</value></e></a><b xmlns=\"urn:example:clixon\"><max>1</max><value>1</value></b>"
+
+new "validate fails with changed must"
+validate "<error-message>Value must be less than max</error-message>"
+
+new "fix second use"
+edit "<b xmlns=\"urn:example:clixon\"><value>0</value></b>"
+
+new "validate fails with changed when"
+validate "<error-message>Failed WHEN condition of extra in module $APPNAME (WHEN xpath is ../type='ext2')</error-message>"
+
+new "make changed when true"
+edit "<a xmlns=\"urn:example:clixon\"><e><name>x1</name><type>ext2</type></e></a>"
+
+new "validate ok"
+validate "$OK"
+
+new "discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "$OK"
+
+testrun_stop
+
+rm -rf $dir
+
+new "endtest"
+endtest
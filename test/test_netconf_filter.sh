@@ -1,6 +1,8 @@
 #!/usr/bin/env bash
 # Test netconf filter, subtree and xpath
 # Note subtree namespaces not implemented
+# Subtree filters are translated to an xpath in the backend, use main example -- -p <file>
+# option: provider on /ex:pstate logs its xpath to <file>
 
 # Magic line must be first in script (see README.md)
 s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
@@ -9,12 +11,14 @@ APPNAME=example
 
 cfg=$dir/conf_yang.xml
 fyang=$dir/filter.yang
+fstate=$dir/$APPNAME.yang
+flog=$dir/pstate.log
 
 cat <<EOF > $cfg
 <clixon-config xmlns="http://clicon.org/config">
   <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
   <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
-  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_YANG_MAIN_DIR>$dir</CLICON_YANG_MAIN_DIR>
   <CLICON_CLISPEC_DIR>/usr/local/lib/$APPNAME/clispec</CLICON_CLISPEC_DIR>
   <CLICON_CLI_DIR>/usr/local/lib/$APPNAME/cli</CLICON_CLI_DIR>
   <CLICON_CLI_MODE>$APPNAME</CLICON_CLI_MODE>
@@ -44,7 +48,20 @@ module filter{
 }
 EOF
 
-new "test params: -f $cfg"
+cat <<EOF > $fstate
+module $APPNAME{
+  namespace "urn:example:clixon";
+  prefix ex;
+  container pstate {
+    config false;
+    leaf calls {
+      type uint32;
+    }
+  }
+}
+EOF
+
+new "test params: -f $cfg -- -p $flog"
 
 if [ $BE -ne 0 ]; then
     new "kill old backend"
@@ -52,13 +69,28 @@ if [ $BE -ne 0 ]; then
     if [ $? -ne 0 ]; then
         err
     fi
-    new "start backend -s init -f $cfg"
-    start_backend -s init -f $cfg
+    new "start backend -s init -f $cfg -- -p $flog"
+    start_backend -s init -f $cfg -- -p $flog
 fi
 
 new "wait backend"
 wait_backend
 
+rm -f $flog
+new "get subtree disjoint from state provider"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type='subtree'><x xmlns='urn:example:filter'/></filter></get></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+new "provider not called"
+if [ -f $flog ]; then
+    err "no $flog" "$(cat $flog)"
+fi
+
+new "get subtree selection in state provider"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type='subtree'><pstate xmlns='urn:example:clixon'><calls/></pstate></filter></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>1</calls></pstate></data></rpc-reply>"
+
+new "backend received narrowed xpath"
+expectpart "$(cat $flog)" 0 "^/ex:pstate/ex:calls$"
+
 new "Add two entries"
 expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:filter\"><y><a>1</a><b>1</b></y><y><a>2</a><b>2</b></y></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
 
@@ -94,6 +126,12 @@ expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS>
 new "get subtree one"
 expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type='subtree'><x xmlns='urn:example:filter'><y><a>1</a></y></x></filter></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:filter\"><y><a>1</a><b>1</b></y></x></data></rpc-reply>"
 
+new "get-config subtree content match and selection"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type='subtree'><x xmlns='urn:example:filter'><y><a>2</a><b/></y></x></filter></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:filter\"><y><a>2</a><b>2</b></y></x></data></rpc-reply>"
+
+new "get subtree selection only"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type='subtree'><x xmlns='urn:example:filter'><y><b/></y></x></filter></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:filter\"><y><b>1</b></y><y><b>2</b></y></x></data></rpc-reply>"
+
 new "get-config xpath one"
 expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type='xpath' select=\"/fi:x/fi:y[fi:a='1']\" xmlns:fi='urn:example:filter' /></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:filter\"><y><a>1</a><b>1</b></y></x></data></rpc-reply>"
 
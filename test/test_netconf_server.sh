@@ -0,0 +1,102 @@
+#!/usr/bin/env bash
+# Netconf server mode: one long-lived netconf process serving sessions on a UNIX socket
+# Each session is relayed with socat, as an ssh netconf subsystem would do
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Skip it if no socat
+if [ -z "$(type socat 2> /dev/null)" ]; then
+    echo "...socat not installed"
+    rm -rf $dir
+    if [ "$s" = $0 ]; then exit 0; else return 0; fi # skip
+fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/server.yang
+nsock=$dir/netconf.sock
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_NETCONF_SERVER_SOCK>$nsock</CLICON_NETCONF_SERVER_SOCK>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module server{
+  yang-version 1.1;
+  namespace "urn:example:server";
+  prefix sr;
+  container x{
+     leaf-list y {
+        type string;
+     }
+  }
+}
+EOF
+
+# Relay one netconf session to the netconf server
+relay="sudo socat -t 2 - UNIX-CONNECT:$nsock"
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "start netconf server"
+$clixon_netconf -S -q -f $cfg -D $DBG &
+nspid=$!
+
+sleep $DEMSLEEP
+
+new "Check netconf server socket"
+if [ ! -S $nsock ]; then
+    err "$nsock" "No netconf server socket"
+fi
+
+new "First session: edit-config"
+expecteof_netconf "$relay" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:server\"><y>a</y></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "Second session: commit"
+expecteof_netconf "$relay" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "Third session: get-config"
+expecteof_netconf "$relay" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:server\"><y>a</y></x></data></rpc-reply>"
+
+new "stop netconf server"
+kill $nspid
+wait $nspid 2> /dev/null
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
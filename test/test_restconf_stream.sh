@@ -0,0 +1,146 @@
+#!/usr/bin/env bash
+# Restconf streamed GET replies using HTTP/1.1 chunked transfer-encoding
+# Test of CLICON_RESTCONF_STREAM_THRESHOLD
+# Large replies are chunked, small replies are sent with Content-Length
+# If both HTTP/1 and /2, force to /1 since http/2 replies are always buffered
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Only works with native http/1
+if [ "${WITH_RESTCONF}" != "native" -o ${HAVE_HTTP1} = false ]; then
+    echo "...skipped: Must run with native http/1"
+    rm -rf $dir
+    if [ "$s" = $0 ]; then exit 0; else return 0; fi # skip
+fi
+
+APPNAME=example
+
+if [ ${HAVE_LIBNGHTTP2} = true ]; then
+    # Pin to http/1
+    HAVE_LIBNGHTTP2=false
+    CURLOPTS=${CURLOPTS/http2/http1.1}
+    HVER=1.1
+fi
+
+cfg=$dir/conf.xml
+fyang=$dir/restconf.yang
+fjson=$dir/large.json
+
+# Number of list entries
+: ${nr:=1000}
+
+# Define default restconfig config: RESTCONFIG
+RESTCONFIG=$(restconf_config none false)
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_FEATURE>clixon-restconf:allow-auth-none</CLICON_FEATURE> <!-- Use auth-type=none -->
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>/usr/local/share/clixon</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>$dir/restconf.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_RESTCONF_STREAM_THRESHOLD>1024</CLICON_RESTCONF_STREAM_THRESHOLD>
+  $RESTCONFIG
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container table{
+      list parameter{
+         key name;
+         leaf name{
+            type string;
+         }
+         leaf value{
+            type string;
+         }
+      }
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    sudo pkill -f clixon_backend # to be sure
+
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+if [ $RC -ne 0 ]; then
+    new "kill old restconf daemon"
+    stop_restconf_pre
+
+    new "start restconf daemon"
+    start_restconf -f $cfg
+fi
+
+new "wait restconf"
+wait_restconf
+
+new "generate large config"
+echo -n '{"example:table":{"parameter":[' > $fjson
+for (( i=0; i<$nr; i++ )); do
+    if [ $i -ne 0 ]; then
+        echo -n "," >> $fjson
+    fi
+    echo -n "{\"name\":\"A$i\",\"value\":\"$i\"}" >> $fjson
+done
+echo -n "]}}" >> $fjson
+
+new "restconf POST large config"
+expectpart "$(curl $CURLOPTS -X POST -H "Content-Type: application/yang-data+json" -d @$fjson $RCPROTO://localhost/restconf/data)" 0 "HTTP/$HVER 201"
+
+new "restconf GET small entry, not streamed"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/example:table/parameter=A1)" 0 "HTTP/$HVER 200" "Content-Length:" '{"example:parameter":\[{"name":"A1","value":"1"}\]}' --not-- "Transfer-Encoding: chunked"
+
+new "restconf GET large json list, streamed"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/example:table)" 0 "HTTP/$HVER 200" "Transfer-Encoding: chunked" '{"name":"A0","value":"0"},{"name":"A1","value":"1"}' "{\"name\":\"A$((nr-1))\",\"value\":\"$((nr-1))\"}\]}}" --not-- "Content-Length:"
+
+new "restconf GET large xml list, streamed"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml" $RCPROTO://localhost/restconf/data/example:table)" 0 "HTTP/$HVER 200" "Transfer-Encoding: chunked" "<parameter><name>A0</name><value>0</value></parameter>" "<parameter><name>A$((nr-1))</name><value>$((nr-1))</value></parameter></table>"
+
+new "restconf GET datastore root, streamed"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data)" 0 "HTTP/$HVER 200" "Transfer-Encoding: chunked" '{"ietf-restconf:data":{"example:table":{"parameter":\[{"name":"A0","value":"0"}'
+
+new "restconf HEAD large list, not streamed"
+expectpart "$(curl $CURLOPTS --head $RCPROTO://localhost/restconf/data/example:table)" 0 "HTTP/$HVER 200" "Content-Length:" --not-- "Transfer-Encoding: chunked"
+
+if [ $RC -ne 0 ]; then
+    new "Kill restconf daemon"
+    stop_restconf
+fi
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+unset nr
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -6,12 +6,15 @@
 #   - not a key int
 #   - key in an ordered-by user
 #   - key in state data
-# Use instance-id for tests, since api-path can only handle keys, and xpath is too complex.
+# Use instance-id for tests, since api-path can only handle keys.
+# Also test xpath with a single index variable predicate: [i='v']
+# Last, check the xpath-index-hits counter of the stats rpc in the backend
 
 # Magic line must be first in script (see README.md)
 s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
 
 : ${clixon_util_path:=clixon_util_path -D $DBG -Y /usr/local/share/clixon}
+: ${clixon_util_xpath:=clixon_util_xpath -D $DBG -Y /usr/local/share/clixon}
 
 # Number of list/leaf-list entries
 : ${nr:=10000}
@@ -81,6 +84,17 @@ for (( ii=0; ii<10; ii++ )); do
     expectpart "$($clixon_util_path -f $xml1 -y $ydir -p /a:x1/a:y[a:i=\"$rndi\"])" 0 "^0: <y><k1>a$rnd</k1><z>foo$rnd</z><i>$rndi</i><j>$rndi</j></y>$"
 done
 
+# XPath predicate on single index variable uses search index
+for (( ii=0; ii<3; ii++ )); do
+    rnd=$(( ( RANDOM % $nr ) ))
+    rndi=$(( $nr - $rnd - 1 ))
+    new "xpath single string key i=$rndi (rnd:$rnd)"
+    expectpart "$($clixon_util_xpath -f $xml1 -y $ydir -n a:urn:example:a -p "/a:x1/a:y[a:i='$rndi']")" 0 "^nodeset:0:<y><k1>a$rnd</k1><z>foo$rnd</z><i>$rndi</i><j>$rndi</j></y>$"
+done
+
+new "xpath index variable no match"
+expectpart "$($clixon_util_xpath -f $xml1 -y $ydir -n a:urn:example:a -p "/a:x1/a:y[a:i='$nr']")" 0 "^nodeset:$"
+
 # Then measure time for index and non-index, assume correct
 # For small nr, the time to parse is so much larger than searching (and also parsing involves
 # searching) which makes it hard to make a  test comparing accessing the index variable "i" and the
@@ -91,6 +105,82 @@ new "index search latency i=$rndi"
 new "non-index search latency j=$rndi"
 { time -p $clixon_util_path -f $xml1 -y $ydir -p /a:x1/a:y[a:j=\"$rndi\"] > /dev/null; }  2>&1 | awk '/real/ {print $2}'
 
+# Then check in the backend that xpath filters on the index variable use the index
+APPNAME=example
+cfg=$dir/conf_yang.xml
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$ydir</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$ydir/moda.yang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+# Get and reset number of xpath index lookups from stats rpc
+function index_hits()
+{
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><stats $LIBNS/></rpc>")
+    res=$(echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qf $cfg)
+    echo "$res" | $clixon_util_xpath -p "/rpc-reply/global/xpath-index-hits" | awk -F ">" '{print $2}' | awk -F "<" '{print $1}'
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "netconf add list with index"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x1 xmlns=\"urn:example:a\"><y><k1>a0</k1><i>2</i><j>2</j></y><y><k1>a1</k1><i>1</i><j>1</j></y><y><k1>a2</k1><i>0</i><j>0</j></y></x1></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "reset index stats"
+hits=$(index_hits)
+
+new "netconf get-config non-index variable j"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/a:x1/a:y[a:j='1']\" xmlns:a=\"urn:example:a\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x1 xmlns=\"urn:example:a\"><y><k1>a1</k1><i>1</i><j>1</j></y></x1></data></rpc-reply>"
+
+new "non-index variable does not use index"
+hits=$(index_hits)
+if [ "$hits" != "0" ]; then
+    err "0" "$hits"
+fi
+
+new "netconf get-config index variable i"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/a:x1/a:y[a:i='1']\" xmlns:a=\"urn:example:a\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x1 xmlns=\"urn:example:a\"><y><k1>a1</k1><i>1</i><j>1</j></y></x1></data></rpc-reply>"
+
+new "index variable uses index"
+hits=$(index_hits)
+if [ -z "$hits" ] || [ "$hits" -lt 1 ]; then
+    err ">= 1" "$hits"
+fi
+
+new "netconf discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
 rm -rf $dir
 
 new "endtest"
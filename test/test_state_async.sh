@@ -0,0 +1,164 @@
+#!/usr/bin/env bash
+# Asynchronous state data providers, see clixon_statedata_async_register
+# Use main example -- -A <ms> option: asynchronous provider on /ex:astate done after <ms>
+# Check normal completion, timeout with CLICON_BACKEND_STATE_TIMEOUT, session closed while
+# the reply is deferred, and provider failure with -- -A <ms> -F
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/$APPNAME.yang
+
+# Create config file
+# Args:
+# 1: CLICON_BACKEND_STATE_TIMEOUT in ms
+function create_config()
+{
+    timeout=$1
+
+    cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_DIR>/usr/local/lib/$APPNAME/backend</CLICON_BACKEND_DIR>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_YANG_LIBRARY>false</CLICON_YANG_LIBRARY>
+  <CLICON_NETCONF_MONITORING>false</CLICON_NETCONF_MONITORING>
+  <CLICON_BACKEND_STATE_TIMEOUT>$timeout</CLICON_BACKEND_STATE_TIMEOUT>
+</clixon-config>
+EOF
+}
+
+cat <<EOF > $fyang
+module $APPNAME {
+  namespace "urn:example:clixon";
+  prefix ex;
+  container c {
+    leaf v {
+      type string;
+    }
+  }
+  container astate {
+    config false;
+    leaf value {
+      type uint32;
+    }
+  }
+}
+EOF
+
+# Start backend
+# Args:
+# 1: Options to example backend plugin
+function testrun_start()
+{
+    opts=$1
+
+    new "test params: -f $cfg -- $opts"
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -z -f $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend -s init -f $cfg -- $opts"
+        start_backend -s init -f $cfg -- $opts
+    fi
+
+    new "wait backend"
+    wait_backend
+}
+
+function testrun_stop()
+{
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+# 1. Normal completion
+create_config 10000
+testrun_start "-A 500"
+
+new "get async provider path"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:astate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><astate xmlns=\"urn:example:clixon\"><value>42</value></astate></data></rpc-reply>"
+
+new "edit-config"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:clixon\"><v>x</v></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "get whole tree includes async state"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get/></rpc>" "" "<rpc-reply $DEFAULTNS><data><astate xmlns=\"urn:example:clixon\"><value>42</value></astate></data></rpc-reply>"
+
+new "get-config does not wait for async provider"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:clixon\"><v>x</v></c></data></rpc-reply>"
+
+testrun_stop
+
+# 2. Timeout, and other sessions served meanwhile
+create_config 1000
+testrun_start "-A 3000"
+
+new "start get in background"
+rpc=$(chunked_framing "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:astate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>")
+echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qf $cfg > $dir/get.xml &
+getpid=$!
+
+new "other session served while get waits"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+new "wait for background get"
+wait $getpid
+
+new "get replied with partial state on timeout"
+expectpart "$(cat $dir/get.xml)" 0 "<rpc-reply $DEFAULTNS><data/></rpc-reply>" --not-- "<astate"
+
+new "get times out before provider is done"
+expectpart "$({ time -p echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qf $cfg > /dev/null; } 2>&1 | awk '/real/ {print int($2)}')" 0 "^[0-2]$"
+
+# 3. Session closed while reply is deferred
+new "close session while get waits"
+echo "$DEFAULTHELLO$rpc" | timeout 0.5 $clixon_netconf -qf $cfg
+
+new "wait for provider to be done"
+sleep 4
+
+new "backend still alive"
+pid=$(pgrep -u root -f clixon_backend)
+if [ -z "$pid" ]; then
+    err "backend alive" "backend dead"
+fi
+
+new "get after closed session"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+testrun_stop
+
+# 4. Provider failure
+create_config 10000
+testrun_start "-A 100 -F"
+
+new "get with failing async provider"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:astate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>operation-failed</error-tag><error-severity>error</error-severity><error-message>Asynchronous state data provider /ex:astate failed</error-message></rpc-error></rpc-reply>"
+
+new "get disjoint path does not call failing provider"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:c\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+testrun_stop
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,148 @@
+#!/usr/bin/env bash
+# Backend state cache of a state data provider with max-age, see clixon_statedata_cache_set
+# Use main example -- -p <file> -c <ms> options: provider on /ex:pstate with a state cache
+# which is invalidated on commit
+# Check cache hit, miss, max-age expiry and explicit invalidation with stats counters
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/$APPNAME.yang
+flog=$dir/pstate.log
+
+# Max-age of cache in ms
+maxage=2000
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_DIR>/usr/local/lib/$APPNAME/backend</CLICON_BACKEND_DIR>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_YANG_LIBRARY>false</CLICON_YANG_LIBRARY>
+  <CLICON_NETCONF_MONITORING>false</CLICON_NETCONF_MONITORING>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module $APPNAME {
+  namespace "urn:example:clixon";
+  prefix ex;
+  container c {
+    leaf v {
+      type string;
+    }
+  }
+  container pstate {
+    config false;
+    leaf calls {
+      type uint32;
+    }
+  }
+  container other {
+    config false;
+    leaf x {
+      type string;
+    }
+  }
+}
+EOF
+
+# Check state cache stats of /ex:pstate provider
+# Args:
+# 1: hits
+# 2: misses
+function check_stats()
+{
+    hits=$1
+    misses=$2
+
+    new "stats hits:$hits misses:$misses"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><stats $LIBNS/></rpc>" "" "<state-cache xmlns=\"http://clicon.org/lib\"><provider><path>/ex:pstate</path><max-age>$maxage</max-age><hits>$hits</hits><misses>$misses</misses>"
+}
+
+new "test params: -f $cfg -- -p $flog -c $maxage"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg -- -p $flog -c $maxage"
+    start_backend -s init -f $cfg -- -p $flog -c $maxage
+fi
+
+new "wait backend"
+wait_backend
+
+check_stats 0 0
+
+rm -f $flog
+new "get narrower path, cache miss"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:pstate/ex:calls\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>1</calls></pstate></data></rpc-reply>"
+
+new "caching provider is called with its own path"
+expectpart "$(cat $flog)" 0 "^/ex:pstate$"
+
+rm -f $flog
+new "get provider path, cache hit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:pstate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>1</calls></pstate></data></rpc-reply>"
+
+new "get whole tree, cache hit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get/></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>1</calls></pstate></data></rpc-reply>"
+
+new "provider not called on hits"
+if [ -f $flog ]; then
+    err "no $flog" "$(cat $flog)"
+fi
+
+new "get disjoint path, cache not used"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:other\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+check_stats 2 1
+
+new "wait for max-age to expire"
+sleep $(( $maxage/1000 + 1 ))
+
+new "get after max-age, cache miss"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:pstate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>2</calls></pstate></data></rpc-reply>"
+
+new "get again, cache hit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:pstate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>2</calls></pstate></data></rpc-reply>"
+
+check_stats 3 2
+
+new "edit-config"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:clixon\"><v>x</v></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "commit invalidates cache"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+check_stats 3 2
+
+new "get after invalidation, cache miss"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:pstate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>3</calls></pstate></data></rpc-reply>"
+
+check_stats 3 3
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,122 @@
+#!/usr/bin/env bash
+# State data provider registered on a schema path, see clixon_statedata_cb_register
+# Use main example -- -p <file> option: provider on /ex:pstate logs its xpath to <file>
+# Check that the provider is called on requests intersecting its path, with the narrower
+# path as xpath, and not called on disjoint requests
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/$APPNAME.yang
+flog=$dir/pstate.log
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_DIR>/usr/local/lib/$APPNAME/backend</CLICON_BACKEND_DIR>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_YANG_LIBRARY>false</CLICON_YANG_LIBRARY>
+  <CLICON_NETCONF_MONITORING>false</CLICON_NETCONF_MONITORING>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module $APPNAME {
+  namespace "urn:example:clixon";
+  prefix ex;
+  container pstate {
+    config false;
+    leaf calls {
+      type uint32;
+    }
+  }
+  container other {
+    config false;
+    leaf x {
+      type string;
+    }
+  }
+}
+EOF
+
+new "test params: -f $cfg -- -p $flog"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg -- -p $flog"
+    start_backend -s init -f $cfg -- -p $flog
+fi
+
+new "wait backend"
+wait_backend
+
+rm -f $flog
+new "get disjoint path, provider not called"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:other\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+new "provider not called"
+if [ -f $flog ]; then
+    err "no $flog" "$(cat $flog)"
+fi
+
+new "get whole tree, provider called with its path"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get/></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>1</calls></pstate></data></rpc-reply>"
+
+new "provider xpath is its path"
+expectpart "$(cat $flog)" 0 "^/ex:pstate$"
+
+rm -f $flog
+new "get provider path"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:pstate\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>2</calls></pstate></data></rpc-reply>"
+
+new "provider xpath is its path"
+expectpart "$(cat $flog)" 0 "^/ex:pstate$"
+
+rm -f $flog
+new "get narrower path within provider path"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/ex:pstate/ex:calls\" xmlns:ex=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>3</calls></pstate></data></rpc-reply>"
+
+new "provider xpath is narrowed to request"
+expectpart "$(cat $flog)" 0 "^/ex:pstate/ex:calls$"
+
+rm -f $flog
+new "get with other prefix, narrowed xpath uses canonical prefix"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get><filter type=\"xpath\" select=\"/p:pstate/p:calls\" xmlns:p=\"urn:example:clixon\"/></get></rpc>" "" "<rpc-reply $DEFAULTNS><data><pstate xmlns=\"urn:example:clixon\"><calls>4</calls></pstate></data></rpc-reply>"
+
+new "provider xpath is canonical"
+expectpart "$(cat $flog)" 0 "^/ex:pstate/ex:calls$"
+
+rm -f $flog
+new "get-config does not call provider"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+new "provider not called"
+if [ -f $flog ]; then
+    err "no $flog" "$(cat $flog)"
+fi
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
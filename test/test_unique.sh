@@ -5,7 +5,8 @@
 # The test adds the rfc conf that fails, then one that passes, then makes add
 # to fail it and then del to pass it.
 # Then makes a fail / pass test on the single field case
-# Last, a complex unsorted list with several sub-elements.
+# Then a complex unsorted list with several sub-elements.
+# Last, a large list with a duplicate added last, and check unique stats counters
 
 # Magic line must be first in script (see README.md)
 s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
@@ -207,6 +208,37 @@ expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS>
 new "netconf discard-changes"
 expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
 
+# Large list: many entries with unique ip/port, then add a duplicate of an early entry last
+new "generate large list with unique ip/port"
+nr=1000
+conf="<c xmlns=\"urn:example:clixon\">"
+for (( i=0; i<$nr; i++ )); do
+    conf+="<server><name>s$i</name><ip>10.0.$((i/256)).$((i%256))</ip><port>$i</port></server>"
+done
+
+new "Add large valid list"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><default-operation>replace</default-operation><config>$conf</c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf validate large list ok"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "make large list invalid by adding a duplicate of first entry"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:clixon\"><server><name>zzz</name><ip>10.0.0.0</ip><port>0</port></server></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf validate large list (should fail)"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>operation-failed</error-tag><error-app-tag>data-not-unique</error-app-tag><error-severity>error</error-severity><error-info><non-unique xmlns=\"urn:ietf:params:xml:ns:yang:1\">/c/server[name=\"zzz\"]/ip</non-unique><non-unique xmlns=\"urn:ietf:params:xml:ns:yang:1\">/c/server[name=\"zzz\"]/port</non-unique></error-info></rpc-error></rpc-reply>"
+
+new "netconf stats unique counters"
+rpc=$(chunked_framing "<rpc $DEFAULTNS><stats $LIBNS/></rpc>")
+res=$(echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qf $cfg)
+uniquenr=$(echo "$res" | $clixon_util_xpath -p "/rpc-reply/global/uniquenr" | awk -F ">" '{print $2}' | awk -F "<" '{print $1}')
+if [ -z "$uniquenr" ] || [ "$uniquenr" -lt $nr ]; then
+    err "uniquenr >= $nr" "$uniquenr"
+fi
+
+new "netconf discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
 if [ $BE -ne 0 ]; then
     new "Kill backend"
     # Check if premature kill
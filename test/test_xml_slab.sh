@@ -0,0 +1,172 @@
+#!/usr/bin/env bash
+# XML nodes allocated from slabs, see XML_NODE_SLAB in include/clixon_custom.h
+# Build and free a list spanning several slabs repeatedly in the backend:
+#   - add, commit and read back all entries
+#   - delete every other entry and re-add it with new values, so that freed nodes
+#     in the middle of slabs are reused
+#   - remove all entries and commit
+# Check the data after each step and that the number of XML nodes is the same after
+# each cycle, using the stats rpc
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+# Number of list entries, each entry is three element and two body nodes
+: ${perfnr:=1000}
+
+# Number of add/remove cycles
+: ${cycles:=3}
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/slab.yang
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module slab{
+  yang-version 1.1;
+  namespace "urn:example:clixon";
+  prefix ex;
+  container x{
+    list y{
+      key a;
+      leaf a{
+        type int32;
+      }
+      leaf b{
+        type string;
+      }
+    }
+  }
+}
+EOF
+
+# Get number of XML nodes in the backend from the stats rpc
+function xmlnr()
+{
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><stats $LIBNS/></rpc>")
+    echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qf $cfg | sed -n 's/.*<xmlnr>\([0-9]*\)<\/xmlnr>.*/\1/p'
+}
+
+# Edit candidate and commit
+# Args:
+# 1: config
+function edit_commit()
+{
+    new "edit-config"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config>$1</config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "commit"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+}
+
+# Check value of b of entry in running
+# Args:
+# 1: key
+# 2: value of b
+function check_entry()
+{
+    new "get entry $1"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a='$1']\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>$1</a><b>$2</b></y></x></data></rpc-reply>"
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+# All entries with values v<i>
+all="<x xmlns=\"urn:example:clixon\">"
+for (( i=0; i<$perfnr; i++ )); do
+    all+="<y><a>$i</a><b>v$i</b></y>"
+done
+all+="</x>"
+
+# Delete every other entry
+del="<x xmlns=\"urn:example:clixon\" xmlns:nc=\"${BASENS}\">"
+for (( i=0; i<$perfnr; i+=2 )); do
+    del+="<y nc:operation=\"delete\"><a>$i</a></y>"
+done
+del+="</x>"
+
+# Re-add every other entry with values w<i>
+readd="<x xmlns=\"urn:example:clixon\">"
+for (( i=0; i<$perfnr; i+=2 )); do
+    readd+="<y><a>$i</a><b>w$i</b></y>"
+done
+readd+="</x>"
+
+last=$((perfnr-1))
+nr0=""
+for (( c=1; c<=$cycles; c++ )); do
+    new "cycle $c: add $perfnr entries"
+    edit_commit "$all"
+    check_entry 0 v0
+    check_entry $last v$last
+
+    new "cycle $c: delete every other entry"
+    edit_commit "$del"
+    check_entry 1 v1
+
+    new "cycle $c: get deleted entry"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a='0']\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+    new "cycle $c: re-add deleted entries"
+    edit_commit "$readd"
+    check_entry 0 w0
+    check_entry 1 v1
+    check_entry $((perfnr-2)) w$((perfnr-2))
+
+    new "cycle $c: remove all entries"
+    edit_commit "<x xmlns=\"urn:example:clixon\" xmlns:nc=\"${BASENS}\" nc:operation=\"remove\"/>"
+
+    new "cycle $c: get empty"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data/></rpc-reply>"
+
+    nr=$(xmlnr)
+    new "cycle $c: xml nodes $nr"
+    if [ -z "$nr" ]; then
+        err "xmlnr" "$nr"
+    fi
+    if [ -z "$nr0" ]; then
+        nr0=$nr
+    elif [ "$nr" -ne "$nr0" ]; then
+        err "xmlnr $nr0" "$nr"
+    fi
+done
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
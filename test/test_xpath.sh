@@ -461,6 +461,94 @@ EOF
 new "given value show value"
 expectpart "$($clixon_util_xpath -D $DBG -f $dir/1.xml -n ex:urn:example:clixon -y $fyang < $dir/1.xpath)" 0 "<value>42</value>"
 
+# PART 4
+# Multiple keys in any order, several predicates and and-expressions
+cat <<EOF > $fyang
+module clixon-example {
+    yang-version 1.1;
+    namespace "urn:example:clixon";
+    prefix ex;
+    container table{
+        list parameter{
+            key "k1 k2";
+            leaf k1{
+                type string;
+            }
+            leaf k2{
+                type string;
+            }
+            leaf value{
+                type string;
+            }
+        }
+    }
+}
+EOF
+
+cat <<EOF > $dir/2.xml
+<table xmlns="urn:example:clixon">
+   <parameter><k1>a</k1><k2>x</k2><value>1</value></parameter>
+   <parameter><k1>a</k1><k2>y</k2><value>2</value></parameter>
+   <parameter><k1>b</k1><k2>x</k2><value>3</value></parameter>
+   <parameter><k1>b</k1><k2>y</k2><value>4</value></parameter>
+</table>
+EOF
+
+new "two keys in key order"
+expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon -y $fyang -p "/ex:table/ex:parameter[ex:k1='b'][ex:k2='x']/ex:value")" 0 "^nodeset:0:<value>3</value>$"
+
+new "two keys reverse order"
+expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon -y $fyang -p "/ex:table/ex:parameter[ex:k2='y'][ex:k1='a']/ex:value")" 0 "^nodeset:0:<value>2</value>$"
+
+new "two keys and-expression"
+expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon -y $fyang -p "/ex:table/ex:parameter[ex:k2='y' and ex:k1='b']/ex:value")" 0 "^nodeset:0:<value>4</value>$"
+
+new "first key only"
+expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon -y $fyang -p "/ex:table/ex:parameter[ex:k1='a']/ex:value")" 0 "^nodeset:0:<value>1</value>1:<value>2</value>$"
+
+new "second key only"
+expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon -y $fyang -p "/ex:table/ex:parameter[ex:k2='x']/ex:value")" 0 "^nodeset:0:<value>1</value>1:<value>3</value>$"
+
+new "or-expression"
+expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon -y $fyang -p "/ex:table/ex:parameter[ex:k1='a' or ex:k2='x']/ex:value")" 0 "^nodeset:0:<value>1</value>1:<value>2</value>2:<value>3</value>$"
+
+new "two keys no match"
+expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon -y $fyang -p "/ex:table/ex:parameter[ex:k1='a' and ex:k2='z']")" 0 "^nodeset:$"
+
+# xpath_first stops at first match, the -i initial node is selected with xpath_first
+# Run with yang (key lookups) and without yang (search in document order)
+for y in "-y $fyang" ""; do
+    new "xpath_first several matches $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter" -p "ex:value")" 0 "^nodeset:0:<value>1</value>$"
+
+    new "xpath_first several matches of last step $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter/ex:value" -p ".")" 0 "^nodeset:0:<value>1</value>$"
+
+    new "xpath_first first key several matches $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:k1='b']" -p "ex:value")" 0 "^nodeset:0:<value>3</value>$"
+
+    new "xpath_first second key several matches $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:k2='y']" -p "ex:value")" 0 "^nodeset:0:<value>2</value>$"
+
+    new "xpath_first two keys reverse order $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:k2='x'][ex:k1='b']" -p "ex:value")" 0 "^nodeset:0:<value>3</value>$"
+
+    new "xpath_first and-expression $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:k2='y' and ex:k1='b']" -p "ex:value")" 0 "^nodeset:0:<value>4</value>$"
+
+    new "xpath_first non-key predicate $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:value='3']" -p "ex:k2")" 0 "^nodeset:0:<k2>x</k2>$"
+
+    new "xpath_first key and non-key predicates $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:k1='a'][ex:value='2']" -p "ex:k2")" 0 "^nodeset:0:<k2>y</k2>$"
+
+    new "xpath_first or-expression $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:k1='b' or ex:k2='y']" -p "ex:value")" 0 "^nodeset:0:<value>2</value>$"
+
+    new "xpath_first predicate followed by step $y"
+    expectpart "$($clixon_util_xpath -D $DBG -f $dir/2.xml -n ex:urn:example:clixon $y -i "/ex:table/ex:parameter[ex:k2='x']/ex:value" -p ".")" 0 "^nodeset:0:<value>1</value>$"
+done
+
 rm -rf $dir
 
 new "endtest"
@@ -0,0 +1,215 @@
+#!/usr/bin/env bash
+# Find imported and included yang files in CLICON_YANG_DIR:s using the yang file index
+# The dirs are indexed once per loaded module set, check that lookups give the same files
+# as scanning the dirs:
+#   - CLICON_YANG_DIR is searched recursively
+#   - Import without revision gives the most recent revision
+#   - Import with revision-date gives that revision
+#   - The first CLICON_YANG_DIR with a matching file is used
+#   - Files with non-date revisions, also of the form XXXX-XX-XX, do not match import
+#     without revision
+#   - Submodules are found
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/$APPNAME.yang
+ydir1=$dir/y1
+ydir2=$dir/y2
+
+mkdir -p $ydir1/sub/deep
+mkdir -p $ydir2
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$ydir1</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$ydir2</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+# Old revision in top of first dir
+cat <<EOF > $ydir1/imp@2019-01-01.yang
+module imp{
+  prefix imp;
+  namespace "urn:example:imp";
+  revision 2019-01-01;
+  leaf old{
+    type string;
+  }
+}
+EOF
+
+# New revision in a subdir of first dir
+cat <<EOF > $ydir1/sub/deep/imp@2020-01-01.yang
+module imp{
+  prefix imp;
+  namespace "urn:example:imp";
+  revision 2020-01-01;
+  leaf new{
+    type string;
+  }
+}
+EOF
+
+# Not a revision date, does not match import without revision
+cat <<EOF > $ydir1/imp@latest.yang
+module imp{
+  prefix imp;
+  namespace "urn:example:imp";
+  leaf latest{
+    type string;
+  }
+}
+EOF
+
+# Same form as a revision date but not digits, does not match import without revision
+cat <<EOF > $ydir1/imp@abcd-ef-gh.yang
+module imp{
+  prefix imp;
+  namespace "urn:example:imp";
+  leaf notdate{
+    type string;
+  }
+}
+EOF
+
+# Most recent revision but in second dir
+cat <<EOF > $ydir2/imp@2021-01-01.yang
+module imp{
+  prefix imp;
+  namespace "urn:example:imp";
+  revision 2021-01-01;
+  leaf later{
+    type string;
+  }
+}
+EOF
+
+cat <<EOF > $ydir1/sub/example-sub.yang
+submodule example-sub{
+  belongs-to example {
+    prefix ex;
+  }
+  leaf subleaf{
+    type string;
+  }
+}
+EOF
+
+# Start backend with main module importing imp
+# Args:
+# 1: import revision-date statement or empty
+function testrun_start()
+{
+    revstmt=$1
+
+    cat <<EOF > $fyang
+module $APPNAME{
+  prefix ex;
+  namespace "urn:example:clixon";
+  import imp {
+    prefix imp;
+    $revstmt
+  }
+  include example-sub;
+}
+EOF
+    new "test params: -f $cfg import $revstmt"
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -zf $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend  -s init -f $cfg"
+        start_backend -s init -f $cfg
+    fi
+
+    new "wait backend"
+    wait_backend
+}
+
+function testrun_stop()
+{
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+# Set a leaf in the imp module
+# Args:
+# 1: leaf name
+# 2: expected reply
+function set_imp()
+{
+    leaf=$1
+    reply=$2
+
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><$leaf xmlns=\"urn:example:imp\">str</$leaf></config></edit-config></rpc>" "" "$reply"
+}
+
+new "1. Import without revision"
+testrun_start ""
+
+new "Set new from most recent revision in first dir subdir"
+set_imp new "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "Set old should fail"
+set_imp old "<bad-element>old</bad-element>"
+
+new "Set latest should fail"
+set_imp latest "<bad-element>latest</bad-element>"
+
+new "Set notdate should fail"
+set_imp notdate "<bad-element>notdate</bad-element>"
+
+new "Set later in second dir should fail"
+set_imp later "<bad-element>later</bad-element>"
+
+new "Set subleaf from submodule in subdir"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><subleaf xmlns=\"urn:example:clixon\">str</subleaf></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+testrun_stop
+
+new "2. Import old revision"
+testrun_start "revision-date 2019-01-01;"
+
+new "Set old"
+set_imp old "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "Set new should fail"
+set_imp new "<bad-element>new</bad-element>"
+
+testrun_stop
+
+new "3. Import revision only in second dir"
+testrun_start "revision-date 2021-01-01;"
+
+new "Set later"
+set_imp later "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "Set new should fail"
+set_imp new "<bad-element>new</bad-element>"
+
+testrun_stop
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,153 @@
+#!/usr/bin/env bash
+# Load two revisions of the same module from CLICON_YANG_MAIN_DIR where the module name
+# differs from the filename, so that the oldest revision is removed from the yang spec.
+# Module lookups by name and namespace are cached in the yang spec, check that lookups
+# afterwards return the surviving module:
+#   - By namespace: edit-config of leafs in the module
+#   - By name: import and leafref path prefix in another module
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+ydir=$dir/main
+
+mkdir -p $ydir
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$ydir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_DIR>$ydir</CLICON_YANG_MAIN_DIR>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+# Revision in filename, loaded first
+cat <<EOF > $ydir/imp@2019-01-01.yang
+module imp{
+  prefix imp;
+  namespace "urn:example:imp";
+  revision 2019-01-01;
+  leaf r2019{
+    type string;
+  }
+}
+EOF
+
+# Create module name differing from filename, loaded last, and importing module
+# Args:
+# 1: revision year of other.yang
+# 2: revision year of surviving module, referenced by leafref
+function create_other()
+{
+    rev=$1
+    ref=$2
+
+    cat <<EOF > $ydir/other.yang
+module imp{
+  prefix imp;
+  namespace "urn:example:imp";
+  revision $rev-01-01;
+  leaf r$rev{
+    type string;
+  }
+}
+EOF
+    cat <<EOF > $ydir/main.yang
+module main{
+  prefix m;
+  namespace "urn:example:main";
+  import imp {
+    prefix imp;
+  }
+  leaf ref{
+    type leafref{
+      path "/imp:r$ref";
+    }
+  }
+}
+EOF
+}
+
+# Start backend
+# Args:
+# 1: revision year of other.yang
+# 2: revision year of surviving module
+function testrun_start()
+{
+    create_other $1 $2
+
+    new "test params: -f $cfg other revision $1"
+    if [ $BE -ne 0 ]; then
+        new "kill old backend"
+        sudo clixon_backend -zf $cfg
+        if [ $? -ne 0 ]; then
+            err
+        fi
+        new "start backend -s init -f $cfg"
+        start_backend -s init -f $cfg
+    fi
+
+    new "wait backend"
+    wait_backend
+}
+
+function testrun_stop()
+{
+    if [ $BE -ne 0 ]; then
+        new "Kill backend"
+        # Check if premature kill
+        pid=$(pgrep -u root -f clixon_backend)
+        if [ -z "$pid" ]; then
+            err "backend already dead"
+        fi
+        # kill backend
+        stop_backend -f $cfg
+    fi
+}
+
+# Check that only the leaf of the surviving revision exists
+# Args:
+# 1: revision year of surviving module
+# 2: revision year of removed module
+function check_survivor()
+{
+    rev=$1
+    old=$2
+
+    new "Set r$rev of surviving module"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><r$rev xmlns=\"urn:example:imp\">x</r$rev></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "Set r$old of removed module should fail"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><r$old xmlns=\"urn:example:imp\">x</r$old></config></edit-config></rpc>" "" "<bad-element>r$old</bad-element>"
+
+    new "Set leafref to surviving module"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><ref xmlns=\"urn:example:main\">x</ref></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "Validate leafref"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "Get surviving module"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"/imp:r$rev\" xmlns:imp=\"urn:example:imp\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><r$rev xmlns=\"urn:example:imp\">x</r$rev></data></rpc-reply>"
+}
+
+new "1. Newer revision loaded last, first loaded module is removed"
+testrun_start 2021 2021
+check_survivor 2021 2019
+testrun_stop
+
+new "2. Older revision loaded last, last loaded module is removed"
+testrun_start 2018 2019
+check_survivor 2019 2018
+testrun_stop
+
+rm -rf $dir
+
+new "endtest"
+endtest